@@ -0,0 +1,111 @@
+"""热点路径内存分配检测模块
+
+_check_heap_allocation只判断变量是否指向堆内存。本模块查找真正影响性能的分配点：
+- 直接调用malloc/calloc/realloc/free等分配释放函数的调用点
+- 调用了传递分配（或释放）内存的函数的调用点，附带到分配函数的最短调用链
+只报告位于循环中、或所在函数可从入口函数（entry_points）到达的调用点，
+按循环深度从深到浅排序，同一深度下热点路径上的调用点优先。
+"""
+
+from .hot_paths import HotPathIndex
+
+
+ALLOCATION_FUNCTIONS = ('malloc', 'calloc', 'realloc', 'aligned_alloc', 'valloc', 'pvalloc',
+                        'posix_memalign', 'strdup', 'strndup')
+FREE_FUNCTIONS = ('free',)
+
+
+def allocation_functions(options):
+    """分配函数名：标准分配函数加上配置项allocators列出的自定义分配函数（如内存池的pool_alloc）
+
+    不按名称子串猜测（renew_config、copy_count不是分配函数），各分析共用这一个判断。
+    """
+    return ALLOCATION_FUNCTIONS + tuple(name for name in options.get('allocators', ())
+                                        if name not in ALLOCATION_FUNCTIONS)
+
+
+class AllocationAnalyzer:
+    """循环中和热点路径上的内存分配检测"""
+
+    def __init__(self, analyzer, entry_points=None):
+        self.analyzer = analyzer
+        self.hot_paths = HotPathIndex(analyzer, entry_points)
+        self.call_graph = analyzer.call_graph
+
+    def analyze(self):
+        """返回分配检测报告
+        Returns:
+            {
+                'entry_points': 参与分析的入口函数,
+                'allocating_functions': {函数名: {'allocates': 调用链或None, 'frees': 调用链或None}},
+                'sites': 按循环深度排序的分配/释放调用点
+            }
+        """
+        # 传递分配/释放内存的函数：能经一次或多次调用到达分配/释放函数的函数
+        allocating = {}
+        for function in self.analyzer.functions:
+            chains = {
+                'allocates': self._chain(function, self.analyzer.allocation_functions),
+                'frees': self._chain(function, FREE_FUNCTIONS),
+            }
+            if chains['allocates'] or chains['frees']:
+                allocating[function] = chains
+
+        sites = []
+        for function in self.analyzer.functions:
+            entries = self.hot_paths.entries_reaching(function)
+            for callee, line, depth, indirect in self.hot_paths.call_sites(function):
+                kind = self._kind(callee)
+                via = None
+                if kind is None:
+                    chains = allocating.get(callee)
+                    if chains is None:
+                        continue
+                    kind = 'allocate' if chains['allocates'] else 'free'
+                    via = chains['allocates'] or chains['frees']
+                if not depth and not entries:
+                    continue
+                entry_chain = self.hot_paths.entry_chain(function) if entries else None
+                sites.append({
+                    'function': function,
+                    'line': line,
+                    'kind': kind,
+                    'callee': callee,
+                    'direct': via is None,
+                    'indirect_call': indirect,
+                    'loop_depth': depth,
+                    'via': via or [callee],
+                    'entry_points': entries,
+                    'call_chain': (entry_chain or [function]) + (via or [callee]),
+                })
+
+        sites.sort(key=lambda site: (-site['loop_depth'], -len(site['entry_points']), not site['direct'],
+                                     site['kind'] != 'allocate', site['function'], site['line']))
+        return {
+            'entry_points': self.hot_paths.entry_points,
+            'allocating_functions': allocating,
+            'sites': sites,
+        }
+
+    def _kind(self, callee):
+        if callee in self.analyzer.allocation_functions:
+            return 'allocate'
+        if callee in FREE_FUNCTIONS:
+            return 'free'
+        return None
+
+    def _chain(self, function, targets):
+        """函数到分配/释放函数的最短调用链（函数本身就是分配函数时返回None）"""
+        if function in targets:
+            return None
+        return self.call_graph.call_chain(function, targets)
+
+    @staticmethod
+    def summary(report, limit=10):
+        """排名靠前的分配点的文字摘要"""
+        lines = []
+        for site in report['sites'][:limit]:
+            where = f"loop depth {site['loop_depth']}" if site['loop_depth'] else 'hot path'
+            lines.append(f"{site['function']}:{site['line']} {site['callee']}() [{site['kind']}, {where}]: "
+                         f"{' -> '.join(site['call_chain'])}")
+        return lines
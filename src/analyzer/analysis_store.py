@@ -0,0 +1,361 @@
+"""SQLite分析结果库模块
+
+把函数、变量、调用点、数据流图边和函数副作用写入带索引的SQLite数据库，
+查询"谁调用了find_timer"、"哪些函数写了g_timer_system"时只读取索引命中的行，
+不需要把全部结果加载到内存。
+
+增量更新：每一行都归属于一个文件（owner列，通常是产生该行的函数所在的源文件；
+无法归属的全局图节点和边归属于空字符串）。更新时对每个文件的全部行计算与顺序无关的摘要，
+只删除并重写摘要发生变化的文件的行，未变化文件的行保持不动。
+写入使用executemany分批执行，整个更新在一个事务中完成。
+"""
+
+import hashlib
+import json
+import os
+import sqlite3
+
+from .function_cfg import FunctionCFG
+from .source_location import split_location
+
+
+SCHEMA = """
+CREATE TABLE IF NOT EXISTS meta (
+    key TEXT PRIMARY KEY,
+    value TEXT
+);
+CREATE TABLE IF NOT EXISTS files (
+    owner TEXT PRIMARY KEY,
+    digest TEXT NOT NULL,
+    row_count INTEGER NOT NULL
+);
+CREATE TABLE IF NOT EXISTS functions (
+    name TEXT PRIMARY KEY,
+    file TEXT, line INTEGER, start_line INTEGER, end_line INTEGER, return_type TEXT,
+    is_declaration INTEGER, has_body INTEGER,
+    details TEXT,
+    owner TEXT NOT NULL
+);
+CREATE TABLE IF NOT EXISTS variables (
+    qualified_name TEXT PRIMARY KEY,
+    name TEXT, kind TEXT, scope TEXT, type TEXT, usr TEXT, storage TEXT,
+    file TEXT, line INTEGER, "column" INTEGER,
+    is_pointer INTEGER, is_global INTEGER, is_static INTEGER, is_heap INTEGER,
+    owner TEXT NOT NULL
+);
+CREATE TABLE IF NOT EXISTS variable_references (
+    variable TEXT, kind TEXT, function TEXT, argument_index INTEGER, assigned_to TEXT,
+    file TEXT, line INTEGER, "column" INTEGER,
+    owner TEXT NOT NULL
+);
+CREATE TABLE IF NOT EXISTS call_sites (
+    caller TEXT, callee TEXT, file TEXT, line INTEGER, "column" INTEGER,
+    owner TEXT NOT NULL
+);
+CREATE TABLE IF NOT EXISTS graph_nodes (
+    graph TEXT, function TEXT, node TEXT, type TEXT,
+    owner TEXT NOT NULL
+);
+CREATE TABLE IF NOT EXISTS graph_edges (
+    graph TEXT, function TEXT, source TEXT, target TEXT, type TEXT, via_function TEXT,
+    owner TEXT NOT NULL
+);
+CREATE TABLE IF NOT EXISTS side_effects (
+    function TEXT, category TEXT, operation TEXT, subject TEXT, file TEXT, line INTEGER, "column" INTEGER,
+    owner TEXT NOT NULL
+);
+CREATE INDEX IF NOT EXISTS idx_call_sites_callee ON call_sites (callee);
+CREATE INDEX IF NOT EXISTS idx_call_sites_caller ON call_sites (caller);
+CREATE INDEX IF NOT EXISTS idx_graph_edges_target ON graph_edges (target, graph);
+CREATE INDEX IF NOT EXISTS idx_graph_edges_source ON graph_edges (source, graph);
+CREATE INDEX IF NOT EXISTS idx_graph_edges_function ON graph_edges (function);
+CREATE INDEX IF NOT EXISTS idx_graph_nodes_function ON graph_nodes (function);
+CREATE INDEX IF NOT EXISTS idx_side_effects_subject ON side_effects (subject, category);
+CREATE INDEX IF NOT EXISTS idx_side_effects_function ON side_effects (function);
+CREATE INDEX IF NOT EXISTS idx_variable_references_variable ON variable_references (variable);
+CREATE INDEX IF NOT EXISTS idx_variable_references_function ON variable_references (function);
+CREATE INDEX IF NOT EXISTS idx_functions_owner ON functions (owner);
+CREATE INDEX IF NOT EXISTS idx_variables_owner ON variables (owner);
+CREATE INDEX IF NOT EXISTS idx_variable_references_owner ON variable_references (owner);
+CREATE INDEX IF NOT EXISTS idx_call_sites_owner ON call_sites (owner);
+CREATE INDEX IF NOT EXISTS idx_graph_nodes_owner ON graph_nodes (owner);
+CREATE INDEX IF NOT EXISTS idx_graph_edges_owner ON graph_edges (owner);
+CREATE INDEX IF NOT EXISTS idx_side_effects_owner ON side_effects (owner);
+"""
+
+# 表名 -> 列名（owner列由写入过程追加）
+TABLE_COLUMNS = {
+    'functions': ('name', 'file', 'line', 'start_line', 'end_line', 'return_type',
+                  'is_declaration', 'has_body', 'details'),
+    'variables': ('qualified_name', 'name', 'kind', 'scope', 'type', 'usr', 'storage',
+                  'file', 'line', 'column', 'is_pointer', 'is_global', 'is_static', 'is_heap'),
+    'variable_references': ('variable', 'kind', 'function', 'argument_index', 'assigned_to',
+                            'file', 'line', 'column'),
+    'call_sites': ('caller', 'callee', 'file', 'line', 'column'),
+    'graph_nodes': ('graph', 'function', 'node', 'type'),
+    'graph_edges': ('graph', 'function', 'source', 'target', 'type', 'via_function'),
+    'side_effects': ('function', 'category', 'operation', 'subject', 'file', 'line', 'column'),
+}
+
+# 写入函数的数据流图边类型
+WRITE_EDGE_TYPES = ('assignment', 'allocation', 'return')
+
+SCHEMA_VERSION = '1'
+
+
+class AnalysisStore:
+    """SQLite分析结果库"""
+
+    # 每批executemany写入的行数
+    BATCH_SIZE = 10000
+
+    # 全局图在graph列中的名称与对应的分析器属性；函数内部数据流图的graph列为'local_dfg'
+    GRAPHS = (('control_flow', 'cfg'), ('data_flow', 'global_dfg'), ('business_logic', 'business_logic'))
+
+    def __init__(self, db_path, read_only=False):
+        """打开（不存在时创建）分析结果库
+        Args:
+            db_path: SQLite数据库文件路径
+            read_only: 以只读方式打开已有的库（供查询和结果读取使用）
+        """
+        self.db_path = db_path
+        if read_only:
+            if not os.path.exists(db_path):
+                raise FileNotFoundError(f"分析结果库不存在: {db_path}")
+            self.connection = sqlite3.connect(f"file:{os.path.abspath(db_path)}?mode=ro", uri=True)
+            self.connection.row_factory = sqlite3.Row
+            return
+        directory = os.path.dirname(db_path)
+        if directory and not os.path.exists(directory):
+            os.makedirs(directory)
+        self.connection = sqlite3.connect(db_path)
+        self.connection.row_factory = sqlite3.Row
+        self.connection.execute('PRAGMA journal_mode=WAL')
+        self.connection.execute('PRAGMA synchronous=NORMAL')
+        self.connection.executescript(SCHEMA)
+        self.connection.execute("INSERT OR REPLACE INTO meta (key, value) VALUES ('schema_version', ?)",
+                                (SCHEMA_VERSION,))
+        self.connection.commit()
+
+    def close(self):
+        self.connection.close()
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, exc_type, exc, tb):
+        self.close()
+
+    # 写入
+    def update(self, analyzer, full=False):
+        """把分析器的结果写入库中
+
+        第一遍只计算每个归属文件的行摘要，第二遍只为摘要变化的文件生成并写入行，
+        内存占用与结果规模无关。
+        Args:
+            analyzer: 已完成analyze()的CCodeAnalyzer
+            full: 为True时忽略已有摘要，重写全部行
+        Returns:
+            {'updated': [重写的归属文件], 'removed': [删除的归属文件], 'rows': 写入行数}
+        """
+        digests = {}
+        for owner, table, row in self._iter_rows(analyzer):
+            digest = digests.get(owner)
+            if digest is None:
+                digest = digests[owner] = [0, 0]
+            # 逐行哈希后求和，得到与行顺序无关的摘要（集合遍历顺序不影响结果）
+            row_hash = hashlib.blake2b(repr((table, row)).encode('utf-8'), digest_size=16).digest()
+            digest[0] = (digest[0] + int.from_bytes(row_hash, 'little')) % (1 << 128)
+            digest[1] += 1
+
+        stored = {row['owner']: row['digest'] for row in self.connection.execute('SELECT owner, digest FROM files')}
+        new_digests = {owner: f"{value:032x}:{count}" for owner, (value, count) in digests.items()}
+        dirty = {owner for owner, digest in new_digests.items() if full or stored.get(owner) != digest}
+        removed = set(stored) - set(new_digests)
+
+        written = 0
+        with self.connection:
+            for owner in dirty | removed:
+                for table in TABLE_COLUMNS:
+                    self.connection.execute(f'DELETE FROM {table} WHERE owner = ?', (owner,))
+            self.connection.executemany('DELETE FROM files WHERE owner = ?', [(owner,) for owner in removed])
+
+            if dirty:
+                batches = {table: [] for table in TABLE_COLUMNS}
+                for owner, table, row in self._iter_rows(analyzer):
+                    if owner not in dirty:
+                        continue
+                    batch = batches[table]
+                    batch.append(row + (owner,))
+                    if len(batch) >= self.BATCH_SIZE:
+                        written += self._flush(table, batch)
+                for table, batch in batches.items():
+                    written += self._flush(table, batch)
+
+            self.connection.executemany(
+                'INSERT OR REPLACE INTO files (owner, digest, row_count) VALUES (?, ?, ?)',
+                [(owner, new_digests[owner], digests[owner][1]) for owner in dirty])
+            self.connection.execute("INSERT OR REPLACE INTO meta (key, value) VALUES ('files', ?)",
+                                    (json.dumps(list(analyzer.files), ensure_ascii=False),))
+
+        return {'updated': sorted(dirty), 'removed': sorted(removed), 'rows': written}
+
+    def _flush(self, table, batch):
+        if not batch:
+            return 0
+        columns = TABLE_COLUMNS[table] + ('owner',)
+        column_list = ', '.join(f'"{column}"' for column in columns)
+        placeholders = ', '.join('?' * len(columns))
+        self.connection.executemany(
+            f'INSERT OR REPLACE INTO {table} ({column_list}) VALUES ({placeholders})', batch)
+        count = len(batch)
+        batch.clear()
+        return count
+
+    def _iter_rows(self, analyzer):
+        """逐行生成 (归属文件, 表名, 行)"""
+        function_files = {}
+        for name, func_info in analyzer.functions.items():
+            function_files[name] = split_location(func_info.get('location'))[0] or ''
+
+        for name, func_info in analyzer.functions.items():
+            owner = function_files[name]
+            file_name, line, _ = split_location(func_info.get('location'))
+            details = {
+                'location': func_info.get('location'),
+                'parameters': func_info.get('parameters', []),
+                'local_variables': func_info.get('local_variables', []),
+                'calls': func_info.get('calls', []),
+            }
+            block_cfg = func_info.get('block_cfg')
+            if isinstance(block_cfg, FunctionCFG):
+                details['block_cfg'] = block_cfg.to_dict()
+            if func_info.get('memory_traffic') is not None:
+                details['memory_traffic'] = func_info['memory_traffic']
+            yield owner, 'functions', (
+                name, file_name, line, func_info.get('start_line'), func_info.get('end_line'),
+                func_info.get('return_type'), int(bool(func_info.get('is_declaration', False))),
+                int(bool(func_info.get('has_body', False))),
+                json.dumps(details, ensure_ascii=False, separators=(',', ':'), default=str))
+
+            local_dfg = func_info.get('local_dfg')
+            if local_dfg is not None:
+                for node, data in local_dfg.nodes(data=True):
+                    yield owner, 'graph_nodes', ('local_dfg', name, str(node), data.get('type'))
+                for source, target, data in local_dfg.edges(data=True):
+                    yield owner, 'graph_edges', ('local_dfg', name, str(source), str(target),
+                                                 data.get('type'), data.get('via_function'))
+
+            for category, effects in func_info.get('side_effects', {}).items():
+                if isinstance(effects, (set, frozenset)):
+                    # 全局变量读写集合
+                    for variable in sorted(effects):
+                        yield owner, 'side_effects', (name, category, None, variable, None, None, None)
+                    continue
+                for effect in effects:
+                    effect_file, effect_line, effect_column = split_location(effect.get('location'))
+                    subject = effect.get('variable', effect.get('file', effect.get('target')))
+                    yield owner, 'side_effects', (name, category, effect.get('operation'),
+                                                  None if subject is None else str(subject),
+                                                  effect_file, effect_line, effect_column)
+
+        for qualified_name, symbol in analyzer.symbols.items():
+            owner = symbol.file or ''
+            yield owner, 'variables', (
+                qualified_name, symbol.name, symbol.kind, symbol.scope, symbol.type, symbol.usr,
+                symbol.storage, symbol.file, symbol.line, symbol.column, int(symbol.is_pointer),
+                int(symbol.is_global), int(symbol.is_static), int(symbol.is_heap and symbol.is_pointer))
+            for ref in symbol.references:
+                argument_index, assigned_to = (ref.target, None) if ref.kind == 'argument' else (None, ref.target)
+                yield ref.file or owner, 'variable_references', (
+                    qualified_name, ref.kind, ref.function, argument_index, assigned_to,
+                    ref.file, ref.line, ref.column)
+
+        for call_info in analyzer.function_calls:
+            file_name, line, column = split_location(call_info.get('location'))
+            yield file_name or '', 'call_sites', (call_info.get('caller'), call_info['function'],
+                                                  file_name, line, column)
+
+        for graph_name, attribute in self.GRAPHS:
+            graph = getattr(analyzer, attribute)
+            for node, data in graph.nodes(data=True):
+                yield function_files.get(node, ''), 'graph_nodes', (graph_name, None, str(node), data.get('type'))
+            for source, target, data in graph.edges(data=True):
+                via_function = data.get('via_function')
+                owner = function_files.get(via_function) or function_files.get(source) or \
+                    function_files.get(target) or ''
+                yield owner, 'graph_edges', (graph_name, via_function, str(source), str(target),
+                                             data.get('type'), via_function)
+
+    # 查询
+    def callers(self, function):
+        """调用了指定函数的调用点"""
+        return self._rows('SELECT caller, file, line, "column" FROM call_sites WHERE callee = ? '
+                          'ORDER BY caller, file, line', (function,))
+
+    def callees(self, function):
+        """指定函数中的调用点"""
+        return self._rows('SELECT callee, file, line, "column" FROM call_sites WHERE caller = ? '
+                          'ORDER BY file, line', (function,))
+
+    def writers(self, variable):
+        """写入指定变量的函数：副作用中的全局变量写入、堆分配，以及函数内部数据流图中指向该变量的写入边"""
+        placeholders = ', '.join('?' * len(WRITE_EDGE_TYPES))
+        return self._rows(
+            'SELECT function, category AS via FROM side_effects '
+            "WHERE subject = ? AND category IN ('global_vars_write', 'heap_operations') "
+            'UNION '
+            'SELECT function, type AS via FROM graph_edges '
+            f"WHERE target = ? AND graph = 'local_dfg' AND type IN ({placeholders}) "
+            'ORDER BY function',
+            (variable, variable, *WRITE_EDGE_TYPES))
+
+    def readers(self, variable):
+        """读取指定变量的函数：副作用中的全局变量读取，以及函数内部数据流图中以该变量为源的边"""
+        return self._rows(
+            "SELECT function, category AS via FROM side_effects WHERE subject = ? AND category = 'global_vars_read' "
+            'UNION '
+            "SELECT function, type AS via FROM graph_edges WHERE source = ? AND graph = 'local_dfg' "
+            'ORDER BY function',
+            (variable, variable))
+
+    def references(self, variable):
+        """变量的引用记录（作为调用参数或赋值给其他变量）"""
+        return self._rows('SELECT kind, function, argument_index, assigned_to, file, line, "column" '
+                          'FROM variable_references WHERE variable = ? ORDER BY file, line', (variable,))
+
+    def function(self, name):
+        """函数信息，details列解码为字典；函数不存在时返回None"""
+        row = self.connection.execute('SELECT * FROM functions WHERE name = ?', (name,)).fetchone()
+        if row is None:
+            return None
+        info = dict(row)
+        info['details'] = json.loads(info['details']) if info['details'] else {}
+        return info
+
+    def side_effects(self, function):
+        return self._rows('SELECT category, operation, subject, file, line, "column" FROM side_effects '
+                          'WHERE function = ? ORDER BY category', (function,))
+
+    def edges(self, graph, function=None):
+        """某张图的全部边；graph为'local_dfg'时需指定函数"""
+        if function is None:
+            return self._rows('SELECT source, target, type, via_function FROM graph_edges WHERE graph = ?', (graph,))
+        return self._rows('SELECT source, target, type, via_function FROM graph_edges '
+                          'WHERE graph = ? AND function = ?', (graph, function))
+
+    def meta(self, key, default=None):
+        row = self.connection.execute('SELECT value FROM meta WHERE key = ?', (key,)).fetchone()
+        return row[0] if row is not None else default
+
+    def stats(self):
+        """各表行数"""
+        return {table: self.connection.execute(f'SELECT COUNT(*) FROM {table}').fetchone()[0]
+                for table in TABLE_COLUMNS}
+
+    def query(self, sql, params=()):
+        """执行任意只读SQL"""
+        return self._rows(sql, params)
+
+    def _rows(self, sql, params):
+        return [dict(row) for row in self.connection.execute(sql, params)]
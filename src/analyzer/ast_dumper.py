@@ -0,0 +1,217 @@
+"""AST调试转储模块
+
+将libclang游标树输出为调试文件，便于开发者理解代码结构。
+转储默认关闭，启用后支持以下控制项：
+- 仅输出主文件（跳过系统头文件等被包含文件的子树）
+- 最大遍历深度
+- 节点类型白名单（只写出指定类型的节点，但仍会遍历其子节点）
+- 最大节点数（超出后截断）
+- 文本或JSONL格式，可选gzip压缩
+- 在后台线程中格式化并写入，主线程只负责从libclang提取节点信息
+"""
+
+import gzip
+import json
+import queue
+import threading
+
+import clang.cindex
+
+
+class AstDumper:
+    """AST转储器"""
+
+    FORMATS = ('text', 'jsonl')
+
+    # 后台写入队列的容量，队列满时遍历线程阻塞等待，避免内存无限增长
+    QUEUE_SIZE = 4096
+
+    def __init__(self, output_file, fmt='text', main_file_only=True, max_depth=None,
+                 kinds=None, max_nodes=None, background=True, compress=False):
+        """初始化AST转储器
+        Args:
+            output_file: 输出文件路径（启用压缩时自动追加.gz后缀）
+            fmt: 输出格式，'text'或'jsonl'
+            main_file_only: 是否只输出翻译单元主文件中的节点
+            max_depth: 最大遍历深度，None表示不限制
+            kinds: 节点类型名称白名单（如['FUNCTION_DECL', 'CALL_EXPR']），None表示全部输出
+            max_nodes: 最多输出的节点数，None表示不限制
+            background: 是否使用后台线程写入
+            compress: 是否使用gzip压缩输出
+        """
+        if fmt not in self.FORMATS:
+            raise ValueError(f"不支持的AST转储格式: {fmt}，可选: {', '.join(self.FORMATS)}")
+
+        self.output_file = output_file + '.gz' if compress else output_file
+        self.fmt = fmt
+        self.main_file_only = main_file_only
+        self.max_depth = max_depth
+        self.kinds = set(kinds) if kinds else None
+        self.max_nodes = max_nodes
+        self.background = background
+        self.compress = compress
+
+        self.node_count = 0
+        self.truncated = False
+
+    def dump(self, tu):
+        """转储整个翻译单元，返回写出的节点数"""
+        self.node_count = 0
+        self.truncated = False
+
+        if self.compress:
+            out = gzip.open(self.output_file, 'wt', encoding='utf-8')
+        else:
+            out = open(self.output_file, 'w', encoding='utf-8')
+
+        write = self._write_jsonl if self.fmt == 'jsonl' else self._write_text
+
+        if self.background:
+            records = queue.Queue(maxsize=self.QUEUE_SIZE)
+            errors = []
+
+            def writer():
+                try:
+                    while True:
+                        record = records.get()
+                        if record is None:
+                            break
+                        write(out, record)
+                except Exception as e:
+                    errors.append(e)
+                    # 继续消费队列，避免遍历线程在put上阻塞
+                    while records.get() is not None:
+                        pass
+
+            writer_thread = threading.Thread(target=writer, name='ast-dump-writer', daemon=True)
+            writer_thread.start()
+            emit = records.put
+        else:
+            emit = lambda record: write(out, record)
+
+        try:
+            self._walk(tu.cursor, tu.spelling, emit)
+        finally:
+            if self.background:
+                records.put(None)
+                writer_thread.join()
+            if self.truncated:
+                if self.fmt == 'jsonl':
+                    marker = {'truncated': True, 'max_nodes': self.max_nodes}
+                    out.write(json.dumps(marker, separators=(',', ':')) + '\n')
+                else:
+                    out.write(f"... 已截断，达到最大节点数 {self.max_nodes}\n")
+            out.close()
+
+        if self.background and errors:
+            raise errors[0]
+
+        return self.node_count
+
+    def _walk(self, root, main_file, emit):
+        """迭代遍历游标树（避免深层AST触发递归深度限制）"""
+        stack = [(root, 0)]
+        while stack:
+            cursor, level = stack.pop()
+
+            # 只在翻译单元的直接子节点上检查位置，其子树与之位于同一文件
+            if self.main_file_only and level == 1:
+                location_file = cursor.location.file
+                if location_file is None or location_file.name != main_file:
+                    continue
+
+            if self.kinds is None or cursor.kind.name in self.kinds:
+                if self.max_nodes is not None and self.node_count >= self.max_nodes:
+                    self.truncated = True
+                    return
+                emit(self._make_record(cursor, level))
+                self.node_count += 1
+
+            if self.max_depth is not None and level >= self.max_depth:
+                continue
+
+            children = list(cursor.get_children())
+            for child in reversed(children):
+                stack.append((child, level + 1))
+
+    def _make_record(self, cursor, level):
+        """从游标中提取节点信息（必须在遍历线程中调用libclang）"""
+        location = cursor.location
+        record = {
+            'depth': level,
+            'kind': cursor.kind.name,
+            'spelling': cursor.spelling,
+            'file': location.file.name if location.file else None,
+            'line': location.line,
+            'column': location.column,
+            'type': cursor.type.spelling,
+            'type_kind': str(cursor.type.kind),
+            'canonical_type': cursor.type.get_canonical().spelling
+        }
+
+        # 如果是函数定义，输出更多详细信息
+        if cursor.kind == clang.cindex.CursorKind.FUNCTION_DECL:
+            record['is_definition'] = cursor.is_definition()
+            record['return_type'] = cursor.result_type.spelling
+            record['parameters'] = [[param.spelling, param.type.spelling] for param in cursor.get_arguments()]
+            record['has_body'] = any(child.kind == clang.cindex.CursorKind.COMPOUND_STMT
+                                     for child in cursor.get_children())
+
+        # 如果是包含指令，输出更多详细信息
+        elif cursor.kind == clang.cindex.CursorKind.INCLUSION_DIRECTIVE:
+            try:
+                included_file = cursor.get_included_file()
+                record['included_file'] = included_file.name if included_file else None
+            except Exception as e:
+                record['included_file_error'] = str(e)
+            record['include_path'] = cursor.displayname
+
+        # 如果是变量声明，输出更多详细信息
+        elif cursor.kind == clang.cindex.CursorKind.VAR_DECL:
+            record['storage_class'] = str(cursor.storage_class)
+            record['is_global'] = cursor.semantic_parent.kind == clang.cindex.CursorKind.TRANSLATION_UNIT
+
+        return record
+
+    @staticmethod
+    def _write_jsonl(out, record):
+        out.write(json.dumps(record, separators=(',', ':'), ensure_ascii=False))
+        out.write('\n')
+
+    @staticmethod
+    def _write_text(out, record):
+        indent = '  ' * record['depth']
+        location_info = "未知位置"
+        if record['file']:
+            location_info = f"{record['file']}:{record['line']}:{record['column']}"
+
+        lines = [
+            f"{indent}Node: {record['kind']}",
+            f"{indent}Spelling: {record['spelling']}",
+            f"{indent}Location: {location_info}",
+            f"{indent}Type: {record['type']}",
+            f"{indent}Type Kind: {record['type_kind']}",
+            f"{indent}Canonical Type: {record['canonical_type']}"
+        ]
+
+        if 'is_definition' in record:
+            lines.append(f"{indent}Is Definition: {record['is_definition']}")
+            lines.append(f"{indent}Return Type: {record['return_type']}")
+            lines.append(f"{indent}Parameters:")
+            for name, type_spelling in record['parameters']:
+                lines.append(f"{indent}  - {name}: {type_spelling}")
+            lines.append(f"{indent}Has Body: {record['has_body']}")
+        elif 'include_path' in record:
+            if 'included_file_error' in record:
+                lines.append(f"{indent}Included File: 获取失败 ({record['included_file_error']})")
+            elif record.get('included_file'):
+                lines.append(f"{indent}Included File: {record['included_file']}")
+            else:
+                lines.append(f"{indent}Included File: 未找到 (可能是标准库或路径问题)")
+            lines.append(f"{indent}Include Path: {record['include_path']}")
+        elif 'storage_class' in record:
+            lines.append(f"{indent}Storage Class: {record['storage_class']}")
+            lines.append(f"{indent}Is Global: {record['is_global']}")
+
+        out.write('\n'.join(lines))
+        out.write('\n\n')
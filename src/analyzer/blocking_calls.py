@@ -0,0 +1,185 @@
+"""热点路径阻塞调用检测模块
+
+把调用点按可能阻塞的原因分类：
+- sleep：sleep、usleep、nanosleep等主动休眠
+- file_io：文件与标准输入输出（分析器的FILE_OP_PATTERNS以及read/write/printf等）
+- network：套接字与多路复用等待（分析器的NETWORK_OP_PATTERNS以及poll/select/epoll_wait等）
+- lock：互斥锁、读写锁、自旋锁的加锁和条件变量等待（不含trylock）
+- unknown：未解析出目标的间接调用，回调可能执行任意代码
+
+从analysis_options中latency_critical列出的根出发报告全部传递可达的阻塞调用和完整调用链。
+根可以是函数名，也可以是回调类型名（如TimerCallback）：经该类型函数指针间接调用的目标函数、
+以及该类型参数可能指向的函数都作为回调根，调用链从发起间接调用的函数开始。
+此外，循环中调用了延迟敏感函数的驱动循环（如main中反复调用timer_update的循环）里的阻塞调用
+会推迟下一次调用，同样报告。
+"""
+
+from .hot_paths import HotPathIndex
+from .lock_analysis import sync_operation
+from .source_location import location_line
+
+
+SLEEP_FUNCTIONS = ('sleep', 'usleep', 'nanosleep', 'clock_nanosleep', 'thrd_sleep', 'pause')
+FILE_IO_FUNCTIONS = ('open', 'openat', 'read', 'write', 'pread', 'pwrite', 'close', 'fsync', 'fdatasync',
+                     'fgets', 'fputs', 'fgetc', 'fputc', 'getc', 'putc', 'getline', 'getchar', 'putchar',
+                     'printf', 'vprintf', 'puts', 'scanf', 'perror')
+NETWORK_FUNCTIONS = ('poll', 'ppoll', 'select', 'pselect', 'epoll_wait', 'epoll_pwait',
+                     'getaddrinfo', 'gethostbyname')
+BLOCKING_CLASSES = ('lock', 'sleep', 'network', 'file_io', 'unknown')
+
+
+class BlockingCallDetector:
+    """延迟敏感路径上的阻塞调用检测"""
+
+    def __init__(self, analyzer, roots=None):
+        """初始化检测器
+        Args:
+            analyzer: 已完成分析的CCodeAnalyzer
+            roots: 延迟敏感的函数名或回调类型名，默认使用analyzer.options中的latency_critical
+        """
+        self.analyzer = analyzer
+        self.call_graph = analyzer.call_graph
+        self.hot_paths = HotPathIndex(analyzer, [])
+        self.roots = list(roots if roots is not None else analyzer.options.get('latency_critical', []))
+        self._direct_cache = {}
+
+    def classify(self, callee):
+        """调用的阻塞类别，不阻塞或被调函数有定义（其函数体单独分析）时返回None"""
+        func_info = self.analyzer.functions.get(callee)
+        if func_info is not None and func_info.get('has_body'):
+            return None
+        sync = sync_operation(callee)
+        if sync is not None:
+            return 'lock' if sync[0] in ('acquire', 'wait') else None
+        if callee in SLEEP_FUNCTIONS:
+            return 'sleep'
+        if callee in NETWORK_FUNCTIONS or any(pattern in callee for pattern in self.analyzer.NETWORK_OP_PATTERNS):
+            return 'network'
+        if callee in FILE_IO_FUNCTIONS or any(pattern in callee for pattern in self.analyzer.FILE_OP_PATTERNS):
+            return 'file_io'
+        return None
+
+    def analyze(self):
+        """返回阻塞调用报告
+        Returns:
+            {
+                'roots': 解析后的根（函数或回调类型及其目标函数）,
+                'sites': 阻塞调用点（含类别、根和完整调用链）,
+                'by_class': {类别: 调用点数}
+            }
+        """
+        roots = self._resolve_roots()
+        sites = []
+        seen = set()
+
+        def add(site):
+            key = (site['root'], site['function'], site['line'], site['callee'])
+            if key not in seen:
+                seen.add(key)
+                sites.append(site)
+
+        for root in roots:
+            for function in root['functions']:
+                prefix = [root['invoked_from']] if root.get('invoked_from') else []
+                for site in self._blocking_under(function):
+                    chain = self.call_graph.call_chain(function, (site['function'],)) or [function]
+                    add({**site, 'root': root['name'], 'root_kind': root['kind'],
+                         'call_chain': prefix + chain + [site['callee']]})
+
+        # 驱动循环：循环中调用了延迟敏感函数，循环里的阻塞调用推迟下一次调用
+        critical = {function for root in roots for function in root['functions']}
+        for function, func_info in self.analyzer.functions.items():
+            block_cfg = func_info.get('block_cfg')
+            if block_cfg is None:
+                continue
+            for loop in block_cfg.loops:
+                driven = sorted(critical.intersection(loop['calls']))
+                if not driven:
+                    continue
+                for callee, line, depth, _ in self.hot_paths.call_sites(function):
+                    if not loop['start_line'] <= line <= loop['end_line'] or callee in critical:
+                        continue
+                    blocking = self.classify(callee)
+                    if blocking is not None:
+                        add({'function': function, 'line': line, 'callee': callee, 'class': blocking,
+                             'loop_depth': depth, 'root': driven[0], 'root_kind': 'driver_loop',
+                             'call_chain': [function, callee]})
+                        continue
+                    for site in self._blocking_under(callee):
+                        chain = self.call_graph.call_chain(callee, (site['function'],)) or [callee]
+                        add({**site, 'root': driven[0], 'root_kind': 'driver_loop',
+                             'call_chain': [function] + chain + [site['callee']]})
+
+        sites.sort(key=lambda site: (BLOCKING_CLASSES.index(site['class']), -site['loop_depth'],
+                                     len(site['call_chain']), site['function'], site['line']))
+        by_class = {}
+        for site in sites:
+            by_class[site['class']] = by_class.get(site['class'], 0) + 1
+        return {'roots': roots, 'sites': sites, 'by_class': by_class}
+
+    def _resolve_roots(self):
+        """把根名称解析为函数：函数名直接使用，类型名解析为该类型函数指针的目标函数"""
+        roots = []
+        for name in self.roots:
+            if self.call_graph.component_of(name) is not None:
+                roots.append({'name': name, 'kind': 'entry', 'functions': [name]})
+                continue
+            # 回调类型：经该类型函数指针的间接调用，调用链从发起调用的函数开始
+            for call_info in self.analyzer.indirect_calls.values():
+                if call_info.get('callee_type') != name:
+                    continue
+                roots.append({'name': name, 'kind': 'callback', 'invoked_from': call_info['caller'],
+                              'location': call_info['location'], 'functions': list(call_info['targets'])})
+            # 以该类型参数传入的函数（即使没有观察到间接调用）
+            targets = []
+            for function, func_info in self.analyzer.functions.items():
+                for index, param in enumerate(func_info.get('parameters', [])):
+                    if param['type'] != name:
+                        continue
+                    node_id = self.analyzer.points_to.find_node(('param', function, index))
+                    for object_id in self.analyzer.points_to.points_to(node_id) if node_id is not None else ():
+                        obj = self.analyzer.points_to.objects[object_id]
+                        if obj['kind'] == 'function' and obj['function'] not in targets:
+                            targets.append(obj['function'])
+            covered = {target for root in roots if root['name'] == name for target in root['functions']}
+            extra = [target for target in targets if target not in covered]
+            if extra:
+                roots.append({'name': name, 'kind': 'callback', 'invoked_from': None, 'functions': extra})
+        return roots
+
+    def _direct_sites(self, function):
+        """函数中直接的阻塞调用点，以及未解析目标的间接调用"""
+        sites = self._direct_cache.get(function)
+        if sites is not None:
+            return sites
+        sites = []
+        for callee, line, depth, _ in self.hot_paths.call_sites(function):
+            blocking = self.classify(callee)
+            if blocking is not None:
+                sites.append({'function': function, 'line': line, 'callee': callee, 'class': blocking,
+                              'loop_depth': depth})
+        block_cfg = self.analyzer.functions.get(function, {}).get('block_cfg')
+        for call_info in self.analyzer.indirect_calls.values():
+            if call_info['caller'] == function and not call_info['targets']:
+                line = location_line(call_info['location'])
+                sites.append({'function': function, 'line': line, 'callee': call_info['function'],
+                              'class': 'unknown',
+                              'loop_depth': block_cfg.loop_depth_at(line) if block_cfg is not None else 0})
+        self._direct_cache[function] = sites
+        return sites
+
+    def _blocking_under(self, function):
+        """函数自身及其传递调用的函数中的阻塞调用点"""
+        sites = []
+        for reached in [function] + sorted(self.call_graph.transitive_callees(function) - {function}):
+            sites.extend(self._direct_sites(reached))
+        return sites
+
+    @staticmethod
+    def summary(report, limit=10):
+        lines = []
+        for site in report['sites'][:limit]:
+            where = f", loop depth {site['loop_depth']}" if site['loop_depth'] else ''
+            lines.append(f"{site['callee']}() [{site['class']}{where}] from {site['root']} "
+                         f"({site['root_kind']}): {' -> '.join(site['call_chain'])}")
+        return lines
@@ -2,6 +2,8 @@ import networkx as nx
 import matplotlib.pyplot as plt
 from collections import defaultdict
 
+from .graph_store import networkx_view
+
 class BusinessLogicExtractor:
     def __init__(self, analyzer):
         """初始化业务逻辑提取器"""
@@ -12,7 +14,7 @@ class BusinessLogicExtractor:
     def extract_modules(self):
         """从数据流图中提取业务模块"""
         # 基于函数调用关系聚类
-        G = self.analyzer.cfg.copy()
+        G = networkx_view(self.analyzer.cfg).copy()
         
         # 使用社区检测算法识别模块
         try:
@@ -37,7 +39,7 @@ class BusinessLogicExtractor:
                     for src_node in src_nodes:
                         for dst_node in dst_nodes:
                             if (self.analyzer.cfg.has_edge(src_node, dst_node) or
-                                self.analyzer.dfg.has_edge(src_node, dst_node)):
+                                self.analyzer.global_dfg.has_edge(src_node, dst_node)):
                                 self.module_dependencies.add_edge(src_module, dst_module)
                                 break
         
@@ -53,8 +55,12 @@ class BusinessLogicExtractor:
                 'internal_edges': 0,
                 'external_edges': 0,
                 'global_vars': 0,
-                'heap_vars': 0
+                'heap_vars': 0,
+                'max_complexity': None,
+                'most_expensive': None
             }
+            costs = getattr(self.analyzer, 'cost_report', {}).get('functions', {})
+            max_degree = -1
             
             # 计算内部边和外部边
             for node in nodes:
@@ -63,6 +69,12 @@ class BusinessLogicExtractor:
                     metrics['global_vars'] += 1
                 if node in self.analyzer.heap_vars:
                     metrics['heap_vars'] += 1
+                # 模块中代价最高的函数
+                cost = costs.get(node)
+                if cost is not None and cost['degree'] > max_degree:
+                    max_degree = cost['degree']
+                    metrics['max_complexity'] = cost['complexity']
+                    metrics['most_expensive'] = node
                 
                 # 统计边的数量
                 for successor in self.analyzer.cfg.successors(node):
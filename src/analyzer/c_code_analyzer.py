@@ -1,7 +1,9 @@
 import os
 import sys
+import copy
 import json
 import glob
+import hashlib
 import networkx as nx
 import matplotlib.pyplot as plt
 from collections import defaultdict
@@ -25,31 +27,113 @@ except Exception as e:
     print(f"Warning: Failed to set libclang path: {e}")
     print("Please install LLVM/Clang and ensure it's in your PATH")
 
+from .ast_dumper import AstDumper
+from .compilation_database import CompilationDatabase
+from .symbol_table import SymbolTable
+from .cursor_tokens import binary_operator, callee_text, token_text, unary_operator
+from .points_to import PointsToGraph
+from .function_cfg import FunctionCFG, FunctionCFGBuilder
+from .graph_store import CompactDiGraph, networkx_view
+from .result_exporter import StreamingResultExporter
+from .columnar_exporter import ColumnarResultExporter
+from .analysis_store import AnalysisStore
+from .call_graph import CallGraphIndex
+from .struct_layout import StructLayoutAnalyzer
+from .allocation_analysis import AllocationAnalyzer, allocation_functions
+from .list_traversal import LinkedListTraversalDetector, LOOP_KINDS
+from .cost_model import CostModel
+from .shared_state import SharedStateAnalyzer, THREAD_CREATE_FUNCTIONS
+from .lock_analysis import LockAnalyzer, sync_operation
+from .blocking_calls import BlockingCallDetector
+from .memory_traffic import MemoryTrafficAnalyzer
+from .escape_analysis import EscapeAnalyzer
+from .memory_lifetime import MemoryLifetimeAnalyzer, RELEASE_FUNCTIONS, SIZE_ARGUMENTS
+
 class CCodeAnalyzer:
-    def __init__(self, path, include_paths=None):
+    # CXTranslationUnit_CreatePreambleOnFirstParse，Python绑定中没有对应常量
+    PARSE_CREATE_PREAMBLE_ON_FIRST_PARSE = 0x100
+
+    # 需要收集指针指向约束的节点类型
+    POINTER_CONSTRAINT_KINDS = (
+        clang.cindex.CursorKind.VAR_DECL,
+        clang.cindex.CursorKind.BINARY_OPERATOR,
+        clang.cindex.CursorKind.CALL_EXPR,
+        clang.cindex.CursorKind.RETURN_STMT,
+    )
+    
+    # 按名称子串识别的文件和网络操作函数
+    FILE_OP_PATTERNS = ('fopen', 'fclose', 'fread', 'fwrite', 'fprintf', 'fscanf', 'fseek', 'ftell', 'rewind', 'fflush')
+    NETWORK_OP_PATTERNS = ('socket', 'connect', 'bind', 'listen', 'accept', 'send', 'recv', 'sendto', 'recvfrom')
+    
+    SHARED_ACCESS_KINDS = (
+        clang.cindex.CursorKind.DECL_REF_EXPR,
+        clang.cindex.CursorKind.MEMBER_REF_EXPR,
+        clang.cindex.CursorKind.BINARY_OPERATOR,
+        clang.cindex.CursorKind.COMPOUND_ASSIGNMENT_OPERATOR,
+        clang.cindex.CursorKind.UNARY_OPERATOR,
+    )
+    
+    def __init__(self, path, include_paths=None, options=None):
         """初始化C代码分析器
         Args:
-            path: 可以是单个C文件的路径，也可以是包含C文件的目录路径
+            path: 可以是单个C文件的路径、包含C文件的目录路径或文件路径列表；
+                  为None时使用compile_commands选项指定的编译数据库中的全部源文件
             include_paths: 包含头文件的路径列表
+            options: 分析选项字典（对应配置文件中的analysis_options），例如：
+                dump_ast: 生成AST调试文件，False/True/'text'/'jsonl'，默认False
+                ast_dump_main_file_only: AST转储时只输出主文件节点，默认True
+                ast_dump_max_depth: AST转储最大深度
+                ast_dump_kinds: AST转储的节点类型白名单
+                ast_dump_max_nodes: AST转储最大节点数
+                ast_dump_background: 是否在后台线程写入AST转储，默认True
+                ast_dump_compress: 是否gzip压缩AST转储，默认False
+                header_filter: 顶层声明过滤模式，'all'/'project'/'called'，默认'project'
+                project_roots: 项目根目录列表，默认为被分析文件所在目录、include_paths和编译数据库中
+                    位于数据库目录或源文件公共根目录下的-I/-iquote目录
+                precompiled_headers: 构建为预编译头的公共头文件列表（路径或'<stdlib.h>'形式）
+                reuse_preamble: 缓存翻译单元并使用预编译前导，再次分析时reparse，默认False
+                compile_commands: compile_commands.json路径（或其所在目录），
+                                  数据库中的文件使用其真实编译参数解析
+                cache_line_size: 结构体布局分析使用的缓存行大小（字节），默认64
+                entry_points: 热点入口函数列表（如对外API），性能分析据此判断调用点是否位于热点路径
+                cost_top_n: 复杂度报告中每个入口函数列出的代价最高函数数，默认10
+                thread_entries: 可能在多个线程中并发执行的函数列表，与pthread_create的线程函数一起作为线程入口
+                critical_section_lines: 超过该行数的临界区报告为长临界区，默认30
+                latency_critical: 延迟敏感的函数名或回调类型名（如TimerCallback），报告从它们可达的阻塞调用
+                allocators: 自定义分配函数名列表（如内存池的pool_alloc），与malloc等标准分配函数一样作为堆分配点
         """
+        self.options = dict(options or {})
+        self.allocation_functions = allocation_functions(self.options)  # 标准分配函数与配置的自定义分配函数
+        
+        # 加载编译数据库
+        self.compilation_database = None
+        if self.options.get('compile_commands'):
+            self.compilation_database = CompilationDatabase(self.options['compile_commands'])
+        
         self.files = []
-        if os.path.isdir(path):
-            self.files.extend(glob.glob(os.path.join(path, '**/*.c'), recursive=True))
-            self.files.extend(glob.glob(os.path.join(path, '**/*.h'), recursive=True))
+        if path is None:
+            if self.compilation_database:
+                self.files.extend(self.compilation_database.source_files())
         else:
-            self.files.append(path)
+            for entry in (path if isinstance(path, (list, tuple)) else [path]):
+                if os.path.isdir(entry):
+                    self.files.extend(glob.glob(os.path.join(entry, '**/*.c'), recursive=True))
+                    self.files.extend(glob.glob(os.path.join(entry, '**/*.h'), recursive=True))
+                else:
+                    self.files.append(entry)
         
         self.include_paths = include_paths or []
         self.index = clang.cindex.Index.create()
-        self.cfg = nx.DiGraph()  # 控制流图
-        self.global_dfg = nx.DiGraph()  # 全局数据流图（函数间）
-        self.variables = {}  # 变量信息
-        self.global_vars = set()  # 全局变量
-        self.static_vars = set()  # 静态变量
-        self.heap_vars = set()  # 堆变量
-        self.function_calls = []  # 函数调用
-        self.business_logic = nx.DiGraph()  # 业务逻辑图
-        self.functions = {}
+        attributes = set(vars(self))
+        self._reset_results()
+        # _reset_results设置的属性即全部提取结果，增量重新分析时整体快照和恢复
+        self._result_attributes = sorted(set(vars(self)) - attributes)
+        self._snapshot = None  # (已提取的源文件, 提取结果快照)，见reanalyze
+        self._input_files = {os.path.normcase(os.path.abspath(f)) for f in self.files}  # 最初的输入文件
+        self._project_roots = None  # 项目根目录（用于跳过系统头文件）
+        self._project_file_cache = {}  # 文件名 -> 是否属于项目
+        self._pch_cache = {}  # 预编译头缓存键（宏定义、系统include目录和语言选项） -> 预编译头路径
+        self._tu_cache = {}  # 文件路径 -> (编译参数, 翻译单元)，用于reparse
     
     def analyze(self):
         """执行完整的代码分析"""
@@ -58,43 +142,200 @@ class CCodeAnalyzer:
                 
         # 处理每个源文件
         for file_path in self.files:
+            self._analyze_file(file_path, temp_dir, parse_log_file)
+
+        # 缓存翻译单元时（监视模式）保存提取结果快照，增量重新分析从快照继续
+        # （解析失败的文件没有提取结果，也不在翻译单元缓存中）
+        if self.options.get('reuse_preamble', False):
+            self._snapshot = (tuple(f for f in self.files if f in self._tu_cache), self._copy_results())
+
+        # 完成分析
+        self._finalize_analysis()
+        return self
+    
+    def reanalyze(self, changed_files):
+        """增量重新分析（用于监视模式）
+        
+        只重新提取变更的源文件以及包含了变更头文件的翻译单元，其余翻译单元的提取结果
+        从快照恢复（需启用reuse_preamble选项缓存翻译单元），然后重新完成全局分析。
+        受影响的翻译单元移到文件列表末尾，快照保存在它们之前的全部提取结果，
+        因此反复编辑同一文件时只重新提取该文件；结果与按调整后的文件顺序完整分析一次相同。
+        快照中的文件不再是未受影响文件的前缀时（如首次变更、改为编辑另一个文件），
+        未受影响的翻译单元从缓存重新提取一次（不重新解析）并更新快照。
+        Args:
+            changed_files: 发生变更的文件路径集合（.c或.h）
+        Returns:
+            重新提取的源文件列表
+        """
+        changed = {os.path.normcase(os.path.abspath(f)) for f in changed_files}
+        
+        # 同步文件列表：重新出现的输入文件或编译数据库中的源文件加入分析，已删除的源文件移出分析
+        # （监视目录中新建的其他源文件不加入）
+        known = {os.path.normcase(os.path.abspath(f)) for f in self.files}
+        sources = set(self._input_files)
+        if self.compilation_database:
+            sources.update(os.path.normcase(os.path.abspath(f)) for f in self.compilation_database.source_files())
+        for file_path in changed_files:
+            key = os.path.normcase(os.path.abspath(file_path))
+            if key in sources and key not in known and os.path.exists(file_path):
+                self.files.append(file_path)
+        for file_path in list(self.files):
+            if not os.path.exists(file_path):
+                self.files.remove(file_path)
+                self._tu_cache.pop(file_path, None)
+        
+        affected = [file_path for file_path in self.files if file_path not in self._tu_cache
+                    or self._depends_on(file_path, self._tu_cache[file_path][1], changed)]
+        stable = [file_path for file_path in self.files if file_path not in affected]
+        self.files = stable + affected
+        
+        # 清空缓存后按依赖清单核对预编译头包含的头文件，变更的头文件会重新生成PCH
+        self._pch_cache.clear()
+        temp_dir, parse_log_file = self._initialize_logging()
+        
+        # 快照中的源文件仍是未受影响文件的前缀时从快照继续（快照之后的是最近编辑过的文件，
+        # 不并入快照），否则从头提取未受影响的翻译单元并重新保存快照
+        extracted = list(self._snapshot[0]) if self._snapshot is not None else []
+        restored = self._snapshot is not None and stable[:len(extracted)] == extracted
+        if restored:
+            self._restore_results(self._snapshot[1])
+        else:
+            extracted = []
+            self._reset_results()
+        
+        reextracted = []
+        for file_path in stable[len(extracted):]:
+            # 未受影响的翻译单元：跳过解析，直接提取代码元素
+            args, tu = self._tu_cache[file_path]
+            self._process_translation_unit(tu, file_path, temp_dir, args, parse_log_file)
+            reextracted.append(file_path)
+        if not restored:
+            self._snapshot = (tuple(stable), self._copy_results())
+        
+        for file_path in affected:
+            self._analyze_file(file_path, temp_dir, parse_log_file)
+            reextracted.append(file_path)
+        
+        self._finalize_analysis()
+        return reextracted
+    
+    def _copy_results(self):
+        """提取结果的深拷贝（全局分析之前，结果中没有对分析器和翻译单元的引用）"""
+        return copy.deepcopy({name: getattr(self, name) for name in self._result_attributes}, {id(self): self})
+    
+    def _restore_results(self, snapshot):
+        """从快照恢复提取结果（恢复的是快照的副本，快照本身可以再次使用）"""
+        for name, value in copy.deepcopy(snapshot, {id(self): self}).items():
+            setattr(self, name, value)
+    
+    def _depends_on(self, file_path, tu, changed):
+        """判断翻译单元是否受变更文件影响（源文件本身或其包含的头文件发生了变更）"""
+        if os.path.normcase(os.path.abspath(file_path)) in changed:
+            return True
+        for included in tu.get_includes():
+            if os.path.normcase(os.path.abspath(included.include.name)) in changed:
+                return True
+        return False
+    
+    def _reset_results(self):
+        """清空分析结果（初始化和增量重新分析时调用）"""
+        self.cfg = CompactDiGraph()  # 控制流图
+        self.global_dfg = CompactDiGraph()  # 全局数据流图（函数间）
+        self.symbols = SymbolTable()  # 变量符号表（按USR索引）
+        self.variables = self.symbols  # 变量信息，按限定名访问的符号表视图
+        self.global_vars = set()  # 全局变量（限定名）
+        self.static_vars = set()  # 静态变量（限定名）
+        self.heap_vars = set()  # 堆变量（限定名）
+        self.points_to = PointsToGraph()  # 指针指向约束图
+        self._heap_candidates = {}  # 直接接收分配函数返回值的堆变量候选：符号id -> 符号
+        self.function_calls = []  # 函数调用
+        self.indirect_calls = {}  # 经函数指针的间接调用：(调用位置, 函数指针表达式) -> 调用信息（含解析出的目标函数）
+        self._indirect_call_nodes = {}  # (调用位置, 函数指针表达式) -> (函数指针表达式的值来源, [(实参序号, 调用点实参节点)])
+        self.business_logic = CompactDiGraph()  # 业务逻辑图
+        self.functions = {}
+        self.call_graph = None  # 调用图强连通分量与传递闭包索引
+        self.struct_layouts = StructLayoutAnalyzer(self.options.get('cache_line_size', 64))  # 结构体定义与字段访问
+        self.struct_layout_report = {}  # 结构体布局报告：限定名（文件::结构体名） -> 大小、填充、缓存行与重排建议
+        self.allocation_report = {}  # 循环中和热点路径上的内存分配/释放调用点
+        self.list_traversals = LinkedListTraversalDetector()  # 链表遍历循环
+        self.list_traversal_report = []  # 链表遍历与线性查找报告（含调用者和入口调用频率）
+        self.cost_report = {}  # 函数复杂度估计与各入口函数可达的高代价函数
+        self.shared_state = SharedStateAnalyzer(self.options.get('cache_line_size', 64))  # 线程创建与共享数据访问
+        self.shared_state_report = {}  # 多线程争用数据与伪共享风险报告
+        self.locks = LockAnalyzer(self.options.get('critical_section_lines', 30))  # 加锁、解锁和原子操作调用点
+        self.lock_report = {}  # 锁争用、临界区与锁顺序报告
+        self.blocking_report = {}  # 延迟敏感路径上的阻塞调用
+        self.memory_traffic = MemoryTrafficAnalyzer(self.options.get('cache_line_size', 64))  # 内存访问表达式
+        self.memory_traffic_report = []  # 按缓存未命中压力排序的函数内存访问估计
+        self.escape_report = {}  # 堆分配点的逃逸分类
+        self.memory_lifetime = MemoryLifetimeAnalyzer()  # 分配、释放、指针赋值和分配成功判断
+        self.memory_lifetime_report = {}  # 分配与释放配对、泄漏路径和重复释放
+    
+    def _finalize_analysis(self):
+        """所有翻译单元处理完成后的全局分析"""
+        self._resolve_indirect_calls()
+        self._connect_thread_arguments()
+        self._track_heap_variables()
+        self.call_graph = CallGraphIndex(self.cfg)
+        self.struct_layout_report = self.struct_layouts.analyze(self.functions)
+        self.allocation_report = AllocationAnalyzer(self).analyze()
+        self.list_traversal_report = self.list_traversals.analyze(self)
+        self.cost_report = CostModel(self).analyze()
+        self.shared_state_report = self.shared_state.analyze(self)
+        self.lock_report = self.locks.analyze(self)
+        self.blocking_report = BlockingCallDetector(self).analyze()
+        self.memory_traffic_report = self.memory_traffic.analyze(self)
+        self.escape_report = EscapeAnalyzer(self).analyze()
+        self.memory_lifetime_report = self.memory_lifetime.analyze(self)
+        self._build_business_logic()
+    
+    def _analyze_file(self, file_path, temp_dir, parse_log_file):
+        """解析并分析单个源文件"""
+        # 优先使用编译数据库中的真实编译参数
+        db_args = self.compilation_database.get_args(file_path) if self.compilation_database else None
+        if db_args is not None:
+            args = list(db_args)
+        else:
             # 构建基本编译参数
             args = self._build_basic_compile_args(file_path, parse_log_file)
-            
-            # 记录文件信息和内容
-            self._log_file_info(file_path, args, parse_log_file)
-            
-            # 解析翻译单元
-            try:
+        
+        # 记录文件信息和内容
+        self._log_file_info(file_path, args, parse_log_file)
+        
+        # 解析翻译单元
+        try:
+            if db_args is None:
                 # 添加标准编译选项
                 args = self._add_standard_compile_options(args)
                 
                 # 添加标准库头文件路径
                 args = self._add_standard_include_paths(args, temp_dir, parse_log_file)
-                
-                # 记录最终编译参数
+            else:
                 with open(parse_log_file, 'a', encoding='utf-8') as log_f:
-                    log_f.write(f"最终编译参数: {args}\n")
-                
-                # 解析源文件
-                tu = self._parse_translation_unit(file_path, args, parse_log_file)
-                
-                if tu:
-                    # 处理解析结果
-                    self._process_translation_unit(tu, file_path, temp_dir, args, parse_log_file)
-                else:
-                    error_msg = f"Warning: Failed to parse {file_path}"
-                    print(error_msg)
-                    with open(parse_log_file, 'a', encoding='utf-8') as log_f:
-                        log_f.write(f"{error_msg}\n")
-            except Exception as e:
-                self._handle_parse_exception(e, file_path, args, parse_log_file)
-                continue
-        
-        # 完成分析
-        self._track_heap_variables()
-        self._build_business_logic()
-        return self
+                    log_f.write("使用编译数据库中的编译参数\n")
+            
+            # 使用公共头文件的预编译头（如果配置了precompiled_headers）
+            args = self._add_precompiled_header(args, temp_dir, parse_log_file)
+            
+            # 记录最终编译参数
+            with open(parse_log_file, 'a', encoding='utf-8') as log_f:
+                log_f.write(f"最终编译参数: {args}\n")
+            
+            # 解析源文件
+            tu = self._parse_translation_unit(file_path, args, parse_log_file,
+                                              allow_incomplete=db_args is None)
+            
+            if tu:
+                # 处理解析结果
+                self._process_translation_unit(tu, file_path, temp_dir, args, parse_log_file)
+            else:
+                error_msg = f"Warning: Failed to parse {file_path}"
+                print(error_msg)
+                with open(parse_log_file, 'a', encoding='utf-8') as log_f:
+                    log_f.write(f"{error_msg}\n")
+        except Exception as e:
+            self._handle_parse_exception(e, file_path, args, parse_log_file,
+                                         from_database=db_args is not None)
         
     def _initialize_logging(self):
         """初始化日志和临时目录"""
@@ -117,6 +358,10 @@ class CCodeAnalyzer:
             log_f.write(f"clang模块路径: {clang.__file__}\n")
             log_f.write(f"clang.cindex模块路径: {clang.cindex.__file__}\n\n")
         
+        # 清空代码元素调试文件，避免多次分析（如监视模式）时无限增长
+        for debug_name in ('function_definitions.debug', 'variable_analysis.debug', 'function_calls.debug'):
+            open(os.path.join(temp_dir, debug_name), 'w', encoding='utf-8').close()
+        
         return temp_dir, parse_log_file
         
     def _build_basic_compile_args(self, file_path, parse_log_file):
@@ -240,8 +485,13 @@ class CCodeAnalyzer:
             possible_include_paths = [
                 '/usr/include',
                 '/usr/local/include',
-                '/usr/lib/clang/*/include'
+                '/usr/lib/clang/*/include',
+                '/usr/lib/llvm-*/lib/clang/*/include'
             ]
+            # 未安装clang内置头文件（stdbool.h、stddef.h等）时使用GCC的内置头文件
+            if not any(glob.glob(os.path.join(pattern, 'stdbool.h')) for pattern in possible_include_paths[2:]):
+                possible_include_paths.extend(sorted(glob.glob('/usr/lib/gcc/*/*/include'),
+                                                     key=self._gcc_version_key)[-1:])
             
             for pattern in possible_include_paths:
                 for path in glob.glob(pattern):
@@ -251,18 +501,198 @@ class CCodeAnalyzer:
                             log_f.write(f"添加标准库头文件路径: {path}\n")
         
         return args
+    
+    @staticmethod
+    def _gcc_version_key(path):
+        """GCC内置头文件目录（/usr/lib/gcc/<target>/<version>/include）按版本号数值排序，9排在13之前"""
+        version = os.path.basename(os.path.dirname(path))
+        return tuple(int(part) if part.isdigit() else 0 for part in version.split('.'))
+        
+    def _add_precompiled_header(self, args, temp_dir, parse_log_file):
+        """为precompiled_headers选项中的公共头文件构建预编译头，并通过-include-pch使用
+        
+        预编译头按影响公共头文件内容的参数（宏定义、系统include目录和语言选项）缓存，
+        只有项目include目录不同的翻译单元（如各源文件所在目录）共享同一个PCH文件，
+        避免每个翻译单元重复解析公共头文件。构建失败时返回原参数。
+        """
+        headers = self.options.get('precompiled_headers')
+        if not headers:
+            return args
+        
+        key = self._pch_key(args)
+        if key not in self._pch_cache:
+            self._pch_cache[key] = self._build_precompiled_header(headers, args, key, temp_dir, parse_log_file)
+        
+        pch_path = self._pch_cache[key]
+        if pch_path:
+            args = args + ['-include-pch', pch_path]
+        return args
+    
+    # 带独立值的参数：宏定义、include目录、强制包含和语言
+    PCH_VALUE_FLAGS = ('-D', '-U', '-I', '-iquote', '-isystem', '-idirafter', '-isysroot', '--sysroot',
+                       '-include', '-imacros', '-x', '-target')
+    # 影响头文件解析的语言选项前缀
+    PCH_LANGUAGE_PREFIXES = ('-std=', '-ansi', '-f', '-m', '-O', '--target=', '--sysroot=')
+    
+    def _pch_key(self, args):
+        """预编译头的缓存键：宏定义、系统include目录和语言选项
+        
+        -I/-iquote中的项目目录（项目根目录下，或被分析文件所在目录的上级目录）不计入，
+        否则每个源文件目录都会构建一份相同的PCH。
+        """
+        key = []
+        pending = None
+        for arg in args:
+            if pending is not None:
+                flag, value = pending, arg
+                pending = None
+            elif arg in self.PCH_VALUE_FLAGS or arg == '-include-pch':
+                pending = arg
+                continue
+            else:
+                flag = next((flag for flag in self.PCH_VALUE_FLAGS if arg.startswith(flag) and len(arg) > len(flag)),
+                            None)
+                if flag is None:
+                    if arg.startswith(self.PCH_LANGUAGE_PREFIXES):
+                        key.append(arg)
+                    continue
+                value = arg[len(flag):]
+            if flag == '-include-pch':
+                continue
+            if flag in ('-I', '-iquote') and self._is_project_directory(value):
+                continue
+            key.append(f"{flag}{value}")
+        return tuple(key)
+    
+    def _is_project_directory(self, directory):
+        """include目录是否属于项目：位于项目根目录下，或是被分析文件所在目录的上级目录"""
+        directory = os.path.join(os.path.normcase(os.path.abspath(directory)), '')
+        if self._is_project_file(directory):
+            return True
+        return any(os.path.join(os.path.normcase(os.path.abspath(os.path.dirname(f) or '.')), '').startswith(directory)
+                   for f in self.files)
+    
+    def _build_precompiled_header(self, headers, args, key, temp_dir, parse_log_file):
+        """构建预编译头文件，返回PCH路径，失败时返回None
         
-    def _parse_translation_unit(self, file_path, args, parse_log_file):
-        """解析翻译单元"""
+        headers中的条目可以是头文件路径，也可以是'<stdlib.h>'形式的系统头文件。
+        PCH文件名由头文件、缓存键和头文件修改时间计算得出，内容未变时跨运行复用；
+        构建时把PCH包含的全部头文件及其修改时间写入依赖清单，
+        复用前逐一核对，其中任何头文件（包括被间接包含的系统或项目头文件）变更都会重新构建。
+        """
+        include_lines = []
+        fingerprint = [key]
+        for header in headers:
+            if header.startswith('<'):
+                include_lines.append(f"#include {header}\n")
+                fingerprint.append(header)
+            else:
+                header_path = os.path.abspath(header)
+                include_lines.append(f'#include "{header_path}"\n')
+                mtime = os.path.getmtime(header_path) if os.path.exists(header_path) else None
+                fingerprint.append((header_path, mtime))
+        
+        digest = hashlib.sha1(repr(fingerprint).encode('utf-8')).hexdigest()[:16]
+        umbrella_path = os.path.join(temp_dir, f'pch_{digest}.h')
+        pch_path = os.path.join(temp_dir, f'pch_{digest}.pch')
+        deps_path = os.path.join(temp_dir, f'pch_{digest}.deps.json')
+        
+        if os.path.exists(pch_path):
+            stale = self._stale_pch_dependency(deps_path)
+            if stale is None:
+                with open(parse_log_file, 'a', encoding='utf-8') as log_f:
+                    log_f.write(f"复用预编译头: {pch_path}\n")
+                return pch_path
+            with open(parse_log_file, 'a', encoding='utf-8') as log_f:
+                log_f.write(f"预编译头已过期（{stale}），重新构建: {pch_path}\n")
+        
+        try:
+            with open(umbrella_path, 'w', encoding='utf-8') as f:
+                f.write("// 自动生成的预编译头入口文件\n")
+                f.writelines(include_lines)
+            
+            options = clang.cindex.TranslationUnit.PARSE_INCOMPLETE | \
+                      clang.cindex.TranslationUnit.PARSE_DETAILED_PROCESSING_RECORD
+            pch_tu = self.index.parse(umbrella_path, args + ['-x', 'c-header'], options=options)
+            
+            errors = [diag for diag in pch_tu.diagnostics if diag.severity >= clang.cindex.Diagnostic.Error]
+            if errors:
+                with open(parse_log_file, 'a', encoding='utf-8') as log_f:
+                    log_f.write(f"预编译头存在错误，不使用预编译头: {[str(diag) for diag in errors]}\n")
+                return None
+            
+            pch_tu.save(pch_path)
+            dependencies = {umbrella_path: os.path.getmtime(umbrella_path)}
+            for included in pch_tu.get_includes():
+                name = os.path.abspath(included.include.name)
+                if name not in dependencies and os.path.exists(name):
+                    dependencies[name] = os.path.getmtime(name)
+            with open(deps_path, 'w', encoding='utf-8') as f:
+                json.dump(dependencies, f)
+        except Exception as e:
+            with open(parse_log_file, 'a', encoding='utf-8') as log_f:
+                log_f.write(f"构建预编译头失败: {e}\n")
+            return None
+        
+        with open(parse_log_file, 'a', encoding='utf-8') as log_f:
+            log_f.write(f"构建预编译头: {pch_path} (包含 {len(headers)} 个头文件)\n")
+        return pch_path
+    
+    @staticmethod
+    def _stale_pch_dependency(deps_path):
+        """返回预编译头依赖清单中已变更或删除的第一个头文件，全部未变时返回None"""
+        try:
+            with open(deps_path, 'r', encoding='utf-8') as f:
+                dependencies = json.load(f)
+        except (OSError, ValueError):
+            return deps_path
+        for name, mtime in dependencies.items():
+            if not os.path.exists(name) or os.path.getmtime(name) != mtime:
+                return name
+        return None
+    
+    def _parse_translation_unit(self, file_path, args, parse_log_file, allow_incomplete=True):
+        """解析翻译单元
+        
+        启用reuse_preamble选项时，翻译单元按文件缓存并生成预编译前导（preamble），
+        再次解析同一文件且编译参数不变时使用reparse，跳过头文件部分的解析。
+        allow_incomplete为False时（编译参数来自编译数据库）解析失败不再用宽松选项重试。
+        """
         # 使用详细的解析选项
         options = clang.cindex.TranslationUnit.PARSE_DETAILED_PROCESSING_RECORD
         
+        reuse_preamble = self.options.get('reuse_preamble', False)
+        if reuse_preamble:
+            options |= clang.cindex.TranslationUnit.PARSE_PRECOMPILED_PREAMBLE | self.PARSE_CREATE_PREAMBLE_ON_FIRST_PARSE
+            cached = self._tu_cache.get(file_path)
+            if cached is not None and cached[0] == args:
+                try:
+                    cached[1].reparse()
+                    with open(parse_log_file, 'a', encoding='utf-8') as log_f:
+                        log_f.write("复用已缓存的翻译单元（reparse）\n")
+                    return cached[1]
+                except Exception as e:
+                    with open(parse_log_file, 'a', encoding='utf-8') as log_f:
+                        log_f.write(f"reparse失败，重新解析: {e}\n")
+                    del self._tu_cache[file_path]
+        
+        tu = self._parse_with_fallback(file_path, args, options, parse_log_file, allow_incomplete)
+        if reuse_preamble and tu:
+            self._tu_cache[file_path] = (list(args), tu)
+        return tu
+    
+    def _parse_with_fallback(self, file_path, args, options, parse_log_file, allow_incomplete=True):
+        """使用给定选项解析，失败时改用更宽松的解析选项"""
         # 尝试使用不同的解析选项
         try:
             with open(parse_log_file, 'a', encoding='utf-8') as log_f:
                 log_f.write("尝试使用标准解析选项...\n")
             tu = self.index.parse(file_path, args, options=options)
         except Exception as e1:
+            if not allow_incomplete:
+                with open(parse_log_file, 'a', encoding='utf-8') as log_f:
+                    log_f.write(f"使用编译数据库参数解析失败: {e1}\n")
+                raise
             with open(parse_log_file, 'a', encoding='utf-8') as log_f:
                 log_f.write(f"标准解析失败: {e1}\n")
                 log_f.write("尝试使用更宽松的解析选项...\n")
@@ -372,23 +802,86 @@ class CCodeAnalyzer:
             
             # 检查是否存在未解析的符号
             log_f.write("\n检查未解析的符号...\n")
-            self._check_unresolved_symbols(tu.cursor, log_f)
+            for child in self._select_top_level_cursors(tu)[0]:
+                self._check_unresolved_symbols(child, log_f)
     
     def _process_translation_unit(self, tu, file_path, temp_dir, args, parse_log_file):
         """处理解析成功的翻译单元"""  
         # 处理诊断信息和未解析符号
         self._process_diagnostics(tu, file_path, args, parse_log_file)
-        ast_debug_file = os.path.join(temp_dir, f'{os.path.basename(file_path)}.ast.debug')
-        with open(ast_debug_file, 'w', encoding='utf-8') as f:
-            self._dump_ast(tu.cursor, f)
-        print(f"{tu.cursor.spelling} AST generated at {ast_debug_file}")   
+        # 生成AST调试文件（可选）
+        if self.options.get('dump_ast'):
+            self._dump_ast(tu, file_path, temp_dir)
+        # 选择需要分析的顶层声明（跳过系统头文件等非项目文件）
+        project_cursors, external_decls = self._select_top_level_cursors(tu)
         # 解析代码元素
-        self._parse_code_elements(tu.cursor)
-        # 构建控制流图、数据流图
-        self._build_cfg_dfg(tu.cursor)
+        for child in project_cursors:
+            self._parse_code_elements(child)
+        # 构建控制流图、数据流图（与从翻译单元根节点递归时一致，跳过顶层函数声明）
+        for child in project_cursors:
+            if child.kind != clang.cindex.CursorKind.FUNCTION_DECL:
+                self._build_cfg_dfg(child)
+        # 'called'模式下只保留实际被调用的外部函数声明
+        if external_decls:
+            called_funcs = {call_info['function'] for call_info in self.function_calls}
+            for child in external_decls:
+                if child.spelling in called_funcs:
+                    self._parse_code_elements(child)
+    
+    def _select_top_level_cursors(self, tu):
+        """按header_filter选项筛选翻译单元的顶层游标
+        
+        header_filter取值：
+            'all': 分析所有顶层声明（包括系统头文件）
+            'project': 只分析项目文件中的声明（默认）
+            'called': 同'project'，另外保留项目代码实际调用的外部函数声明
+        Returns:
+            (项目游标列表, 待按调用关系筛选的外部函数声明列表)
+        """
+        mode = self.options.get('header_filter', 'project')
+        children = list(tu.cursor.get_children())
+        if mode == 'all':
+            return children, []
+        
+        project_cursors = []
+        external_decls = []
+        for child in children:
+            location_file = child.location.file
+            if location_file is not None and self._is_project_file(location_file.name):
+                project_cursors.append(child)
+            elif mode == 'called' and child.kind == clang.cindex.CursorKind.FUNCTION_DECL:
+                external_decls.append(child)
+        return project_cursors, external_decls
+    
+    def _is_project_file(self, file_name):
+        """判断文件是否位于项目根目录下
+        
+        项目根目录默认为被分析文件所在目录、配置的include_paths，以及编译数据库中
+        位于数据库目录或源文件公共根目录下的-I/-iquote目录（第三方目录如/usr/include/glib-2.0不计入），
+        可通过project_roots选项（命令行--project-root）覆盖。判断结果按文件名缓存。
+        """
+        cached = self._project_file_cache.get(file_name)
+        if cached is not None:
+            return cached
+        
+        if self._project_roots is None:
+            roots = self.options.get('project_roots')
+            if not roots:
+                roots = [os.path.dirname(f) or '.' for f in self.files] + list(self.include_paths)
+                if self.compilation_database:
+                    roots += self.compilation_database.include_directories(self.files)
+            self._project_roots = tuple({os.path.join(os.path.normcase(os.path.abspath(root)), '') for root in roots})
+        
+        path = os.path.normcase(os.path.abspath(file_name))
+        result = path.startswith(self._project_roots)
+        self._project_file_cache[file_name] = result
+        return result
     
-    def _handle_parse_exception(self, e, file_path, args, parse_log_file):
-        """处理解析过程中的异常"""
+    def _handle_parse_exception(self, e, file_path, args, parse_log_file, from_database=False):
+        """处理解析过程中的异常
+        
+        编译参数来自编译数据库时include路径是准确的，不再进行timer相关的include路径排查。
+        """
         error_msg = f"Error parsing {file_path}: {e}"
         print(error_msg)
         
@@ -408,7 +901,7 @@ class CCodeAnalyzer:
             log_f.write(f"错误repr表示: {repr(e)}\n")
             
             # 特别处理'timer'相关错误
-            if 'timer' in str(e).lower():
+            if not from_database and 'timer' in str(e).lower():
                 log_f.write("\n[发现timer相关错误!]\n")
                 log_f.write("进行深入分析...\n")
                 
@@ -477,63 +970,26 @@ class CCodeAnalyzer:
                 log_f.write("4. 尝试使用绝对路径而不是相对路径\n")
                 log_f.write("5. 检查timer.h和timer.c中的结构体定义是否一致\n")
     
-    def _dump_ast(self, cursor, file, level=0):
-        # 生成AST调试文件
-        """将AST节点信息输出到文件,不进行相关分析"""
-        # 输出当前节点信息
-        indent = '  ' * level
-        file.write(f"{indent}Node: {cursor.kind.name}\n")
-        file.write(f"{indent}Spelling: {cursor.spelling}\n")
-        
-        # 添加更详细的位置信息
-        location_info = "未知位置"
-        if cursor.location.file:
-            location_info = f"{cursor.location.file}:{cursor.location.line}:{cursor.location.column}"
-        file.write(f"{indent}Location: {location_info}\n")
-        
-        # 添加类型信息和更多详细信息
-        file.write(f"{indent}Type: {cursor.type.spelling}\n")
-        file.write(f"{indent}Type Kind: {cursor.type.kind}\n")
-        file.write(f"{indent}Canonical Type: {cursor.type.get_canonical().spelling}\n")
-        
-        # 如果是函数定义，输出更多详细信息
-        if cursor.kind == clang.cindex.CursorKind.FUNCTION_DECL:
-            file.write(f"{indent}Is Definition: {cursor.is_definition()}\n")
-            file.write(f"{indent}Return Type: {cursor.result_type.spelling}\n")
-            file.write(f"{indent}Parameters:\n")
-            for param in cursor.get_arguments():
-                file.write(f"{indent}  - {param.spelling}: {param.type.spelling}\n")
-            
-            # 添加函数体信息
-            has_body = False
-            for child in cursor.get_children():
-                if child.kind == clang.cindex.CursorKind.COMPOUND_STMT:
-                    has_body = True
-                    break
-            file.write(f"{indent}Has Body: {has_body}\n")
-        
-        # 如果是包含指令，输出更多详细信息
-        elif cursor.kind == clang.cindex.CursorKind.INCLUSION_DIRECTIVE:
-            try:
-                included_file = cursor.get_included_file()
-                if included_file:
-                    file.write(f"{indent}Included File: {included_file}\n")
-                else:
-                    file.write(f"{indent}Included File: 未找到 (可能是标准库或路径问题)\n")
-            except Exception as e:
-                file.write(f"{indent}Included File: 获取失败 ({str(e)})\n")
-            file.write(f"{indent}Include Path: {cursor.displayname}\n")
+    def _dump_ast(self, tu, file_path, temp_dir):
+        """按配置生成AST调试文件（默认关闭）"""
+        fmt = self.options.get('dump_ast')
+        if fmt is True:
+            fmt = 'text'
         
-        # 如果是变量声明，输出更多详细信息
-        elif cursor.kind == clang.cindex.CursorKind.VAR_DECL:
-            file.write(f"{indent}Storage Class: {cursor.storage_class}\n")
-            file.write(f"{indent}Is Global: {cursor.semantic_parent.kind == clang.cindex.CursorKind.TRANSLATION_UNIT}\n")
-        
-        file.write("\n")
-        
-        # 递归处理子节点
-        for child in cursor.get_children():
-            self._dump_ast(child, file, level + 1)
+        suffix = 'ast.jsonl' if fmt == 'jsonl' else 'ast.debug'
+        ast_debug_file = os.path.join(temp_dir, f'{os.path.basename(file_path)}.{suffix}')
+        dumper = AstDumper(
+            ast_debug_file,
+            fmt=fmt,
+            main_file_only=self.options.get('ast_dump_main_file_only', True),
+            max_depth=self.options.get('ast_dump_max_depth'),
+            kinds=self.options.get('ast_dump_kinds'),
+            max_nodes=self.options.get('ast_dump_max_nodes'),
+            background=self.options.get('ast_dump_background', True),
+            compress=self.options.get('ast_dump_compress', False)
+        )
+        node_count = dumper.dump(tu)
+        print(f"{tu.cursor.spelling} AST generated at {dumper.output_file} ({node_count} nodes{', truncated' if dumper.truncated else ''})")
 
     def _parse_code_elements(self, cursor, parent_func=None):
         """递归查找所有代码元素，包括函数声明、变量声明和函数调用"""
@@ -551,6 +1007,33 @@ class CCodeAnalyzer:
             self._process_function_call(cursor, call_debug_file, parent_func)
         elif cursor.kind == clang.cindex.CursorKind.BINARY_OPERATOR and parent_func:
             self._process_data_flow(cursor, parent_func)
+        elif cursor.kind in (clang.cindex.CursorKind.STRUCT_DECL, clang.cindex.CursorKind.UNION_DECL):
+            if cursor.is_definition():
+                self.struct_layouts.add_record(cursor)
+        elif cursor.kind == clang.cindex.CursorKind.MEMBER_REF_EXPR and parent_func:
+            self.struct_layouts.add_access(cursor, parent_func)
+        elif cursor.kind in LOOP_KINDS and parent_func:
+            self.list_traversals.add_loop(cursor, parent_func)
+        elif cursor.kind == clang.cindex.CursorKind.IF_STMT and parent_func:
+            # 判断分配或调用是否成功的条件，泄漏路径分析中不计失败的分支
+            condition = next(cursor.get_children(), None)
+            if condition is not None:
+                self.memory_lifetime.add_condition(parent_func, condition,
+                                                   lambda expr: self._pointer_sources(expr, parent_func))
+        elif cursor.kind == clang.cindex.CursorKind.UNEXPOSED_EXPR and parent_func:
+            self._process_atomic_builtin(cursor, parent_func)
+        
+        # 记录全局变量和结构体字段的读写，用于多线程共享数据分析
+        if parent_func and cursor.kind in self.SHARED_ACCESS_KINDS:
+            self._record_shared_access(cursor, parent_func)
+        
+        # 统计经指针的读写和依赖链，用于估计函数的内存访问量
+        if parent_func and cursor.kind in self.MEMORY_ACCESS_KINDS:
+            self._record_memory_access(cursor, parent_func)
+        
+        # 收集指针指向约束
+        if cursor.kind in self.POINTER_CONSTRAINT_KINDS:
+            self._collect_pointer_constraints(cursor, parent_func)
         
         # 递归处理子节点
         for child in cursor.get_children():
@@ -580,68 +1063,42 @@ class CCodeAnalyzer:
         
         # 如果是函数定义且有函数体
         if is_def and has_body:
+            # 先把函数参数登记到符号表，函数体中的引用才能解析到参数
+            for index, param in enumerate(cursor.get_arguments()):
+                symbol = self.symbols.declare(param, func_name)
+                # 调用点传入的实参经由形参节点流入参数变量
+                if self._is_pointer_type(param.type):
+                    self.points_to.add_copy(self._param_node(func_name, index), self._symbol_node(symbol))
+            
             self._process_function_definition(cursor, func_name)
             
             # 添加函数节点到控制流图
             self.cfg.add_node(func_name, type='function', id=func_name, location=f"{cursor.location.file}:{cursor.location.line}:{cursor.location.column}")
-            
-            # 处理函数参数，添加到数据流图
-            for param in cursor.get_arguments():
-                param_name = param.spelling
-                param_type = param.type.spelling
-                if param_name not in self.variables:
-                    self.variables[param_name] = {
-                        'type': param_type,
-                        'storage': 'StorageClass.NONE',
-                        'location': f"{param.location.file}:{param.location.line}:{param.location.column}",
-                        'is_pointer': '*' in param_type,
-                        'references': [],
-                        'is_global': False,
-                        'is_static': False,
-                        'is_heap': False,
-                        'parent_function': func_name
-                    }
         else:
             self._process_function_declaration_only(cursor, func_name)
     
     def _check_function_has_body(self, cursor):
         """检查函数是否有函数体"""
         has_body = False
-        # 调试特定函数
-        is_timer_pause = cursor.spelling == "timer_pause"
-        
         if cursor.is_definition():
-            # 如果是timer_pause函数,打印调试信息
-
             # 遍历所有子节点查找函数体相关节点
             for child in cursor.get_children():
                 # 检查复合语句(标准函数体)
                 if child.kind == clang.cindex.CursorKind.COMPOUND_STMT:
                     has_body = True
-                    if is_timer_pause:
-                        print("Found COMPOUND_STMT body")
                     break
                 # 检查内联函数体
                 elif child.kind == clang.cindex.CursorKind.UNEXPOSED_EXPR:
                     for subchild in child.get_children():
-                        if is_timer_pause:
-                            print(f"  Subnode kind: {subchild.kind}")
                         if subchild.kind == clang.cindex.CursorKind.COMPOUND_STMT:
                             has_body = True
-                            if is_timer_pause:
-                                print("Found inline function body")
                             break
                 # 检查宏展开的函数体
                 elif child.kind == clang.cindex.CursorKind.MACRO_INSTANTIATION:
                     has_body = True
-                    if is_timer_pause:
-                        print("Found macro body")
                     break
                 if has_body:
                     break
-
-            if is_timer_pause:
-                print(f"Has body: {has_body}\n")
                 
         return has_body
     
@@ -659,12 +1116,14 @@ class CCodeAnalyzer:
             'location': f"{cursor.location.file}:{cursor.location.line}:{cursor.location.column}",
             'is_declaration': False,
             'has_body': True,
-            'local_dfg': nx.DiGraph(),  # 函数内部数据流图
+            'local_dfg': CompactDiGraph(),  # 函数内部数据流图
             'side_effects': {  # 函数副作用
                 'global_vars_read': set(),  # 读取的全局变量
                 'global_vars_write': set(),  # 写入的全局变量
                 'file_operations': [],  # 文件操作
-                'heap_operations': []  # 堆内存操作
+                'network_operations': [],  # 网络操作
+                'heap_operations': [],  # 堆内存操作
+                'sync_operations': []  # 加锁、解锁、条件等待和原子操作
             }
         }
         
@@ -690,6 +1149,9 @@ class CCodeAnalyzer:
         # 递归处理函数体
         for child in cursor.get_children():
             self._parse_code_elements(child, func_name)
+        
+        # 构建函数内部的语句级控制流图（基本块、分支边和循环）
+        func_info['block_cfg'] = FunctionCFGBuilder().build(cursor)
     
     def _process_function_declaration_only(self, cursor, func_name):
         """处理函数声明（非定义）"""
@@ -715,6 +1177,10 @@ class CCodeAnalyzer:
     def _process_function_call(self, cursor, debug_file, parent_func):
         """处理函数调用表达式"""
         called_func = cursor.spelling
+        indirect = self._is_indirect_call(cursor)
+        if indirect and not called_func:
+            # (*fp)(...)等没有名称的间接调用，以函数指针表达式的源码作为名称
+            called_func = callee_text(cursor)
         
         if not called_func or not parent_func:
             return
@@ -729,8 +1195,29 @@ class CCodeAnalyzer:
                 f.write(f"  - {arg.spelling}\n")
             f.write("---\n")
         
-        # 添加函数调用边到控制流图
-        self.cfg.add_edge(parent_func, called_func)
+        # 添加函数调用边到控制流图（间接调用的边在指针分析求解后按实际目标添加）
+        if not indirect:
+            self.cfg.add_edge(parent_func, called_func)
+        
+        # 线程创建：线程函数经指针分析解析，作为共享数据分析的线程入口
+        thread_args = THREAD_CREATE_FUNCTIONS.get(called_func) if not indirect else None
+        if thread_args is not None:
+            call_args = list(cursor.get_arguments())
+            routine_index, argument_index = thread_args
+            if argument_index < len(call_args):
+                self.shared_state.add_thread_creation(
+                    parent_func, cursor.location.line,
+                    f"{cursor.location.file}:{cursor.location.line}:{cursor.location.column}",
+                    self._pointer_sources(call_args[routine_index], parent_func),
+                    self._pointer_sources(call_args[argument_index], parent_func))
+        
+        # 分配大小与释放调用，用于配对分配和释放
+        if not indirect and called_func in SIZE_ARGUMENTS:
+            self.memory_lifetime.add_allocation(parent_func, cursor)
+        if not indirect and called_func in RELEASE_FUNCTIONS:
+            pointer = next(iter(cursor.get_arguments()), None)
+            if pointer is not None:
+                self.memory_lifetime.add_free(parent_func, cursor, self._pointer_sources(pointer, parent_func))
         
         # 记录函数调用信息
         call_info = {
@@ -747,8 +1234,24 @@ class CCodeAnalyzer:
         
         # 分析函数调用参数
         args = list(cursor.get_arguments())
-        for arg in args:
-            if arg.kind == clang.cindex.CursorKind.UNEXPOSED_EXPR:
+        for index, arg in enumerate(args):
+            symbol = self.symbols.resolve(arg)
+            if symbol is not None:
+                # 处理变量参数（包括隐式转换包裹的变量引用）
+                var_name = symbol.qualified_name
+                call_info['arguments'].append(symbol.name)
+                # 添加到函数内部数据流图
+                if parent_func in self.functions:
+                    self.functions[parent_func]['local_dfg'].add_edge(var_name, call_node, type='argument')
+                
+                # 记录变量引用
+                symbol.add_reference('argument', called_func, index, arg)
+                
+                # 如果参数是全局变量，记录为函数副作用
+                if symbol.is_global_or_static:
+                    if parent_func in self.functions:
+                        self.functions[parent_func]['side_effects']['global_vars_read'].add(var_name)
+            elif arg.kind == clang.cindex.CursorKind.UNEXPOSED_EXPR:
                 # 处理字面量参数
                 for child in arg.get_children():
                     if child.kind == clang.cindex.CursorKind.STRING_LITERAL:
@@ -765,30 +1268,9 @@ class CCodeAnalyzer:
                             literal_node = f"LITERAL:integer"
                             self.functions[parent_func]['local_dfg'].add_node(literal_node, type='literal')
                             self.functions[parent_func]['local_dfg'].add_edge(literal_node, call_node, type='argument')
-            elif arg.kind == clang.cindex.CursorKind.DECL_REF_EXPR:
-                # 处理变量参数
-                var_name = arg.spelling
-                call_info['arguments'].append(var_name)
-                if var_name in self.variables:
-                    # 添加到函数内部数据流图
-                    if parent_func in self.functions:
-                        self.functions[parent_func]['local_dfg'].add_edge(var_name, call_node, type='argument')
-                    
-                    # 记录变量引用
-                    self.variables[var_name]['references'].append({
-                        'function': called_func,
-                        'as_argument': True,
-                        'location': f"{arg.location.file}:{arg.location.line}:{arg.location.column}"
-                    })
-                    
-                    # 如果参数是全局变量，记录为函数副作用
-                    if var_name in self.global_vars or var_name in self.static_vars:
-                        if parent_func in self.functions:
-                            self.functions[parent_func]['side_effects']['global_vars_read'].add(var_name)
         
         # 检查是否是文件操作函数
-        file_op_patterns = ['fopen', 'fclose', 'fread', 'fwrite', 'fprintf', 'fscanf', 'fseek', 'ftell', 'rewind', 'fflush']
-        if any(pattern in called_func for pattern in file_op_patterns):
+        if any(pattern in called_func for pattern in self.FILE_OP_PATTERNS):
             # 记录文件操作作为函数副作用
             if parent_func in self.functions:
                 operation_type = 'read' if any(op in called_func for op in ['read', 'scan', 'tell', 'seek', 'rewind']) else 'write'
@@ -806,8 +1288,7 @@ class CCodeAnalyzer:
                 self.functions[parent_func]['local_dfg'].add_edge(call_node, file_op_node, type='performs')
         
         # 检查是否是网络操作函数
-        network_op_patterns = ['socket', 'connect', 'bind', 'listen', 'accept', 'send', 'recv', 'sendto', 'recvfrom']
-        if any(pattern in called_func for pattern in network_op_patterns):
+        if any(pattern in called_func for pattern in self.NETWORK_OP_PATTERNS):
             # 记录网络操作作为函数副作用
             if parent_func in self.functions:
                 operation_type = 'receive' if any(op in called_func for op in ['recv', 'accept']) else 'send'
@@ -823,14 +1304,36 @@ class CCodeAnalyzer:
                 self.functions[parent_func]['local_dfg'].add_node(network_op_node, type='network_operation')
                 self.functions[parent_func]['local_dfg'].add_edge(call_node, network_op_node, type='performs')
         
+        # 检查是否是同步操作（互斥锁、读写锁、自旋锁、条件变量和原子操作）
+        sync = sync_operation(called_func) if not indirect else None
+        if sync is not None and parent_func in self.functions:
+            operation_type, primitive, lock_index = sync
+            if lock_index < len(args):
+                lock_label, lock_sources = self._lock_argument(args[lock_index], parent_func)
+                self.locks.add_operation(parent_func, called_func, cursor.location.line, cursor.location.column,
+                                         call_info['location'], lock_label, lock_sources)
+                self.functions[parent_func]['side_effects']['sync_operations'].append({
+                    'operation': operation_type,
+                    'primitive': primitive,
+                    'target': lock_label,
+                    'location': call_info['location']
+                })
+                
+                # 添加同步操作节点到函数内部数据流图
+                sync_op_node = f"SYNC:{operation_type}"
+                self.functions[parent_func]['local_dfg'].add_node(sync_op_node, type='sync_operation')
+                self.functions[parent_func]['local_dfg'].add_edge(call_node, sync_op_node, type='performs')
+        
         # 记录返回值
+        return_symbol = None
         parent = cursor.semantic_parent
         while parent:
             if parent.kind == clang.cindex.CursorKind.VAR_DECL:
                 call_info['return_value'] = parent.spelling
+                return_symbol = self.symbols.lookup(parent)
                 # 如果返回值赋给了变量，添加到数据流图
-                if 'return_value' in call_info and call_info['return_value'] in self.variables:
-                    return_var = call_info['return_value']
+                if return_symbol is not None:
+                    return_var = return_symbol.qualified_name
                     
                     # 添加到函数内部数据流图
                     if parent_func in self.functions:
@@ -842,12 +1345,20 @@ class CCodeAnalyzer:
                         self.functions[parent_func]['local_dfg'].add_edge(call_node, output_node, type='produces')
                     
                     # 如果返回值是全局变量，记录为函数副作用
-                    if return_var in self.global_vars or return_var in self.static_vars:
+                    if return_symbol.is_global_or_static:
                         if parent_func in self.functions:
                             self.functions[parent_func]['side_effects']['global_vars_write'].add(return_var)
                 break
             parent = parent.semantic_parent
         
+        if indirect:
+            # 经函数指针调用：被调用的名称是字段或变量名而不是函数，目标函数由_resolve_indirect_calls解析
+            call_info['indirect'] = True
+            call_info['callee_type'] = self._callee_type(cursor)
+            call_info['targets'] = []
+            self.indirect_calls[self._indirect_call_key(cursor)] = call_info
+            return
+        
         # 添加到函数调用列表
         self.function_calls.append(call_info)
         
@@ -862,25 +1373,8 @@ class CCodeAnalyzer:
             })
             
         # 检查是否是内存分配函数
-        memory_alloc_patterns = ['malloc', 'calloc', 'realloc', 'aligned_alloc', 'valloc', 'pvalloc', 'alloc', 'new', 'create', 'dup', 'clone', 'copy']
-        is_memory_alloc = False
-        
-        # 检查是否是标准内存分配函数
-        if called_func in ['malloc', 'calloc', 'realloc', 'aligned_alloc', 'valloc', 'pvalloc']:
-            is_memory_alloc = True
-        else:
-            # 检查是否是自定义内存分配函数
-            called_func_lower = called_func.lower()
-            for pattern in memory_alloc_patterns:
-                if pattern in called_func_lower:
-                    is_memory_alloc = True
-                    break
-                    
-        if is_memory_alloc and 'return_value' in call_info:
-            var_name = call_info['return_value']
-            if var_name in self.variables:
-                self.heap_vars.add(var_name)
-                self.variables[var_name]['is_heap'] = True
+        if called_func in self.allocation_functions and return_symbol is not None:
+            self._mark_heap_candidate(return_symbol)
                 
     def _process_data_flow(self, cursor, parent_func):
         """处理数据流相关的表达式，如赋值操作"""
@@ -896,135 +1390,612 @@ class CCodeAnalyzer:
                 break
         
         if lhs and rhs and parent_func and parent_func in self.functions:
+            local_dfg = self.functions[parent_func]['local_dfg']
+            side_effects = self.functions[parent_func]['side_effects']
+            # 赋值的左侧是不经隐式转换的变量引用（比较等运算的操作数会被包裹一层UNEXPOSED_EXPR）
+            lhs_symbol = self.symbols.resolve(lhs) if lhs.kind == clang.cindex.CursorKind.DECL_REF_EXPR else None
+            
             # 处理左侧是变量引用的情况
-            if lhs.kind == clang.cindex.CursorKind.DECL_REF_EXPR:
-                lhs_name = lhs.spelling
+            if lhs_symbol is not None:
+                lhs_name = lhs_symbol.qualified_name
+                rhs_symbol = self.symbols.resolve(rhs)
                 
-                # 记录变量赋值信息
-                if lhs_name in self.variables:
-                    # 检查右侧是否是变量引用
-                    if rhs.kind == clang.cindex.CursorKind.DECL_REF_EXPR:
-                        rhs_name = rhs.spelling
-                        if rhs_name in self.variables:
-                            # 检查是否是全局变量或静态变量
-                            lhs_is_global = lhs_name in self.global_vars or lhs_name in self.static_vars
-                            rhs_is_global = rhs_name in self.global_vars or rhs_name in self.static_vars
-                            
-                            # 添加到函数内部数据流图
-                            self.functions[parent_func]['local_dfg'].add_edge(rhs_name, lhs_name, type='assignment')
-                            
-                            # 如果涉及全局变量，记录为函数副作用
-                            if rhs_is_global:
-                                self.functions[parent_func]['side_effects']['global_vars_read'].add(rhs_name)
-                            if lhs_is_global:
-                                self.functions[parent_func]['side_effects']['global_vars_write'].add(lhs_name)
-                                
-                            # 如果是全局变量间的数据流，也添加到全局数据流图
-                            if lhs_is_global or rhs_is_global:
-                                self.global_dfg.add_edge(rhs_name, lhs_name, type='assignment', via_function=parent_func)
-                            
-                            # 记录变量引用
-                            self.variables[rhs_name]['references'].append({
-                                'assigned_to': lhs_name,
-                                'location': f"{rhs.location.file}:{rhs.location.line}:{rhs.location.column}",
-                                'in_function': parent_func
-                            })
+                # 检查右侧是否是变量引用
+                if rhs_symbol is not None:
+                    rhs_name = rhs_symbol.qualified_name
                     
-                    # 检查右侧是否是函数调用
-                    elif rhs.kind == clang.cindex.CursorKind.CALL_EXPR:
-                        called_func = rhs.spelling
-                        # 添加函数调用节点到函数内部数据流图
-                        call_node = f"CALL:{called_func}"
-                        self.functions[parent_func]['local_dfg'].add_node(call_node, type='call')
-                        self.functions[parent_func]['local_dfg'].add_edge(call_node, lhs_name, type='return')
-                        
-                        # 分析函数调用参数
-                        for arg in rhs.get_arguments():
-                            if arg.kind == clang.cindex.CursorKind.DECL_REF_EXPR:
-                                arg_name = arg.spelling
-                                if arg_name in self.variables:
-                                    # 添加参数到函数调用的数据流
-                                    self.functions[parent_func]['local_dfg'].add_edge(arg_name, call_node, type='argument')
-                                    
-                                    # 如果参数是全局变量，记录为函数副作用
-                                    if arg_name in self.global_vars or arg_name in self.static_vars:
-                                        self.functions[parent_func]['side_effects']['global_vars_read'].add(arg_name)
+                    # 添加到函数内部数据流图
+                    local_dfg.add_edge(rhs_name, lhs_name, type='assignment')
                     
-                    # 检查右侧是否是内存分配
-                    elif self._check_heap_allocation(rhs):
-                        self.heap_vars.add(lhs_name)
-                        self.variables[lhs_name]['is_heap'] = True
-                        
-                        # 记录堆内存操作作为函数副作用
-                        self.functions[parent_func]['side_effects']['heap_operations'].append({
-                            'operation': 'allocation',
-                            'variable': lhs_name,
-                            'location': f"{lhs.location.file}:{lhs.location.line}:{lhs.location.column}"
-                        })
+                    # 如果涉及全局变量，记录为函数副作用
+                    if rhs_symbol.is_global_or_static:
+                        side_effects['global_vars_read'].add(rhs_name)
+                    if lhs_symbol.is_global_or_static:
+                        side_effects['global_vars_write'].add(lhs_name)
                         
-                        # 添加堆内存分配节点到函数内部数据流图
-                        heap_node = f"HEAP:allocation"
-                        self.functions[parent_func]['local_dfg'].add_node(heap_node, type='heap_operation')
-                        self.functions[parent_func]['local_dfg'].add_edge(heap_node, lhs_name, type='allocation')
+                    # 如果是全局变量间的数据流，也添加到全局数据流图
+                    if lhs_symbol.is_global_or_static or rhs_symbol.is_global_or_static:
+                        self.global_dfg.add_edge(rhs_name, lhs_name, type='assignment', via_function=parent_func)
                     
-                    # 处理字面量赋值
-                    elif rhs.kind == clang.cindex.CursorKind.INTEGER_LITERAL or \
-                         rhs.kind == clang.cindex.CursorKind.FLOATING_LITERAL or \
-                         rhs.kind == clang.cindex.CursorKind.STRING_LITERAL or \
-                         rhs.kind == clang.cindex.CursorKind.CHARACTER_LITERAL:
-                        # 添加字面量节点到函数内部数据流图
-                        literal_node = f"LITERAL:{rhs.kind}"
-                        self.functions[parent_func]['local_dfg'].add_node(literal_node, type='literal')
-                        self.functions[parent_func]['local_dfg'].add_edge(literal_node, lhs_name, type='assignment')
-                        
-                        # 如果左侧是全局变量，记录为函数副作用
-                        if lhs_name in self.global_vars or lhs_name in self.static_vars:
-                            self.functions[parent_func]['side_effects']['global_vars_write'].add(lhs_name)
+                    # 记录变量引用
+                    rhs_symbol.add_reference('assignment', parent_func, lhs_name, rhs)
+                
+                # 检查右侧是否是函数调用
+                elif rhs.kind == clang.cindex.CursorKind.CALL_EXPR:
+                    called_func = rhs.spelling
+                    # 添加函数调用节点到函数内部数据流图
+                    call_node = f"CALL:{called_func}"
+                    local_dfg.add_node(call_node, type='call')
+                    local_dfg.add_edge(call_node, lhs_name, type='return')
                     
-                    # 处理复杂表达式
-                    elif self._find_call_expr(rhs):
-                        # 函数调用的返回值赋给变量，在_process_function_call中处理
-                        pass
-                    else:
-                        # 处理其他类型的表达式
-                        expr_node = f"EXPR:{rhs.kind}"
-                        self.functions[parent_func]['local_dfg'].add_node(expr_node, type='expression')
-                        self.functions[parent_func]['local_dfg'].add_edge(expr_node, lhs_name, type='assignment')
-                        
-                        # 如果左侧是全局变量，记录为函数副作用
-                        if lhs_name in self.global_vars or lhs_name in self.static_vars:
-                            self.functions[parent_func]['side_effects']['global_vars_write'].add(lhs_name)
+                    # 分析函数调用参数
+                    for arg in rhs.get_arguments():
+                        arg_symbol = self.symbols.resolve(arg)
+                        if arg_symbol is not None:
+                            # 添加参数到函数调用的数据流
+                            local_dfg.add_edge(arg_symbol.qualified_name, call_node, type='argument')
+                            
+                            # 如果参数是全局变量，记录为函数副作用
+                            if arg_symbol.is_global_or_static:
+                                side_effects['global_vars_read'].add(arg_symbol.qualified_name)
+                
+                # 检查右侧是否是内存分配
+                elif self._check_heap_allocation(rhs):
+                    self._mark_heap_candidate(lhs_symbol)
+                    
+                    # 记录堆内存操作作为函数副作用
+                    side_effects['heap_operations'].append({
+                        'operation': 'allocation',
+                        'variable': lhs_name,
+                        'location': f"{lhs.location.file}:{lhs.location.line}:{lhs.location.column}"
+                    })
+                    
+                    # 添加堆内存分配节点到函数内部数据流图
+                    heap_node = f"HEAP:allocation"
+                    local_dfg.add_node(heap_node, type='heap_operation')
+                    local_dfg.add_edge(heap_node, lhs_name, type='allocation')
+                
+                # 处理字面量赋值
+                elif rhs.kind == clang.cindex.CursorKind.INTEGER_LITERAL or \
+                     rhs.kind == clang.cindex.CursorKind.FLOATING_LITERAL or \
+                     rhs.kind == clang.cindex.CursorKind.STRING_LITERAL or \
+                     rhs.kind == clang.cindex.CursorKind.CHARACTER_LITERAL:
+                    # 添加字面量节点到函数内部数据流图
+                    literal_node = f"LITERAL:{rhs.kind}"
+                    local_dfg.add_node(literal_node, type='literal')
+                    local_dfg.add_edge(literal_node, lhs_name, type='assignment')
+                    
+                    # 如果左侧是全局变量，记录为函数副作用
+                    if lhs_symbol.is_global_or_static:
+                        side_effects['global_vars_write'].add(lhs_name)
+                
+                # 处理复杂表达式
+                elif self._find_call_expr(rhs):
+                    # 函数调用的返回值赋给变量，在_process_function_call中处理
+                    pass
+                else:
+                    # 处理其他类型的表达式
+                    expr_node = f"EXPR:{rhs.kind}"
+                    local_dfg.add_node(expr_node, type='expression')
+                    local_dfg.add_edge(expr_node, lhs_name, type='assignment')
+                    
+                    # 如果左侧是全局变量，记录为函数副作用
+                    if lhs_symbol.is_global_or_static:
+                        side_effects['global_vars_write'].add(lhs_name)
             
             # 处理左侧是数组访问的情况
             elif lhs.kind == clang.cindex.CursorKind.ARRAY_SUBSCRIPT_EXPR:
-                # 获取数组名称
-                array_expr = None
+                # 获取数组对应的符号
+                array_symbol = None
                 for child in lhs.get_children():
-                    if child.kind == clang.cindex.CursorKind.DECL_REF_EXPR:
-                        array_expr = child
+                    array_symbol = self.symbols.resolve(child)
+                    if array_symbol is not None:
                         break
                 
-                if array_expr:
-                    array_name = array_expr.spelling
-                    if array_name in self.variables:
-                        # 添加数组访问节点到函数内部数据流图
-                        array_access_node = f"ARRAY_ACCESS:{array_name}"
-                        self.functions[parent_func]['local_dfg'].add_node(array_access_node, type='array_access')
-                        
-                        # 处理右侧表达式
-                        if rhs.kind == clang.cindex.CursorKind.DECL_REF_EXPR:
-                            rhs_name = rhs.spelling
-                            if rhs_name in self.variables:
-                                self.functions[parent_func]['local_dfg'].add_edge(rhs_name, array_access_node, type='assignment')
-                                
-                                # 如果右侧是全局变量，记录为函数副作用
-                                if rhs_name in self.global_vars or rhs_name in self.static_vars:
-                                    self.functions[parent_func]['side_effects']['global_vars_read'].add(rhs_name)
+                if array_symbol is not None:
+                    array_name = array_symbol.qualified_name
+                    # 添加数组访问节点到函数内部数据流图
+                    array_access_node = f"ARRAY_ACCESS:{array_name}"
+                    local_dfg.add_node(array_access_node, type='array_access')
+                    
+                    # 处理右侧表达式
+                    rhs_symbol = self.symbols.resolve(rhs)
+                    if rhs_symbol is not None:
+                        local_dfg.add_edge(rhs_symbol.qualified_name, array_access_node, type='assignment')
                         
-                        # 如果数组是全局变量，记录为函数副作用
-                        if array_name in self.global_vars or array_name in self.static_vars:
-                            self.functions[parent_func]['side_effects']['global_vars_write'].add(array_name)
+                        # 如果右侧是全局变量，记录为函数副作用
+                        if rhs_symbol.is_global_or_static:
+                            side_effects['global_vars_read'].add(rhs_symbol.qualified_name)
+                    
+                    # 如果数组是全局变量，记录为函数副作用
+                    if array_symbol.is_global_or_static:
+                        side_effects['global_vars_write'].add(array_name)
                         
+    def _collect_pointer_constraints(self, cursor, parent_func):
+        """收集指针指向约束（赋值、初始化、参数传递和返回值）"""
+        kind = cursor.kind
+        if kind == clang.cindex.CursorKind.VAR_DECL:
+            if not self._is_pointer_type(cursor.type):
+                return
+            symbol = self.symbols.lookup(cursor)
+            init_expr = None
+            for child in cursor.get_children():
+                if child.kind.is_expression():
+                    init_expr = child
+            if symbol is not None and init_expr is not None:
+                self._add_pointer_flow(init_expr, self._symbol_node(symbol), parent_func)
+        
+        elif kind == clang.cindex.CursorKind.BINARY_OPERATOR:
+            if not self._is_pointer_type(cursor.type):
+                return
+            children = list(cursor.get_children())
+            if len(children) != 2 or binary_operator(cursor) != '=':
+                return
+            target = self._pointer_target(children[0], parent_func)
+            if target is not None:
+                self._add_pointer_flow(children[1], target, parent_func)
+            if parent_func:
+                self.memory_lifetime.add_assignment(parent_func, (cursor.location.line, cursor.location.column),
+                                                    children[0])
+        
+        elif kind == clang.cindex.CursorKind.CALL_EXPR:
+            if not self._is_indirect_call(cursor):
+                callee = cursor.referenced
+                for index, arg in enumerate(cursor.get_arguments()):
+                    if self._is_pointer_type(arg.type):
+                        self._add_pointer_flow(arg, self._param_node(callee.spelling, index), parent_func)
+            elif parent_func:
+                # 间接调用：实参先流入调用点节点，目标函数确定后再连接到目标函数的形参节点
+                arguments = []
+                for index, arg in enumerate(cursor.get_arguments()):
+                    if self._is_pointer_type(arg.type):
+                        node_id = self._call_site_node(cursor, f"arg{index}")
+                        self._add_pointer_flow(arg, node_id, parent_func)
+                        arguments.append((index, node_id))
+                callee_expr = SymbolTable.strip(next(cursor.get_children(), None))
+                # (*fp)(...)与fp(...)等价：解引用函数指针得到的仍是同一函数
+                while (callee_expr is not None and callee_expr.kind == clang.cindex.CursorKind.UNARY_OPERATOR
+                       and unary_operator(callee_expr) == '*'):
+                    callee_expr = SymbolTable.strip(next(callee_expr.get_children(), None))
+                self._indirect_call_nodes[self._indirect_call_key(cursor)] = (
+                    self._pointer_sources(callee_expr, parent_func), arguments)
+        
+        elif kind == clang.cindex.CursorKind.RETURN_STMT and parent_func:
+            for child in cursor.get_children():
+                if self._is_pointer_type(child.type):
+                    self._add_pointer_flow(child, self._return_node(parent_func), parent_func)
+    
+    def _add_pointer_flow(self, expr, target, parent_func):
+        """添加约束：表达式的值流入目标节点"""
+        for source_kind, source_id in self._pointer_sources(expr, parent_func):
+            if source_kind == 'node':
+                self.points_to.add_copy(source_id, target)
+            else:
+                self.points_to.add_address(target, source_id)
+    
+    def _pointer_sources(self, expr, parent_func):
+        """返回指针表达式的值来源：[('node', 节点id)]或[('object', 对象id)]"""
+        expr = SymbolTable.strip(expr)
+        if expr is None:
+            return []
+        kind = expr.kind
+        
+        if kind == clang.cindex.CursorKind.DECL_REF_EXPR:
+            declaration = expr.referenced
+            if declaration is None:
+                return []
+            if declaration.kind == clang.cindex.CursorKind.FUNCTION_DECL:
+                return [('object', self._function_object(declaration.spelling))]
+            symbol = self.symbols.lookup(declaration)
+            if symbol is None:
+                return []
+            # 数组名退化为指向数组本身的指针
+            if declaration.type.get_canonical().kind in (clang.cindex.TypeKind.CONSTANTARRAY,
+                                                         clang.cindex.TypeKind.INCOMPLETEARRAY):
+                return [('object', self._variable_object(symbol))]
+            return [('node', self._symbol_node(symbol))]
+        
+        if kind == clang.cindex.CursorKind.MEMBER_REF_EXPR:
+            return [('node', self._field_node(expr))]
+        
+        if kind == clang.cindex.CursorKind.UNARY_OPERATOR:
+            operand = next(expr.get_children(), None)
+            operator = unary_operator(expr)
+            if operator == '&':
+                return self._address_sources(operand, parent_func)
+            if operator == '*':
+                return [('node', self._deref_node(expr, operand, parent_func, 'load'))]
+            # 自增、自减等运算不改变指向
+            return self._pointer_sources(operand, parent_func)
+        
+        if kind == clang.cindex.CursorKind.ARRAY_SUBSCRIPT_EXPR:
+            return [('node', self._deref_node(expr, self._subscript_base(expr), parent_func, 'load'))]
+        
+        if kind == clang.cindex.CursorKind.CALL_EXPR:
+            sources = []
+            if expr.spelling in self.allocation_functions:
+                sources.append(('object', self._heap_object(expr, parent_func)))
+            if self._is_indirect_call(expr):
+                sources.append(('node', self._call_site_node(expr, 'return')))
+            else:
+                sources.append(('node', self._return_node(expr.referenced.spelling)))
+            return sources
+        
+        if kind == clang.cindex.CursorKind.CONDITIONAL_OPERATOR:
+            sources = []
+            for child in list(expr.get_children())[1:]:
+                sources.extend(self._pointer_sources(child, parent_func))
+            return sources
+        
+        if kind == clang.cindex.CursorKind.BINARY_OPERATOR:
+            # 指针算术（p + n）、逗号表达式和连续赋值：取指针类型的操作数
+            children = list(expr.get_children())
+            operator = binary_operator(expr) if children else ''
+            if operator in ('=', ','):
+                return self._pointer_sources(children[-1], parent_func)
+            sources = []
+            for child in children:
+                if self._is_pointer_type(child.type):
+                    sources.extend(self._pointer_sources(child, parent_func))
+            return sources
+        
+        return []
+    
+    def _address_sources(self, operand, parent_func):
+        """取地址表达式（&x）的值来源"""
+        operand = SymbolTable.strip(operand)
+        if operand is None:
+            return []
+        if operand.kind == clang.cindex.CursorKind.DECL_REF_EXPR:
+            declaration = operand.referenced
+            if declaration is None:
+                return []
+            if declaration.kind == clang.cindex.CursorKind.FUNCTION_DECL:
+                return [('object', self._function_object(declaration.spelling))]
+            symbol = self.symbols.lookup(declaration)
+            return [('object', self._variable_object(symbol))] if symbol is not None else []
+        if operand.kind == clang.cindex.CursorKind.MEMBER_REF_EXPR:
+            label = self._field_label(operand)
+            return [('object', self.points_to.object('variable', label, f"&{label}", node=self._field_node(operand),
+                                                     variable=label))]
+        if operand.kind == clang.cindex.CursorKind.ARRAY_SUBSCRIPT_EXPR:
+            # &p[i]等价于p + i
+            base = next(operand.get_children(), None)
+            return self._pointer_sources(base, parent_func)
+        if operand.kind == clang.cindex.CursorKind.UNARY_OPERATOR and unary_operator(operand) == '*':
+            # &*p等价于p
+            return self._pointer_sources(next(operand.get_children(), None), parent_func)
+        return []
+    
+    def _pointer_target(self, expr, parent_func):
+        """返回赋值左侧对应的约束节点，不是可跟踪的左值时返回None"""
+        expr = SymbolTable.strip(expr)
+        if expr is None:
+            return None
+        if expr.kind == clang.cindex.CursorKind.DECL_REF_EXPR:
+            symbol = self.symbols.resolve(expr)
+            return self._symbol_node(symbol) if symbol is not None else None
+        if expr.kind == clang.cindex.CursorKind.MEMBER_REF_EXPR:
+            return self._field_node(expr)
+        if expr.kind == clang.cindex.CursorKind.ARRAY_SUBSCRIPT_EXPR:
+            return self._deref_node(expr, self._subscript_base(expr), parent_func, 'store')
+        if expr.kind == clang.cindex.CursorKind.UNARY_OPERATOR and unary_operator(expr) == '*':
+            return self._deref_node(expr, next(expr.get_children(), None), parent_func, 'store')
+        return None
+    
+    def _symbol_node(self, symbol):
+        return self.points_to.node(('symbol', symbol.id), symbol.qualified_name)
+    
+    def _field_node(self, member_expr):
+        """结构体字段节点：同一字段的所有实例共用一个节点（字段敏感、基址不敏感）"""
+        field = member_expr.referenced
+        label = self._field_label(member_expr)
+        if field is None:
+            return self.points_to.node(('field', label), label)
+        return self.points_to.node(('field', field.get_usr() or label), label)
+    
+    @staticmethod
+    def _field_label(member_expr):
+        """字段的可读名称：结构体名.字段名"""
+        field = member_expr.referenced
+        if field is None:
+            return f".{member_expr.spelling}"
+        record = field.semantic_parent
+        record_name = record.spelling if record is not None else ''
+        if record is not None and record.is_anonymous():
+            # 匿名结构体（typedef struct {...} Name）使用访问表达式中基址的类型名
+            base = next(member_expr.get_children(), None)
+            if base is not None:
+                base_type = base.type
+                if base_type.kind == clang.cindex.TypeKind.POINTER:
+                    base_type = base_type.get_pointee()
+                record_name = base_type.spelling.replace('const ', '').replace('volatile ', '')
+        return f"{record_name}.{field.spelling}"
+    
+    @staticmethod
+    def _field_layout(member_expr):
+        """字段所属结构体在struct_layout_report中的键（限定名），不同文件中的同名结构体互不混淆"""
+        field = member_expr.referenced
+        if field is None or field.kind != clang.cindex.CursorKind.FIELD_DECL or field.semantic_parent is None:
+            return None
+        return StructLayoutAnalyzer.record_key(field.semantic_parent)
+    
+    def _deref_node(self, expr, pointer_expr, parent_func, access):
+        """解引用表达式（*p、p[i]）的读写节点，按表达式位置区分
+        
+        读取时指针可能指向的每个对象的内容流入该节点，写入时该节点流入这些对象的内容；
+        指针的值来源是已知对象（&x、数组名）时直接与对象内容相连。
+        """
+        location = f"{expr.location.file}:{expr.location.line}:{expr.location.column}"
+        node_id = self.points_to.find_node((access, location))
+        if node_id is not None:
+            return node_id
+        node_id = self.points_to.node((access, location), f"{access}@{location}")
+        for source_kind, source_id in self._pointer_sources(pointer_expr, parent_func):
+            if source_kind == 'node':
+                if access == 'load':
+                    self.points_to.add_load(source_id, node_id)
+                else:
+                    self.points_to.add_store(node_id, source_id)
+                continue
+            content = self.points_to.object_node(source_id)
+            if content is None:
+                continue
+            if access == 'load':
+                self.points_to.add_copy(content, node_id)
+            else:
+                self.points_to.add_copy(node_id, content)
+        return node_id
+    
+    def _subscript_base(self, expr):
+        """下标表达式中的指针或数组操作数（a[i]和i[a]）"""
+        children = list(expr.get_children())
+        for child in children:
+            if child.type.get_canonical().kind in (clang.cindex.TypeKind.POINTER, clang.cindex.TypeKind.CONSTANTARRAY,
+                                                   clang.cindex.TypeKind.INCOMPLETEARRAY):
+                return child
+        return children[0] if children else None
+    
+    def _param_node(self, func_name, index):
+        return self.points_to.node(('param', func_name, index), f"{func_name}#arg{index}")
+    
+    def _return_node(self, func_name):
+        return self.points_to.node(('return', func_name), f"{func_name}#return")
+    
+    def _call_site_node(self, call_expr, slot):
+        """间接调用点的实参或返回值节点"""
+        location, callee = self._indirect_call_key(call_expr)
+        return self.points_to.node(('call_site', location, callee, slot), f"{callee}@{location}#{slot}")
+    
+    def _heap_object(self, call_expr, parent_func):
+        """堆分配点对象，以调用位置区分"""
+        location = f"{call_expr.location.file}:{call_expr.location.line}:{call_expr.location.column}"
+        return self.points_to.object('heap', location, f"{call_expr.spelling}@{parent_func or '<global>'}:{call_expr.location.line}",
+                                     allocator=call_expr.spelling, function=parent_func, location=location)
+    
+    def _function_object(self, func_name):
+        return self.points_to.object('function', func_name, f"&{func_name}", function=func_name)
+    
+    def _variable_object(self, symbol):
+        return self.points_to.object('variable', symbol.qualified_name, f"&{symbol.qualified_name}",
+                                     node=self._symbol_node(symbol),
+                                     variable=symbol.qualified_name)
+    
+    @staticmethod
+    def _is_indirect_call(call_expr):
+        """调用表达式是否经函数指针（结构体字段、变量或解引用表达式）调用"""
+        callee = call_expr.referenced
+        return callee is None or callee.kind != clang.cindex.CursorKind.FUNCTION_DECL
+    
+    @classmethod
+    def _indirect_call_key(cls, call_expr):
+        """间接调用的键：(调用位置, 函数指针表达式)
+        
+        同一宏展开中的多个调用位置相同，再以函数指针表达式区分。
+        """
+        location = f"{call_expr.location.file}:{call_expr.location.line}:{call_expr.location.column}"
+        return location, call_expr.spelling or callee_text(call_expr)
+    
+    @staticmethod
+    def _callee_type(call_expr):
+        """间接调用中函数指针的类型名（如TimerCallback），(*fp)(...)取fp的类型"""
+        callee_expr = SymbolTable.strip(next(call_expr.get_children(), None))
+        if callee_expr is not None and callee_expr.kind == clang.cindex.CursorKind.UNARY_OPERATOR:
+            callee_expr = SymbolTable.strip(next(callee_expr.get_children(), None))
+        return callee_expr.type.spelling if callee_expr is not None else ''
+    
+    # 内存访问表达式，以及写入左值的赋值、复合赋值和自增自减
+    MEMORY_ACCESS_KINDS = (
+        clang.cindex.CursorKind.DECL_REF_EXPR,
+        clang.cindex.CursorKind.MEMBER_REF_EXPR,
+        clang.cindex.CursorKind.ARRAY_SUBSCRIPT_EXPR,
+        clang.cindex.CursorKind.UNARY_OPERATOR,
+        clang.cindex.CursorKind.BINARY_OPERATOR,
+        clang.cindex.CursorKind.COMPOUND_ASSIGNMENT_OPERATOR,
+    )
+    
+    # 被写入的左值表达式对应的访问类型
+    MEMORY_ACCESS_TARGETS = {
+        clang.cindex.CursorKind.DECL_REF_EXPR: 'global',
+        clang.cindex.CursorKind.MEMBER_REF_EXPR: 'field',
+        clang.cindex.CursorKind.ARRAY_SUBSCRIPT_EXPR: 'element',
+        clang.cindex.CursorKind.UNARY_OPERATOR: 'deref',
+    }
+    
+    @staticmethod
+    def _is_pointer_type(type_):
+        return type_.get_canonical().kind == clang.cindex.TypeKind.POINTER
+    
+    def _process_atomic_builtin(self, cursor, parent_func):
+        """处理atomic_*宏展开出的原子内建调用（__atomic_fetch_add等）
+
+        参数类型依赖于原子对象的内建调用在libclang中是UNEXPOSED_EXPR，
+        第一个子节点是对内建函数的引用，其余子节点是实参。
+        """
+        children = list(cursor.get_children())
+        if len(children) < 2 or children[0].kind != clang.cindex.CursorKind.DECL_REF_EXPR:
+            return
+        builtin = children[0].referenced
+        if builtin is None or builtin.kind != clang.cindex.CursorKind.FUNCTION_DECL:
+            return
+        sync = sync_operation(builtin.spelling)
+        if sync is None or sync[0] != 'atomic' or parent_func not in self.functions:
+            return
+        location = f"{cursor.location.file}:{cursor.location.line}:{cursor.location.column}"
+        lock_label, lock_sources = self._lock_argument(children[1], parent_func)
+        self.locks.add_operation(parent_func, builtin.spelling, cursor.location.line, cursor.location.column, location,
+                                 lock_label, lock_sources)
+        self.functions[parent_func]['side_effects']['sync_operations'].append({
+            'operation': 'atomic',
+            'primitive': 'atomic',
+            'target': lock_label,
+            'location': location
+        })
+    
+    def _lock_argument(self, arg, parent_func):
+        """锁实参的名称和指针值来源
+
+        &g_lock、&timer->lock、&locks[i]直接以变量限定名或"结构体名.字段名"命名（来源为None）；
+        其他指针表达式以源码命名，并返回值来源供指针分析求解后解析为所指向的锁变量。
+        """
+        expr = SymbolTable.strip(arg)
+        if expr is not None and expr.kind == clang.cindex.CursorKind.UNARY_OPERATOR and \
+                unary_operator(expr) == '&':
+            operand = SymbolTable.strip(next(expr.get_children(), None))
+            suffix = ''
+            while operand is not None and operand.kind == clang.cindex.CursorKind.ARRAY_SUBSCRIPT_EXPR:
+                operand = SymbolTable.strip(next(operand.get_children(), None))
+                suffix += '[]'
+            if operand is not None and operand.kind == clang.cindex.CursorKind.MEMBER_REF_EXPR:
+                return self._field_label(operand) + suffix, None
+            symbol = self.symbols.resolve(operand) if operand is not None else None
+            if symbol is not None:
+                return symbol.qualified_name + suffix, None
+        label = token_text(arg)
+        return label, self._pointer_sources(arg, parent_func)
+    
+    def _record_shared_access(self, cursor, parent_func):
+        """登记全局变量或结构体字段的一次访问
+
+        变量引用和字段访问按读登记；赋值、复合赋值和自增自减的左值按写登记，
+        同一位置的读写由SharedStateAnalyzer合并。
+        """
+        kind = cursor.kind
+        if kind in (clang.cindex.CursorKind.DECL_REF_EXPR, clang.cindex.CursorKind.MEMBER_REF_EXPR):
+            target, write = cursor, False
+        else:
+            children = list(cursor.get_children())
+            if not children:
+                return
+            if kind == clang.cindex.CursorKind.BINARY_OPERATOR:
+                if len(children) != 2 or binary_operator(cursor) != '=':
+                    return
+            elif kind == clang.cindex.CursorKind.UNARY_OPERATOR:
+                # 前缀或后缀的自增自减
+                if unary_operator(cursor) not in ('++', '--'):
+                    return
+            target, write = children[0], True
+        
+        # 数组元素的写入记为对数组本身的写入
+        target = SymbolTable.strip(target)
+        while write and target is not None and target.kind == clang.cindex.CursorKind.ARRAY_SUBSCRIPT_EXPR:
+            target = SymbolTable.strip(next(target.get_children(), None))
+        if target is None:
+            return
+        location = f"{target.location.file}:{target.location.line}:{target.location.column}"
+        
+        if target.kind == clang.cindex.CursorKind.DECL_REF_EXPR:
+            symbol = self.symbols.resolve(target)
+            if symbol is not None and symbol.is_global_or_static:
+                self.shared_state.add_access(symbol.qualified_name, 'global', parent_func,
+                                             target.location.line, location, write)
+        elif target.kind == clang.cindex.CursorKind.MEMBER_REF_EXPR:
+            base_sources = self._member_base_sources(target, parent_func)
+            if base_sources == []:
+                # 基址是局部结构体变量
+                return
+            self.shared_state.add_access(self._field_label(target), 'field', parent_func,
+                                         target.location.line, location, write, base_sources,
+                                         self._field_layout(target))
+    
+    def _record_memory_access(self, cursor, parent_func):
+        """登记一次内存访问，或把赋值、复合赋值和自增自减的左值登记为写入"""
+        kind = cursor.kind
+        children = list(cursor.get_children())
+        if kind in (clang.cindex.CursorKind.BINARY_OPERATOR, clang.cindex.CursorKind.COMPOUND_ASSIGNMENT_OPERATOR,
+                    clang.cindex.CursorKind.UNARY_OPERATOR):
+            if not children:
+                return
+            if kind == clang.cindex.CursorKind.BINARY_OPERATOR:
+                write = len(children) == 2 and binary_operator(cursor) == '='
+            elif kind == clang.cindex.CursorKind.UNARY_OPERATOR:
+                operator = unary_operator(cursor)
+                write = operator in ('++', '--')
+                if operator == '*':
+                    location = f"{cursor.location.file}:{cursor.location.line}:{cursor.location.column}"
+                    self.memory_traffic.add_access(parent_func, 'deref', cursor.location.line, location, True,
+                                                   MemoryTrafficAnalyzer.dependence_depth(cursor))
+            else:
+                write = True
+            target = SymbolTable.strip(children[0])
+            if write and target is not None:
+                access_kind = self.MEMORY_ACCESS_TARGETS.get(target.kind)
+                if access_kind is not None:
+                    self.memory_traffic.mark_write(
+                        f"{target.location.file}:{target.location.line}:{target.location.column}", access_kind)
+            return
+        
+        location = f"{cursor.location.file}:{cursor.location.line}:{cursor.location.column}"
+        if kind == clang.cindex.CursorKind.DECL_REF_EXPR:
+            # 全局/静态标量变量；数组和结构体变量按元素和字段访问统计
+            symbol = self.symbols.resolve(cursor)
+            if symbol is None or not symbol.is_global_or_static or \
+                    cursor.type.get_canonical().kind in (clang.cindex.TypeKind.RECORD,
+                                                         clang.cindex.TypeKind.CONSTANTARRAY,
+                                                         clang.cindex.TypeKind.FUNCTIONPROTO):
+                return
+            self.memory_traffic.add_access(parent_func, 'global', cursor.location.line, location, False, 0)
+            return
+        if not children or cursor.type.get_canonical().kind in (clang.cindex.TypeKind.RECORD,
+                                                                 clang.cindex.TypeKind.CONSTANTARRAY):
+            # 嵌入的结构体或数组（p->in.v中的p->in）只计算地址，访问按最内层的字段或元素统计
+            return
+        # 依赖链长度为0的访问（局部结构体s.f、全局数组g[i]）不经指针
+        depth = MemoryTrafficAnalyzer.dependence_depth(cursor)
+        field = layout = None
+        if kind == clang.cindex.CursorKind.MEMBER_REF_EXPR:
+            field, layout = self._field_label(cursor), self._field_layout(cursor)
+        self.memory_traffic.add_access(parent_func, self.MEMORY_ACCESS_TARGETS[kind], cursor.location.line,
+                                       location, depth > 0, depth, field, layout)
+    
+    def _member_base_sources(self, member_expr, parent_func):
+        """字段所在对象的来源：基址是全局变量时返回None，否则返回基址指针的值来源"""
+        base = SymbolTable.strip(next(member_expr.get_children(), None))
+        while base is not None:
+            if base.kind == clang.cindex.CursorKind.DECL_REF_EXPR:
+                symbol = self.symbols.resolve(base)
+                if symbol is not None and symbol.is_global_or_static:
+                    return None
+                if base.type.get_canonical().kind == clang.cindex.TypeKind.POINTER:
+                    return self._pointer_sources(base, parent_func)
+                return []
+            if base.type.get_canonical().kind == clang.cindex.TypeKind.POINTER:
+                # p->f、a[i]->f、s.next->f：对象由基址指针的指向决定
+                return self._pointer_sources(base, parent_func)
+            if base.kind in (clang.cindex.CursorKind.MEMBER_REF_EXPR, clang.cindex.CursorKind.ARRAY_SUBSCRIPT_EXPR):
+                # a.b.f、a[i].f：对象嵌在外层对象中
+                inner = SymbolTable.strip(next(base.get_children(), None))
+                if base.kind == clang.cindex.CursorKind.MEMBER_REF_EXPR and inner is not None and \
+                        inner.type.get_canonical().kind == clang.cindex.TypeKind.POINTER:
+                    return self._pointer_sources(inner, parent_func)
+                base = inner
+                continue
+            if base.kind == clang.cindex.CursorKind.UNARY_OPERATOR:
+                # (*p).f
+                return self._pointer_sources(next(base.get_children(), None), parent_func)
+            return []
+        return []
+    
     def _find_call_expr(self, node):
         """递归查找节点中的函数调用表达式"""
         if node.kind == clang.cindex.CursorKind.CALL_EXPR:
@@ -1053,44 +2024,29 @@ class CCodeAnalyzer:
             f.write(f"Is Static: {storage_class == clang.cindex.StorageClass.STATIC}\n")
             f.write("---\n")
         
-        # 记录变量信息
-        var_info = {
-            'type': var_type,
-            'storage': storage_class,
-            'location': f"{cursor.location.file}:{cursor.location.line}:{cursor.location.column}",
-            'is_pointer': '*' in var_type,
-            'references': [],
-            'is_global': cursor.semantic_parent.kind == clang.cindex.CursorKind.TRANSLATION_UNIT,
-            'is_static': storage_class == clang.cindex.StorageClass.STATIC,
-            'is_heap': False,
-            'parent_function': parent_func
-        }
-        
-        # 只有全局变量和静态变量才添加到variables集合中
-        if cursor.semantic_parent.kind == clang.cindex.CursorKind.TRANSLATION_UNIT or \
-           storage_class == clang.cindex.StorageClass.STATIC:
-            self.variables[var_name] = var_info
+        # 登记到符号表（全局变量、静态变量和局部变量各自对应独立的符号）
+        symbol = self.symbols.declare(cursor, parent_func)
         
         # 如果是函数内的局部变量，添加到函数的局部变量列表
         if parent_func and parent_func in self.functions:
             self.functions[parent_func]['local_variables'].append({
                 'name': var_name,
                 'type': var_type,
-                'location': var_info['location']
+                'location': f"{cursor.location.file}:{cursor.location.line}:{cursor.location.column}"
             })
         
         # 识别全局变量和静态变量
-        if storage_class == clang.cindex.StorageClass.STATIC:
-            self.static_vars.add(var_name)
+        if symbol.is_static:
+            self.static_vars.add(symbol.qualified_name)
             # 如果是文件作用域的静态变量，也将其添加到全局变量集合中
-            if cursor.semantic_parent.kind == clang.cindex.CursorKind.TRANSLATION_UNIT:
-                self.global_vars.add(var_name)
-        elif cursor.semantic_parent.kind == clang.cindex.CursorKind.TRANSLATION_UNIT:
-            self.global_vars.add(var_name)
+            if symbol.is_global:
+                self.global_vars.add(symbol.qualified_name)
+        elif symbol.is_global:
+            self.global_vars.add(symbol.qualified_name)
         
         # 检查是否是堆分配变量
-        if var_info['is_pointer']:
-            self._check_heap_variable(cursor, var_name)
+        if symbol.is_pointer:
+            self._check_heap_variable(cursor, symbol)
     
     def _check_heap_allocation(self, node):
         """检查节点是否表示堆内存分配"""
@@ -1099,21 +2055,11 @@ class CCodeAnalyzer:
             
         # 检查函数调用表达式
         if node.kind == clang.cindex.CursorKind.CALL_EXPR:
-            # 获取函数名
-            func_name = node.spelling.lower()
-            
-            # 检查标准内存分配函数
-            if node.spelling in ['malloc', 'calloc', 'realloc', 'aligned_alloc', 'valloc', 'pvalloc']:
-                return True
-                
-            # 检查自定义内存分配函数 - 更全面的模式匹配
-            memory_alloc_patterns = ['alloc', 'new', 'create', 'dup', 'clone', 'copy']
-            for pattern in memory_alloc_patterns:
-                if pattern in func_name:
-                    return True
+            # 标准分配函数或配置的自定义分配函数
+            return node.spelling in self.allocation_functions
                     
-        # 检查类型转换表达式
-        elif node.kind == clang.cindex.CursorKind.CSTYLE_CAST_EXPR:
+        # 检查类型转换表达式和括号表达式
+        elif node.kind in (clang.cindex.CursorKind.CSTYLE_CAST_EXPR, clang.cindex.CursorKind.PAREN_EXPR):
             # 递归检查类型转换表达式中的所有子节点
             for child in node.get_children():
                 if self._check_heap_allocation(child):
@@ -1139,46 +2085,6 @@ class CCodeAnalyzer:
                     
         return False
     
-    def _check_heap_variable(self, cursor, var_name):
-        """检查变量是否是堆分配变量"""
-        # 检查初始化表达式
-        for child in cursor.get_children():
-            # 检查类型转换表达式
-            if child.kind == clang.cindex.CursorKind.CSTYLE_CAST_EXPR:
-                for subchild in child.get_children():
-                    if self._check_heap_allocation(subchild):
-                        self.heap_vars.add(var_name)
-                        # 确保变量在字典中存在
-                        if var_name in self.variables:
-                            self.variables[var_name]['is_heap'] = True
-                        break
-            # 直接检查内存分配函数调用
-            elif self._check_heap_allocation(child):
-                self.heap_vars.add(var_name)
-                # 确保变量在字典中存在
-                if var_name in self.variables:
-                    self.variables[var_name]['is_heap'] = True
-                break
-            # 检查赋值表达式
-            elif child.kind == clang.cindex.CursorKind.BINARY_OPERATOR:
-                for subchild in child.get_children():
-                    if self._check_heap_allocation(subchild):
-                        self.heap_vars.add(var_name)
-                        # 确保变量在字典中存在
-                        if var_name in self.variables:
-                            self.variables[var_name]['is_heap'] = True
-                        break
-            # 检查函数调用中的内存分配
-            elif child.kind == clang.cindex.CursorKind.CALL_EXPR:
-                if self._check_heap_allocation(child):
-                    self.heap_vars.add(var_name)
-                    # 确保变量在字典中存在
-                    if var_name in self.variables:
-                        self.variables[var_name]['is_heap'] = True
-                    break
-        
-        return False
-    
     def _check_heap_allocation_extended(self, node):
         """扩展的堆内存分配检查函数"""
         if node is None:
@@ -1210,7 +2116,7 @@ class CCodeAnalyzer:
                     
         return False
     
-    def _check_heap_variable(self, cursor, var_name):
+    def _check_heap_variable(self, cursor, symbol):
         """检查变量是否是堆分配变量"""
         # 检查初始化表达式
         for child in cursor.get_children():
@@ -1218,36 +2124,35 @@ class CCodeAnalyzer:
             if child.kind == clang.cindex.CursorKind.CSTYLE_CAST_EXPR:
                 for subchild in child.get_children():
                     if self._check_heap_allocation(subchild):
-                        self.heap_vars.add(var_name)
-                        # 确保变量在字典中存在
-                        if var_name in self.variables:
-                            self.variables[var_name]['is_heap'] = True
+                        self._mark_heap_candidate(symbol)
                         break
             # 直接检查内存分配函数调用
             elif self._check_heap_allocation(child):
-                self.heap_vars.add(var_name)
-                # 确保变量在字典中存在
-                if var_name in self.variables:
-                    self.variables[var_name]['is_heap'] = True
+                self._mark_heap_candidate(symbol)
                 break
             # 检查赋值表达式
             elif child.kind == clang.cindex.CursorKind.BINARY_OPERATOR:
                 for subchild in child.get_children():
                     if self._check_heap_allocation(subchild):
-                        self.heap_vars.add(var_name)
-                        # 确保变量在字典中存在
-                        if var_name in self.variables:
-                            self.variables[var_name]['is_heap'] = True
+                        self._mark_heap_candidate(symbol)
                         break
             # 检查函数调用中的内存分配
             elif child.kind == clang.cindex.CursorKind.CALL_EXPR:
                 if self._check_heap_allocation(child):
-                    self.heap_vars.add(var_name)
-                    # 确保变量在字典中存在
-                    if var_name in self.variables:
-                        self.variables[var_name]['is_heap'] = True
+                    self._mark_heap_candidate(symbol)
                     break
     
+    def _mark_heap_symbol(self, symbol):
+        """标记变量指向堆内存"""
+        self.heap_vars.add(symbol.qualified_name)
+        symbol.is_heap = True
+    
+    def _mark_heap_candidate(self, symbol):
+        """直接接收分配函数返回值的堆变量候选：只保留指针类型的变量，
+        求解指针约束后由_track_heap_variables对指针分析无法确定指向的变量标记"""
+        if symbol.is_pointer:
+            self._heap_candidates[symbol.id] = symbol
+    
     def _build_cfg_dfg(self, cursor, parent_func=None):
         """构建控制流图和数据流图"""
         if cursor.kind == clang.cindex.CursorKind.FUNCTION_DECL:
@@ -1285,19 +2190,7 @@ class CCodeAnalyzer:
             
             # 处理函数参数
             for param in cursor.get_arguments():
-                param_name = param.spelling
-                param_type = param.type.spelling
-                if param_name not in self.variables:
-                    self.variables[param_name] = {
-                        'type': param_type,
-                        'storage': 'StorageClass.NONE',
-                        'location': f"{param.location.file}:{param.location.line}:{param.location.column}",
-                        'is_pointer': '*' in param_type,
-                        'references': [],
-                        'is_global': False,
-                        'is_static': False,
-                        'is_heap': False
-                    }
+                param_name = self.symbols.declare(param, func_name).qualified_name
                 # 添加参数到函数内部数据流图
                 if func_name in self.functions:
                     self.functions[func_name]['local_dfg'].add_node(param_name, type='parameter')
@@ -1312,7 +2205,7 @@ class CCodeAnalyzer:
         elif cursor.kind == clang.cindex.CursorKind.CALL_EXPR:
             # 记录函数调用
             called_func = cursor.spelling
-            if parent_func and called_func:
+            if parent_func and called_func and not self._is_indirect_call(cursor):
                 # 添加函数调用边到控制流图
                 self.cfg.add_edge(parent_func, called_func)
                 # 记录函数调用信息
@@ -1334,15 +2227,16 @@ class CCodeAnalyzer:
                                 call_info['arguments'].append(str(child.spelling))
                     elif arg.kind == clang.cindex.CursorKind.DECL_REF_EXPR:
                         # 处理变量参数
-                        var_name = arg.spelling
-                        call_info['arguments'].append(var_name)
-                        if var_name in self.variables:
+                        symbol = self.symbols.resolve(arg)
+                        call_info['arguments'].append(arg.spelling)
+                        if symbol is not None:
+                            var_name = symbol.qualified_name
                             # 添加到函数内部数据流图
                             if parent_func in self.functions:
                                 self.functions[parent_func]['local_dfg'].add_edge(var_name, f"CALL:{called_func}", type='argument')
                             
                             # 如果是全局变量，添加到全局数据流图
-                            if var_name in self.global_vars or var_name in self.static_vars:
+                            if symbol.is_global_or_static:
                                 self.global_dfg.add_edge(var_name, called_func, type='argument', via_function=parent_func)
                 
                 # 记录返回值
@@ -1356,29 +2250,14 @@ class CCodeAnalyzer:
                 self.function_calls.append(call_info)
                 
                 # 检查是否是内存分配函数
-                memory_alloc_patterns = ['malloc', 'calloc', 'realloc', 'aligned_alloc', 'valloc', 'pvalloc', 'alloc', 'new', 'create', 'dup', 'clone', 'copy']
-                is_memory_alloc = False
-                
-                # 检查是否是标准内存分配函数
-                if called_func in ['malloc', 'calloc', 'realloc', 'aligned_alloc', 'valloc', 'pvalloc']:
-                    is_memory_alloc = True
-                else:
-                    # 检查是否是自定义内存分配函数
-                    called_func_lower = called_func.lower()
-                    for pattern in memory_alloc_patterns:
-                        if pattern in called_func_lower:
-                            is_memory_alloc = True
-                            break
-                            
-                if is_memory_alloc:
+                if called_func in self.allocation_functions:
                     # 查找赋值目标变量
                     parent = cursor.semantic_parent
                     while parent:
                         if parent.kind == clang.cindex.CursorKind.VAR_DECL:
-                            var_name = parent.spelling
-                            if var_name in self.variables:
-                                self.heap_vars.add(var_name)
-                                self.variables[var_name]['is_heap'] = True
+                            symbol = self.symbols.lookup(parent)
+                            if symbol is not None:
+                                self._mark_heap_candidate(symbol)
                             break
                         parent = parent.semantic_parent
                 
@@ -1386,21 +2265,18 @@ class CCodeAnalyzer:
                 args = list(cursor.get_arguments())
                 for i, arg in enumerate(args):
                     if arg.kind == clang.cindex.CursorKind.DECL_REF_EXPR:
-                        var_name = arg.spelling
-                        if var_name in self.variables:
+                        symbol = self.symbols.resolve(arg)
+                        if symbol is not None:
+                            var_name = symbol.qualified_name
                             # 记录变量引用
-                            self.variables[var_name]['references'].append({
-                                'function': called_func,
-                                'as_argument': i,
-                                'location': f"{arg.location.file}:{arg.location.line}:{arg.location.column}"
-                            })
+                            symbol.add_reference('argument', called_func, i, arg)
                             
                             # 添加到函数内部数据流图
                             if parent_func in self.functions:
                                 self.functions[parent_func]['local_dfg'].add_edge(var_name, f"CALL:{called_func}", type='argument')
                             
                             # 如果是全局变量，添加到全局数据流图
-                            if var_name in self.global_vars or var_name in self.static_vars:
+                            if symbol.is_global_or_static:
                                 self.global_dfg.add_edge(var_name, called_func, type='argument', via_function=parent_func)
         
         elif cursor.kind == clang.cindex.CursorKind.BINARY_OPERATOR:
@@ -1417,48 +2293,18 @@ class CCodeAnalyzer:
             
             if lhs and rhs:
                 if lhs.kind == clang.cindex.CursorKind.DECL_REF_EXPR:
-                    lhs_name = lhs.spelling
-                    if lhs_name in self.variables:
+                    lhs_symbol = self.symbols.resolve(lhs)
+                    if lhs_symbol is not None:
+                        lhs_name = lhs_symbol.qualified_name
                         # 检查右侧是否是内存分配
-                        def is_heap_allocation(node):
-                            if node is None:
-                                return False
-                                
-                            if node.kind == clang.cindex.CursorKind.CALL_EXPR:
-                                # 检查标准内存分配函数
-                                if node.spelling in ['malloc', 'calloc', 'realloc', 'aligned_alloc', 'valloc', 'pvalloc']:
-                                    return True
-                                    
-                                # 检查自定义内存分配函数
-                                func_name = node.spelling.lower()
-                                memory_alloc_patterns = ['alloc', 'new', 'create', 'dup', 'clone', 'copy']
-                                for pattern in memory_alloc_patterns:
-                                    if pattern in func_name:
-                                        return True
-                            
-                            # 检查类型转换表达式
-                            elif node.kind == clang.cindex.CursorKind.CSTYLE_CAST_EXPR:
-                                for child in node.get_children():
-                                    if is_heap_allocation(child):
-                                        return True
-                                        
-                            # 检查括号表达式
-                            elif node.kind == clang.cindex.CursorKind.PAREN_EXPR:
-                                for child in node.get_children():
-                                    if is_heap_allocation(child):
-                                        return True
-                                        
-                            return False
-                            
-                        if is_heap_allocation(rhs):
-                                self.heap_vars.add(lhs_name)
-                                self.variables[lhs_name]['is_heap'] = True
+                        if self._check_heap_allocation(rhs):
+                            self._mark_heap_candidate(lhs_symbol)
                         
                         # 添加到数据流图
                         if rhs.kind == clang.cindex.CursorKind.DECL_REF_EXPR:
-                            rhs_name = rhs.spelling
-                            if rhs_name in self.variables:
-                                self.global_dfg.add_edge(rhs_name, lhs_name, type='assignment')
+                            rhs_symbol = self.symbols.resolve(rhs)
+                            if rhs_symbol is not None:
+                                self.global_dfg.add_edge(rhs_symbol.qualified_name, lhs_name, type='assignment')
         
         # 递归处理其他子节点
         for child in cursor.get_children():
@@ -1466,46 +2312,107 @@ class CCodeAnalyzer:
                 self._build_cfg_dfg(child, parent_func)
     
 
+    def _resolve_indirect_calls(self):
+        """解析经函数指针的间接调用目标
+        
+        求解指针约束后，函数指针表达式可能指向的函数对象即为调用目标（如回调函数经
+        注册函数的参数存入结构体字段，再经该字段调用）。把调用点的实参和返回值连接到
+        目标函数的形参和返回值节点后重新求解，直到不再出现新的目标，
+        经回调参数传递的函数指针也能逐层解析。
+        """
+        resolved = []
+        while True:
+            self.points_to.solve()
+            new_targets = []
+            for key, call_info in self.indirect_calls.items():
+                callee_sources, arguments = self._indirect_call_nodes.get(key, ([], []))
+                for target in self._function_targets(callee_sources):
+                    if target in call_info['targets']:
+                        continue
+                    call_info['targets'].append(target)
+                    new_targets.append((call_info, target))
+                    for index, node_id in arguments:
+                        self.points_to.add_copy(node_id, self._param_node(target, index))
+                    return_node = self.points_to.find_node(('call_site', *key, 'return'))
+                    if return_node is not None:
+                        self.points_to.add_copy(self._return_node(target), return_node)
+            if not new_targets:
+                break
+            resolved.extend(new_targets)
+        
+        # 为每个解析出的目标添加调用边和调用记录
+        # 先查询全部已有调用边（已有的直接调用边保留其属性）再添加，避免查询与添加交替使邻接索引反复重建
+        existing = [self.cfg.has_edge(call_info['caller'], target) for call_info, target in resolved]
+        for (call_info, target), exists in zip(resolved, existing):
+            caller = call_info['caller']
+            if not exists:
+                self.cfg.add_edge(caller, target, type='indirect')
+            self.function_calls.append({
+                'function': target,
+                'caller': caller,
+                'location': call_info['location'],
+                'arguments': call_info['arguments'],
+                'indirect': True
+            })
+            if caller in self.functions:
+                self.functions[caller].setdefault('calls', []).append({
+                    'function': target,
+                    'location': call_info['location'],
+                    'arguments': call_info['arguments'],
+                    'indirect': True
+                })
+    
+    def _connect_thread_arguments(self):
+        """线程参数流入线程函数的第一个参数（pthread_create(&t, NULL, worker, &queue)中的queue）"""
+        for creation in self.shared_state.thread_creations:
+            for routine in self._function_targets(creation['sources']):
+                param = self._param_node(routine, 0)
+                for source_kind, source_id in creation['argument_sources']:
+                    if source_kind == 'node':
+                        self.points_to.add_copy(source_id, param)
+                    else:
+                        self.points_to.add_address(param, source_id)
+    
+    def _function_targets(self, sources):
+        """值来源可能指向的函数名列表"""
+        targets = []
+        for source_kind, source_id in sources:
+            object_ids = [source_id] if source_kind == 'object' else self.points_to.points_to(source_id)
+            for object_id in object_ids:
+                obj = self.points_to.objects[object_id]
+                if obj['kind'] == 'function' and obj['function'] not in targets:
+                    targets.append(obj['function'])
+        return targets
+    
     def _track_heap_variables(self):
         """跟踪指向堆内存的指针变量"""
-        # 第一轮：标记直接指向堆内存的指针变量
-        for var_name in self.heap_vars:
-            var_info = self.variables.get(var_name)
-            if not var_info:
+        # 第一轮：求解指针指向约束，可能指向堆分配对象的指针变量即为堆变量
+        # 赋值、参数传递、返回值、经由结构体字段以及经指针读写的传递都已作为约束收集，
+        # 强连通分量收缩后按拓扑序传播，读写约束再以工作表迭代到不动点
+        self.points_to.solve()
+        for symbol in self.symbols.values():
+            if symbol.is_heap or not symbol.is_pointer:
+                continue
+            node_id = self.points_to.find_node(('symbol', symbol.id))
+            if node_id is not None and self.points_to.may_point_to_heap(node_id):
+                self._mark_heap_symbol(symbol)
+        # 接收分配函数返回值的候选只用于指针分析无法确定指向的指针变量
+        for symbol in self._heap_candidates.values():
+            node_id = self.points_to.find_node(('symbol', symbol.id))
+            if node_id is None or not self.points_to.points_to(node_id):
+                self._mark_heap_symbol(symbol)
+        
+        # 第二轮：在数据流图中标记堆指针变量作为参数传递的引用
+        for var_name in list(self.heap_vars):
+            symbol = self.symbols.get(var_name)
+            if symbol is None:
                 continue
                 
-            # 分析该指针变量的所有引用
-            for ref in var_info['references']:
-                func = ref['function']
-                # 在数据流图中添加指向堆内存的特殊标记
-                self.global_dfg.add_edge(var_name, func, type='heap_reference')
-        
-        # 第二轮：跟踪指向堆内存的指针传递
-        # 查找数据流图中的赋值关系，如果源变量指向堆内存，则目标变量也指向堆内存
-        heap_propagated = True
-        while heap_propagated:
-            heap_propagated = False
-            for src, dst, data in self.global_dfg.edges(data=True):
-                if data.get('type') == 'assignment' and src in self.heap_vars and dst not in self.heap_vars:
-                    if dst in self.variables and self.variables[dst]['is_pointer']:
-                        self.heap_vars.add(dst)
-                        self.variables[dst]['is_heap'] = True
-                        heap_propagated = True
-                        
-        # 第三轮：检查结构体成员指针
-        # 分析结构体成员是否指向堆内存
-        for var_name, var_info in self.variables.items():
-            # 检查是否是结构体指针且指向堆内存
-            if var_info['is_pointer'] and ('struct' in var_info['type'].lower() or 'union' in var_info['type'].lower()):
-                # 查找所有引用这个结构体的成员
-                for ref_var, ref_info in self.variables.items():
-                    if ref_var != var_name and ref_info['is_pointer']:
-                        # 检查是否是通过结构体成员访问
-                        for ref in ref_info.get('references', []):
-                            if var_name in str(ref):
-                                # 标记结构体成员指针指向堆内存
-                                self.heap_vars.add(ref_var)
-                                self.variables[ref_var]['is_heap'] = True
+            # 分析该指针变量作为参数传递的引用
+            for ref in symbol.references:
+                if ref.kind == 'argument':
+                    # 在数据流图中添加指向堆内存的特殊标记
+                    self.global_dfg.add_edge(var_name, ref.function, type='heap_reference')
     
     def _build_business_logic(self):
         """基于控制流图和数据流图构建业务逻辑框图"""
@@ -1575,10 +2482,10 @@ class CCodeAnalyzer:
         
         # 添加关键数据流
         for var_name in self.global_vars:
-            if var_name in self.variables:
+            if var_name in self.symbols:
                 # 查找使用该全局变量的函数
-                for ref in self.variables[var_name].get('references', []):
-                    func_name = ref.get('function')
+                for ref in self.symbols[var_name].references:
+                    func_name = ref.function if ref.kind == 'argument' else None
                     if func_name:
                         # 查找函数所属的业务模块
                         for module_name, functions in business_modules.items():
@@ -1590,8 +2497,9 @@ class CCodeAnalyzer:
     def visualize_cfg(self, output_file='control_flow_graph.png'):
         """可视化控制流图"""
         plt.figure(figsize=(12, 8))
-        pos = nx.spring_layout(self.cfg)
-        nx.draw(self.cfg, pos, with_labels=True, node_color='lightblue', 
+        cfg = networkx_view(self.cfg)
+        pos = nx.spring_layout(cfg)
+        nx.draw(cfg, pos, with_labels=True, node_color='lightblue', 
                 node_size=2000, arrows=True, font_size=10)
         plt.title("Control Flow Graph")
         plt.savefig(output_file)
@@ -1600,22 +2508,23 @@ class CCodeAnalyzer:
     def visualize_dfg(self, output_file='data_flow_graph.png'):
         """可视化数据流图"""
         plt.figure(figsize=(12, 8))
-        pos = nx.spring_layout(self.global_dfg)
+        global_dfg = networkx_view(self.global_dfg)
+        pos = nx.spring_layout(global_dfg)
         
         # 绘制不同类型的节点
-        global_nodes = [n for n in self.global_dfg.nodes() if n in self.global_vars]
-        static_nodes = [n for n in self.global_dfg.nodes() if n in self.static_vars]
-        heap_nodes = [n for n in self.global_dfg.nodes() if n in self.heap_vars]
-        other_nodes = [n for n in self.global_dfg.nodes() if n not in global_nodes + static_nodes + heap_nodes]
+        global_nodes = [n for n in global_dfg.nodes() if n in self.global_vars]
+        static_nodes = [n for n in global_dfg.nodes() if n in self.static_vars]
+        heap_nodes = [n for n in global_dfg.nodes() if n in self.heap_vars]
+        other_nodes = [n for n in global_dfg.nodes() if n not in global_nodes + static_nodes + heap_nodes]
         
-        nx.draw_networkx_nodes(self.global_dfg, pos, nodelist=global_nodes, node_color='red', node_size=1500, label='Global Variables')
-        nx.draw_networkx_nodes(self.global_dfg, pos, nodelist=static_nodes, node_color='green', node_size=1500, label='Static Variables')
-        nx.draw_networkx_nodes(self.global_dfg, pos, nodelist=heap_nodes, node_color='orange', node_size=1500, label='Heap Variables')
-        nx.draw_networkx_nodes(self.global_dfg, pos, nodelist=other_nodes, node_color='lightblue', node_size=1500)
+        nx.draw_networkx_nodes(global_dfg, pos, nodelist=global_nodes, node_color='red', node_size=1500, label='Global Variables')
+        nx.draw_networkx_nodes(global_dfg, pos, nodelist=static_nodes, node_color='green', node_size=1500, label='Static Variables')
+        nx.draw_networkx_nodes(global_dfg, pos, nodelist=heap_nodes, node_color='orange', node_size=1500, label='Heap Variables')
+        nx.draw_networkx_nodes(global_dfg, pos, nodelist=other_nodes, node_color='lightblue', node_size=1500)
         
         # 绘制边和标签
-        nx.draw_networkx_edges(self.global_dfg, pos, arrows=True)
-        nx.draw_networkx_labels(self.global_dfg, pos, font_size=10)
+        nx.draw_networkx_edges(global_dfg, pos, arrows=True)
+        nx.draw_networkx_labels(global_dfg, pos, font_size=10)
         
         plt.title("Data Flow Graph")
         plt.legend()
@@ -1659,9 +2568,13 @@ class CCodeAnalyzer:
                     processed_func = {k: v for k, v in func_info.items()}
                     
                     # 处理local_dfg (DiGraph对象)
-                    if 'local_dfg' in processed_func and isinstance(processed_func['local_dfg'], nx.DiGraph):
+                    if 'local_dfg' in processed_func and isinstance(processed_func['local_dfg'], CompactDiGraph):
                         processed_func['local_dfg'] = serialize_graph(processed_func['local_dfg'])
                     
+                    # 处理block_cfg (FunctionCFG对象)
+                    if isinstance(processed_func.get('block_cfg'), FunctionCFG):
+                        processed_func['block_cfg'] = processed_func['block_cfg'].to_dict()
+                    
                     # 处理side_effects中的集合类型
                     if 'side_effects' in processed_func and isinstance(processed_func['side_effects'], dict):
                         side_effects = {}
@@ -1681,7 +2594,7 @@ class CCodeAnalyzer:
                     processed_func = {k: v for k, v in func_info.items()}
                     
                     # 处理local_dfg (DiGraph对象)
-                    if 'local_dfg' in processed_func and isinstance(processed_func['local_dfg'], nx.DiGraph):
+                    if 'local_dfg' in processed_func and isinstance(processed_func['local_dfg'], CompactDiGraph):
                         processed_func['local_dfg'] = serialize_graph(processed_func['local_dfg'])
                     
                     # 处理side_effects中的集合类型
@@ -1698,15 +2611,10 @@ class CCodeAnalyzer:
             
             result = {
                 'files': self.files,
+                # 变量按限定名（函数作用域变量为"函数名::变量名"）输出
                 'variables': {
-                    name: {
-                        **{k: (v if isinstance(v, (bool, int, float, str, type(None))) else 
-                             (v if k == 'references' and isinstance(v, list) else str(v)))
-                           for k, v in info.items()},
-                        # 确保is_heap属性被正确设置，表示该指针是否指向堆内存
-                        'is_heap': name in self.heap_vars and info['is_pointer']
-                    }
-                    for name, info in self.variables.items()
+                    name: symbol.to_dict()
+                    for name, symbol in self.symbols.items()
                 },
                 'function_calls': [
                     {'caller': str(call_info['caller']), 'callee': str(call_info['function'])}
@@ -1719,7 +2627,33 @@ class CCodeAnalyzer:
                 # 将集合类型转换为列表
                 'global_vars': list(self.global_vars),
                 'static_vars': list(self.static_vars),
-                'heap_vars': list(self.heap_vars)
+                'heap_vars': list(self.heap_vars),
+                # 指针指向分析结果
+                'points_to': self.points_to.to_dict(),
+                # 调用图强连通分量与传递闭包汇总
+                'call_graph': self.call_graph.to_dict() if self.call_graph else None,
+                # 经函数指针的间接调用及解析出的目标函数
+                'indirect_calls': list(self.indirect_calls.values()),
+                # 结构体布局、填充与字段重排建议
+                'struct_layouts': self.struct_layout_report,
+                # 循环中和热点路径上的内存分配
+                'allocations': self.allocation_report,
+                # 链表遍历与线性查找
+                'list_traversals': self.list_traversal_report,
+                # 函数复杂度估计
+                'complexity': self.cost_report,
+                # 多线程争用数据与伪共享风险
+                'shared_state': self.shared_state_report,
+                # 锁争用、临界区与锁顺序
+                'locks': self.lock_report,
+                # 延迟敏感路径上的阻塞调用
+                'blocking_calls': self.blocking_report,
+                # 函数内存访问量与指针追逐估计
+                'memory_traffic': self.memory_traffic_report,
+                # 堆分配点的逃逸分类
+                'escape_analysis': self.escape_report,
+                # 分配与释放配对、泄漏路径和重复释放
+                'memory_lifetime': self.memory_lifetime_report
             }
             
             # 写入JSON文件
@@ -1732,13 +2666,62 @@ class CCodeAnalyzer:
             print(f"Error exporting to JSON: {e}")
             return False
     
+    def export_streaming(self, output_file, fmt='jsonl', compress=None):
+        """流式导出分析结果，内存占用与结果规模无关
+        Args:
+            output_file: 输出文件路径（启用压缩时自动追加.gz或.zst后缀）
+            fmt: 'jsonl'（每行一条记录）或'json'（与export_to_json结构相同的紧凑JSON）
+            compress: 压缩方式，None、'gzip'或'zstd'
+        Returns:
+            实际写出的文件路径，失败时返回None
+        """
+        try:
+            output_dir = os.path.dirname(output_file)
+            if output_dir and not os.path.exists(output_dir):
+                os.makedirs(output_dir)
+            exporter = StreamingResultExporter(output_file, fmt, compress)
+            exporter.export(self)
+            return exporter.output_file
+        except Exception as e:
+            print(f"Error exporting analysis results: {e}")
+            return None
+    
+    def export_columnar(self, output_dir):
+        """以列式二进制格式（numpy .npy文件目录）导出分析结果，可内存映射加载
+        Args:
+            output_dir: 输出目录
+        Returns:
+            {表名: 行数}，失败时返回None
+        """
+        try:
+            return ColumnarResultExporter(output_dir).export(self)
+        except Exception as e:
+            print(f"Error exporting columnar results: {e}")
+            return None
+    
+    def export_to_store(self, db_path, full=False):
+        """把分析结果写入（或增量更新）SQLite分析结果库
+        Args:
+            db_path: 数据库文件路径
+            full: 为True时重写全部行，否则只重写结果发生变化的文件
+        Returns:
+            更新摘要{'updated', 'removed', 'rows'}，失败时返回None
+        """
+        try:
+            with AnalysisStore(db_path) as store:
+                return store.update(self, full)
+        except Exception as e:
+            print(f"Error writing analysis store: {e}")
+            return None
+    
     def visualize_business_logic(self, output_file='business_logic.png'):
         """可视化业务逻辑框图"""
         plt.figure(figsize=(12, 8))
-        pos = nx.spring_layout(self.business_logic)
-        nx.draw_networkx_nodes(self.business_logic, pos, node_color='lightgreen', node_size=2000, label='业务节点')
-        nx.draw_networkx_edges(self.business_logic, pos, arrows=True)
-        nx.draw_networkx_labels(self.business_logic, pos, font_size=10)
+        business_logic = networkx_view(self.business_logic)
+        pos = nx.spring_layout(business_logic)
+        nx.draw_networkx_nodes(business_logic, pos, node_color='lightgreen', node_size=2000, label='业务节点')
+        nx.draw_networkx_edges(business_logic, pos, arrows=True)
+        nx.draw_networkx_labels(business_logic, pos, font_size=10)
         plt.title("Business Logic Diagram")
         plt.legend()
         plt.savefig(output_file)
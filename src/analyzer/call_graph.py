@@ -0,0 +1,221 @@
+"""调用图查询模块
+
+在控制流图（函数调用图）上预先计算强连通分量并收缩为有向无环的分量图，
+为每个分量缓存传递可达的分量集合（以Python整数作为位集合），之后的查询都不再遍历图：
+- reaches(a, b)、is_recursive(f)：O(1)的位运算和查表
+- transitive_callees(f)、transitive_callers(f)：按位集合解码，结果按分量缓存
+- 递归函数组：大小超过1的分量，或带自调用边的单函数分量
+- call_chain(f, targets)：最短调用链，广度优先搜索只进入能到达目标的分量
+
+可达性在分量图上按拓扑序一次传播，总代价为O(分量边数)次位集合并运算。
+"""
+
+from collections import deque
+
+from .graph_store import strongly_connected_components
+
+
+def _bits(bits):
+    """依次返回位集合中置位的下标"""
+    while bits:
+        low_bit = bits & -bits
+        yield low_bit.bit_length() - 1
+        bits ^= low_bit
+
+
+def _popcount(bits):
+    """位集合中置位的个数（int.bit_count需要Python 3.10）"""
+    return bin(bits).count('1')
+
+
+class CallGraphIndex:
+    """调用图的强连通分量和传递闭包索引"""
+
+    def __init__(self, graph):
+        """从调用图构建索引（之后再修改调用图不会影响已建立的索引）
+        Args:
+            graph: CompactDiGraph，节点为函数名，边为调用关系
+        """
+        node_count = graph.number_of_nodes()
+        indptr, targets = graph.csr()
+        # Tarjan算法和分量图构建逐个访问元素，转换为列表比numpy标量索引快
+        indptr, targets = indptr.tolist(), targets.tolist()
+        self._indptr = indptr
+        self._targets = targets
+        self.functions = [graph.node_key(node_id) for node_id in range(node_count)]
+        self._function_ids = {name: node_id for node_id, name in enumerate(self.functions)}
+
+        components, component_count = strongly_connected_components(node_count, indptr, targets)
+        self.components = components  # 函数id -> 分量id
+        self.component_count = component_count
+        self.members = [[] for _ in range(component_count)]  # 分量id -> 函数id列表
+        for node_id, component in enumerate(components):
+            self.members[component].append(node_id)
+
+        # 分量图的后继与前驱；自调用边单独记录，用于判断单函数分量是否递归
+        successors = [set() for _ in range(component_count)]
+        predecessors = [set() for _ in range(component_count)]
+        self._self_loops = set()
+        for source in range(node_count):
+            for position in range(indptr[source], indptr[source + 1]):
+                target = targets[position]
+                source_component = components[source]
+                target_component = components[target]
+                if source_component != target_component:
+                    successors[source_component].add(target_component)
+                    predecessors[target_component].add(source_component)
+                elif source == target:
+                    self._self_loops.add(source_component)
+        self.component_successors = [sorted(items) for items in successors]
+        # 多函数分量的位掩码：统计闭包大小时只需对这些分量补足成员数
+        self._multi_member_mask = 0
+        for component, members in enumerate(self.members):
+            if len(members) > 1:
+                self._multi_member_mask |= 1 << component
+
+        # 分量编号为逆拓扑序（调用边a->b满足a > b），
+        # 按编号递增处理时被调用分量先完成；按编号递减处理时调用分量先完成
+        self._reach = [0] * component_count
+        for component in range(component_count):
+            bits = 1 << component
+            for successor in successors[component]:
+                bits |= self._reach[successor]
+            self._reach[component] = bits
+        self._reached_by = [0] * component_count
+        for component in range(component_count - 1, -1, -1):
+            bits = 1 << component
+            for predecessor in predecessors[component]:
+                bits |= self._reached_by[predecessor]
+            self._reached_by[component] = bits
+
+        self._callee_cache = {}
+        self._caller_cache = {}
+
+    # 分量查询
+    def component_of(self, function):
+        """函数所在分量的编号，函数不在调用图中时返回None"""
+        node_id = self._function_ids.get(function)
+        return None if node_id is None else self.components[node_id]
+
+    def is_recursive_component(self, component):
+        return len(self.members[component]) > 1 or component in self._self_loops
+
+    def is_recursive(self, function):
+        """函数是否直接或间接递归（位于调用环上）"""
+        component = self.component_of(function)
+        return component is not None and self.is_recursive_component(component)
+
+    def recursion_group(self, function):
+        """与函数相互递归的函数列表（含自身），函数不递归时返回空列表"""
+        component = self.component_of(function)
+        if component is None or not self.is_recursive_component(component):
+            return []
+        return [self.functions[node_id] for node_id in self.members[component]]
+
+    def recursive_groups(self):
+        """全部递归函数组"""
+        return [[self.functions[node_id] for node_id in self.members[component]]
+                for component in range(self.component_count) if self.is_recursive_component(component)]
+
+    # 可达性查询
+    def reaches(self, caller, callee):
+        """caller是否可能（经过一次或多次调用）调用到callee"""
+        source = self.component_of(caller)
+        target = self.component_of(callee)
+        if source is None or target is None:
+            return False
+        if source == target:
+            return self.is_recursive_component(source)
+        return bool(self._reach[source] >> target & 1)
+
+    def transitive_callees(self, function):
+        """函数传递可达的全部函数（不含自身，除非函数递归）"""
+        return self._closure(function, self._reach, self._callee_cache)
+
+    def transitive_callers(self, function):
+        """可能传递调用到该函数的全部函数（不含自身，除非函数递归）"""
+        return self._closure(function, self._reached_by, self._caller_cache)
+
+    def _closure(self, function, closures, cache):
+        component = self.component_of(function)
+        if component is None:
+            return frozenset()
+        result = cache.get(component)
+        if result is None:
+            names = set()
+            for reached in _bits(closures[component]):
+                if reached == component and not self.is_recursive_component(component):
+                    continue
+                names.update(self.functions[node_id] for node_id in self.members[reached])
+            result = cache[component] = frozenset(names)
+        return result
+
+    def closure_size(self, function, callers=False):
+        """传递可达（或可达该函数）的函数数，不解码函数名"""
+        component = self.component_of(function)
+        if component is None:
+            return 0
+        bits = (self._reached_by if callers else self._reach)[component]
+        if not self.is_recursive_component(component):
+            bits &= ~(1 << component)
+        return _popcount(bits) + sum(len(self.members[reached]) - 1
+                                    for reached in _bits(bits & self._multi_member_mask))
+
+    def call_chain(self, caller, callees):
+        """caller到callees中任一函数的最短调用链
+        Returns:
+            函数名列表（含两端，caller本身在callees中时为[caller]），不可达时返回None
+        """
+        source = self._function_ids.get(caller)
+        goals = {self._function_ids[name] for name in callees if name in self._function_ids}
+        if source is None or not goals:
+            return None
+        if source in goals:
+            return [caller]
+        goal_mask = 0
+        for goal in goals:
+            goal_mask |= 1 << self.components[goal]
+        if not self._reach[self.components[source]] & goal_mask:
+            return None
+
+        parents = {source: None}
+        queue = deque([source])
+        while queue:
+            node = queue.popleft()
+            for position in range(self._indptr[node], self._indptr[node + 1]):
+                successor = self._targets[position]
+                if successor in parents or not self._reach[self.components[successor]] & goal_mask:
+                    continue
+                parents[successor] = node
+                if successor in goals:
+                    chain = []
+                    while successor is not None:
+                        chain.append(self.functions[successor])
+                        successor = parents[successor]
+                    return chain[::-1]
+                queue.append(successor)
+        return None
+
+    def to_dict(self):
+        """导出为可JSON序列化的字典：分量图（成员和分量间的调用边）以及每个函数的汇总"""
+        return {
+            'components': [
+                {
+                    'id': component,
+                    'functions': [self.functions[node_id] for node_id in self.members[component]],
+                    'recursive': self.is_recursive_component(component),
+                    'calls': self.component_successors[component]
+                }
+                for component in range(self.component_count)
+            ],
+            'recursive_groups': self.recursive_groups(),
+            'functions': {
+                name: {
+                    'component': self.components[node_id],
+                    'recursive': self.is_recursive_component(self.components[node_id]),
+                    'transitive_callees': self.closure_size(name),
+                    'transitive_callers': self.closure_size(name, callers=True)
+                }
+                for node_id, name in enumerate(self.functions)
+            }
+        }
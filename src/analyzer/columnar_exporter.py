@@ -0,0 +1,280 @@
+"""分析结果列式二进制导出模块
+
+把分析结果写成一个目录，每张表的每一列保存为一个numpy .npy文件，
+可用np.load(..., mmap_mode='r')内存映射、零拷贝加载，不需要解析JSON，也不依赖额外的服务。
+
+目录布局（默认 analysis_result.columns/）：
+    manifest.json                  格式版本、每张表的行数和列定义
+    strings.offsets.npy            int64，字符串池偏移，长度为字符串数 + 1
+    strings.bytes.npy              uint8，字符串池内容（UTF-8拼接）
+    <表名>.<列名>.npy               列数据
+
+列类型：
+    string  int32，字符串池中的编号，-1表示空值；第i个字符串为
+            bytes[offsets[i]:offsets[i + 1]].decode('utf-8')
+    int32   整数，-1表示空值
+    bool    uint8，0或1
+
+所有字符串列共用同一个字符串池，因此同一名称在各表中的编号相同，
+表之间可以直接按编号关联（如calls.callee与functions.name）。
+"""
+
+import json
+import os
+from array import array
+
+import numpy as np
+
+from .function_cfg import FunctionCFG
+from .source_location import split_location
+
+
+# 表定义：表名 -> ((列名, 列类型), ...)
+TABLES = {
+    'functions': (
+        ('name', 'string'), ('file', 'string'), ('line', 'int32'),
+        ('start_line', 'int32'), ('end_line', 'int32'), ('return_type', 'string'),
+        ('is_declaration', 'bool'), ('has_body', 'bool'),
+        ('parameter_count', 'int32'), ('call_count', 'int32'),
+        ('basic_blocks', 'int32'), ('loops', 'int32'),
+        ('cyclomatic_complexity', 'int32'), ('max_loop_depth', 'int32'),
+    ),
+    'variables': (
+        ('qualified_name', 'string'), ('name', 'string'), ('kind', 'string'),
+        ('scope', 'string'), ('type', 'string'), ('file', 'string'),
+        ('line', 'int32'), ('column', 'int32'),
+        ('is_pointer', 'bool'), ('is_global', 'bool'), ('is_static', 'bool'), ('is_heap', 'bool'),
+    ),
+    'variable_references': (
+        ('variable', 'string'), ('kind', 'string'), ('function', 'string'),
+        ('argument_index', 'int32'), ('assigned_to', 'string'),
+        ('file', 'string'), ('line', 'int32'), ('column', 'int32'),
+    ),
+    'calls': (
+        ('caller', 'string'), ('callee', 'string'),
+    ),
+    'graph_nodes': (
+        ('graph', 'string'), ('node', 'string'), ('type', 'string'),
+    ),
+    'graph_edges': (
+        ('graph', 'string'), ('source', 'string'), ('target', 'string'),
+        ('type', 'string'), ('via_function', 'string'),
+    ),
+    'local_dfg_nodes': (
+        ('function', 'string'), ('node', 'string'), ('type', 'string'),
+    ),
+    'local_dfg_edges': (
+        ('function', 'string'), ('source', 'string'), ('target', 'string'), ('type', 'string'),
+    ),
+    'side_effects': (
+        ('function', 'string'), ('category', 'string'), ('operation', 'string'),
+        ('subject', 'string'), ('file', 'string'), ('line', 'int32'),
+    ),
+}
+
+COLUMN_DTYPES = {'string': np.int32, 'int32': np.int32, 'bool': np.uint8}
+ARRAY_TYPECODES = {'string': 'i', 'int32': 'i', 'bool': 'B'}
+
+FORMAT_VERSION = 1
+
+
+class _StringPool:
+    """字符串驻留池：字符串 -> 编号"""
+
+    def __init__(self):
+        self._codes = {}
+        self.values = []
+
+    def code(self, value):
+        if value is None:
+            return -1
+        value = str(value)
+        code = self._codes.get(value)
+        if code is None:
+            code = len(self.values)
+            self._codes[value] = code
+            self.values.append(value)
+        return code
+
+
+class _TableBuilder:
+    """按列累积一张表的数据，字符串在追加时即编码为字符串池编号"""
+
+    def __init__(self, name, pool):
+        self.name = name
+        self.schema = TABLES[name]
+        self.pool = pool
+        self.columns = [array(ARRAY_TYPECODES[kind]) for _, kind in self.schema]
+
+    def append(self, *row):
+        for column, (_, kind), value in zip(self.columns, self.schema, row):
+            if kind == 'string':
+                column.append(self.pool.code(value))
+            elif kind == 'bool':
+                column.append(1 if value else 0)
+            else:
+                column.append(-1 if value is None else int(value))
+
+    @property
+    def row_count(self):
+        return len(self.columns[0])
+
+
+class ColumnarResultExporter:
+    """分析结果列式导出器"""
+
+    GRAPHS = (('control_flow', 'cfg'), ('data_flow', 'global_dfg'), ('business_logic', 'business_logic'))
+
+    def __init__(self, output_dir):
+        """初始化导出器
+        Args:
+            output_dir: 输出目录（不存在时创建，已存在的同名列文件会被覆盖）
+        """
+        self.output_dir = output_dir
+
+    def export(self, analyzer):
+        """导出分析器的全部结果，返回 {表名: 行数}"""
+        os.makedirs(self.output_dir, exist_ok=True)
+        pool = _StringPool()
+        tables = {name: _TableBuilder(name, pool) for name in TABLES}
+
+        self._add_functions(analyzer, tables)
+        self._add_variables(analyzer, tables)
+        for call_info in analyzer.function_calls:
+            tables['calls'].append(call_info['caller'], call_info['function'])
+        for graph_name, attribute in self.GRAPHS:
+            graph = getattr(analyzer, attribute)
+            for node, data in graph.nodes(data=True):
+                tables['graph_nodes'].append(graph_name, node, data.get('type'))
+            for source, target, data in graph.edges(data=True):
+                tables['graph_edges'].append(graph_name, source, target, data.get('type'), data.get('via_function'))
+
+        manifest = {'format_version': FORMAT_VERSION, 'string_count': len(pool.values), 'tables': {}}
+        for name, table in tables.items():
+            manifest['tables'][name] = {
+                'rows': table.row_count,
+                'columns': {column: kind for column, kind in table.schema}
+            }
+            for (column_name, kind), column in zip(table.schema, table.columns):
+                self._save(f"{name}.{column_name}", np.asarray(column, dtype=COLUMN_DTYPES[kind]))
+
+        encoded = [value.encode('utf-8') for value in pool.values]
+        offsets = np.zeros(len(encoded) + 1, dtype=np.int64)
+        np.cumsum([len(value) for value in encoded], out=offsets[1:])
+        self._save('strings.offsets', offsets)
+        self._save('strings.bytes', np.frombuffer(b''.join(encoded), dtype=np.uint8))
+
+        with open(os.path.join(self.output_dir, 'manifest.json'), 'w', encoding='utf-8') as f:
+            json.dump(manifest, f, indent=2, ensure_ascii=False)
+
+        return {name: table.row_count for name, table in tables.items()}
+
+    def _save(self, stem, values):
+        np.save(os.path.join(self.output_dir, f"{stem}.npy"), values)
+
+    @staticmethod
+    def _add_functions(analyzer, tables):
+        for name, func_info in analyzer.functions.items():
+            file_name, line, _ = split_location(func_info.get('location'))
+            block_cfg = func_info.get('block_cfg')
+            if isinstance(block_cfg, FunctionCFG):
+                cfg_stats = (block_cfg.block_count, len(block_cfg.loops),
+                             block_cfg.cyclomatic_complexity, block_cfg.max_loop_depth)
+            else:
+                cfg_stats = (None, None, None, None)
+            tables['functions'].append(
+                name, file_name, line, func_info.get('start_line'), func_info.get('end_line'),
+                func_info.get('return_type'), func_info.get('is_declaration', False),
+                func_info.get('has_body', False), len(func_info.get('parameters', [])),
+                len(func_info.get('calls', [])), *cfg_stats)
+
+            local_dfg = func_info.get('local_dfg')
+            if local_dfg is not None:
+                for node, data in local_dfg.nodes(data=True):
+                    tables['local_dfg_nodes'].append(name, node, data.get('type'))
+                for source, target, data in local_dfg.edges(data=True):
+                    tables['local_dfg_edges'].append(name, source, target, data.get('type'))
+
+            for category, effects in func_info.get('side_effects', {}).items():
+                for effect in effects:
+                    if isinstance(effect, dict):
+                        subject = effect.get('variable', effect.get('file', effect.get('target')))
+                        effect_file, effect_line, _ = split_location(effect.get('location'))
+                        tables['side_effects'].append(name, category, effect.get('operation'),
+                                                      subject, effect_file, effect_line)
+                    else:
+                        # 全局变量读写集合中的变量名
+                        tables['side_effects'].append(name, category, None, effect, None, None)
+
+    @staticmethod
+    def _add_variables(analyzer, tables):
+        for qualified_name, symbol in analyzer.symbols.items():
+            tables['variables'].append(
+                qualified_name, symbol.name, symbol.kind, symbol.scope, symbol.type,
+                symbol.file, symbol.line, symbol.column, symbol.is_pointer,
+                symbol.is_global, symbol.is_static, symbol.is_heap and symbol.is_pointer)
+            for ref in symbol.references:
+                if ref.kind == 'argument':
+                    argument_index, assigned_to = ref.target, None
+                else:
+                    argument_index, assigned_to = None, ref.target
+                tables['variable_references'].append(
+                    qualified_name, ref.kind, ref.function, argument_index, assigned_to,
+                    ref.file, ref.line, ref.column)
+
+
+class ColumnarResult:
+    """读取列式导出结果：列数据按需内存映射加载，字符串按编号按需解码
+
+    用法：
+        result = ColumnarResult('output/analysis_result.columns')
+        calls = result.table('calls')
+        free = result.find_string('free')
+        callers = result.strings(calls['caller'][calls['callee'] == free])
+    """
+
+    def __init__(self, path):
+        self.path = path
+        with open(os.path.join(path, 'manifest.json'), 'r', encoding='utf-8') as f:
+            self.manifest = json.load(f)
+        if self.manifest.get('format_version') != FORMAT_VERSION:
+            raise ValueError(f"不支持的列式结果版本: {self.manifest.get('format_version')}")
+        self._offsets = self._load('strings.offsets')
+        self._bytes = self._load('strings.bytes')
+        self._string_codes = None
+
+    @property
+    def tables(self):
+        return list(self.manifest['tables'])
+
+    def table(self, name):
+        """返回 {列名: 内存映射的numpy数组}"""
+        columns = self.manifest['tables'][name]['columns']
+        return {column: self._load(f"{name}.{column}") for column in columns}
+
+    def column(self, table, column):
+        return self._load(f"{table}.{column}")
+
+    def string(self, code):
+        """字符串池编号 -> 字符串，-1返回None"""
+        code = int(code)
+        if code < 0:
+            return None
+        return bytes(self._bytes[self._offsets[code]:self._offsets[code + 1]]).decode('utf-8')
+
+    def strings(self, codes):
+        return [self.string(code) for code in codes]
+
+    def find_string(self, value):
+        """字符串 -> 字符串池编号，不存在时返回-1（首次调用时建立索引）"""
+        if self._string_codes is None:
+            self._string_codes = {self.string(code): code for code in range(len(self._offsets) - 1)}
+        return self._string_codes.get(value, -1)
+
+    def _load(self, stem):
+        file_path = os.path.join(self.path, f"{stem}.npy")
+        try:
+            return np.load(file_path, mmap_mode='r')
+        except ValueError:
+            # 空数组无法内存映射，直接读入
+            return np.load(file_path)
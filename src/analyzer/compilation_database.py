@@ -0,0 +1,153 @@
+"""编译数据库模块
+
+读取compile_commands.json，为每个翻译单元提供真实的编译参数
+（宏定义、include路径及其顺序），替代按平台猜测的include路径。
+"""
+
+import os
+
+import clang.cindex
+
+
+class CompilationDatabase:
+    """compile_commands.json的封装，负责把编译命令整理成libclang可用的参数"""
+
+    # 需要丢弃的单独参数（编译阶段/依赖文件生成相关）
+    DROP_FLAGS = {'-c', '-S', '-E', '-M', '-MM', '-MD', '-MMD', '-MP', '-MG', '-pipe'}
+
+    # 需要丢弃且带一个独立值的参数
+    DROP_FLAGS_WITH_VALUE = {'-o', '-MF', '-MT', '-MQ'}
+
+    # 值为路径、需要相对于编译目录转为绝对路径的参数
+    PATH_FLAGS = ('-I', '-isystem', '-iquote', '-idirafter', '-include', '-imacros',
+                  '-isysroot', '--sysroot', '-F', '-include-pch')
+
+    # 可以与路径直接相连的参数（如-Iinclude、-isystem/usr/include）
+    JOINED_PATH_FLAGS = ('-isystem', '-iquote', '-idirafter', '-I', '-F')
+
+    def __init__(self, path):
+        """加载编译数据库
+        Args:
+            path: compile_commands.json文件路径，或包含该文件的目录
+        """
+        directory = path if os.path.isdir(path) else os.path.dirname(path) or '.'
+        self.directory = os.path.abspath(directory)
+        # 文件不存在或格式错误时抛出clang.cindex.CompilationDatabaseError
+        self._db = clang.cindex.CompilationDatabase.fromDirectory(self.directory)
+        self._args_cache = {}
+
+    def source_files(self):
+        """返回数据库中的全部源文件（绝对路径，按数据库顺序去重）"""
+        files = []
+        seen = set()
+        for command in self._db.getAllCompileCommands() or []:
+            file_path = os.path.normpath(os.path.join(command.directory, command.filename))
+            if file_path not in seen:
+                seen.add(file_path)
+                files.append(file_path)
+        return files
+
+    def get_args(self, file_path):
+        """返回文件的编译参数，数据库中没有该文件时返回None
+
+        数据库中同一文件有多条命令时使用第一条。
+        """
+        abs_path = os.path.normpath(os.path.abspath(file_path))
+        if abs_path in self._args_cache:
+            return self._args_cache[abs_path]
+
+        args = None
+        commands = self._db.getCompileCommands(abs_path)
+        if commands:
+            for command in commands:
+                args = self._normalize_arguments(list(command.arguments), command.directory, command.filename)
+                break
+
+        self._args_cache[abs_path] = args
+        return args
+
+    def include_directories(self, file_paths):
+        """返回这些文件编译参数中的项目include目录（-I和-iquote，不含-isystem等系统目录），按出现顺序去重
+
+        编译数据库中常有-I/usr/include/glib-2.0、-I/opt/...等第三方目录，
+        只保留位于数据库目录或这些源文件公共根目录下的目录。
+        """
+        roots = [self.directory]
+        source_dirs = [os.path.dirname(os.path.normpath(os.path.abspath(f))) for f in file_paths]
+        if source_dirs:
+            common = os.path.commonpath(source_dirs)
+            # 源文件分散在不同分区或根目录下时公共根目录退化为/，不作为项目根目录
+            if os.path.dirname(common) != common:
+                roots.append(common)
+        roots = tuple(os.path.join(os.path.normcase(root), '') for root in roots)
+
+        directories = []
+        for file_path in file_paths:
+            args = self.get_args(file_path) or []
+            for index, arg in enumerate(args):
+                if arg in ('-I', '-iquote'):
+                    directory = args[index + 1] if index + 1 < len(args) else None
+                elif arg.startswith('-iquote') and len(arg) > len('-iquote'):
+                    directory = arg[len('-iquote'):]
+                elif arg.startswith('-I') and len(arg) > 2:
+                    directory = arg[2:]
+                else:
+                    continue
+                if not directory or directory in directories:
+                    continue
+                if os.path.join(os.path.normcase(os.path.normpath(directory)), '').startswith(roots):
+                    directories.append(directory)
+        return directories
+
+    def _normalize_arguments(self, arguments, directory, filename):
+        """去掉编译器名、输入文件和输出相关参数，并把路径参数转为绝对路径"""
+        source = os.path.normpath(os.path.join(directory, filename))
+        args = []
+        skip_next = False
+        pending_path_flag = None
+
+        # 第一个参数是编译器本身
+        for arg in arguments[1:]:
+            if skip_next:
+                skip_next = False
+                continue
+            if pending_path_flag:
+                args.append(self._absolute(arg, directory))
+                pending_path_flag = None
+                continue
+
+            if arg in self.DROP_FLAGS:
+                continue
+            if arg in self.DROP_FLAGS_WITH_VALUE:
+                skip_next = True
+                continue
+            if arg.startswith('-o') and len(arg) > 2:
+                continue
+            if arg.startswith(('-MF', '-MT', '-MQ')) and len(arg) > 3:
+                continue
+
+            # 输入文件由libclang的path参数提供
+            if not arg.startswith('-') and os.path.normpath(os.path.join(directory, arg)) == source:
+                continue
+
+            if arg in self.PATH_FLAGS:
+                args.append(arg)
+                pending_path_flag = arg
+                continue
+
+            joined_flag = next((flag for flag in self.JOINED_PATH_FLAGS
+                                if arg.startswith(flag) and len(arg) > len(flag)), None)
+            if joined_flag:
+                args.append(joined_flag + self._absolute(arg[len(joined_flag):], directory))
+                continue
+            if arg.startswith('--sysroot='):
+                args.append('--sysroot=' + self._absolute(arg[len('--sysroot='):], directory))
+                continue
+
+            args.append(arg)
+
+        return args
+
+    @staticmethod
+    def _absolute(path, directory):
+        return path if os.path.isabs(path) else os.path.normpath(os.path.join(directory, path))
@@ -0,0 +1,168 @@
+"""函数代价模型模块
+
+为每个函数给出静态的算法复杂度估计，以输入规模n的多项式次数表示（O(1)、O(n)、O(n^2)……）：
+- 局部次数：函数体中迭代次数随输入变化的循环的最大嵌套层数，
+  与常量比较的计数循环（i < MAX_TIMERS）不计入，链表遍历循环按一层O(n)计
+- 调用次数：调用点所在的可变循环层数 + 被调函数的次数，未定义的外部函数按O(1)计
+- 函数次数取以上各项的最大值；递归函数组（调用图强连通分量）按线性递归再乘一个n
+
+调用图分量编号为逆拓扑序，按编号递增处理即可保证被调函数先于调用者完成（自底向上）。
+每个入口函数（analysis_options中的entry_points）可达的函数按代价排序，报告代价最高的前N个。
+"""
+
+from .hot_paths import HotPathIndex
+
+
+TOP_N = 10
+
+
+def complexity_label(degree):
+    """多项式次数对应的符号表示"""
+    if degree <= 0:
+        return 'O(1)'
+    if degree == 1:
+        return 'O(n)'
+    return f"O(n^{degree})"
+
+
+class CostModel:
+    """基于循环嵌套和调用图的函数复杂度估计"""
+
+    def __init__(self, analyzer, entry_points=None, top_n=None):
+        self.analyzer = analyzer
+        self.call_graph = analyzer.call_graph
+        self.hot_paths = HotPathIndex(analyzer, entry_points)
+        self.top_n = top_n if top_n is not None else analyzer.options.get('cost_top_n', TOP_N)
+
+    def analyze(self):
+        """计算全部函数的代价
+        Returns:
+            {
+                'functions': {函数名: 代价信息},
+                'entry_points': {入口函数: 可达函数中代价最高的前N个}
+            }
+        """
+        traversals = {}
+        for loop in self.analyzer.list_traversal_report:
+            traversals.setdefault(loop['function'], []).append(loop['line'])
+
+        local = {name: self._local_cost(name, info.get('block_cfg'), traversals.get(name, ()))
+                 for name, info in self.analyzer.functions.items()}
+
+        costs = {}
+        functions = [name for name in local if self.call_graph.component_of(name) is not None]
+        # 分量编号递增：被调函数所在分量先完成
+        components = {}
+        for name in functions:
+            components.setdefault(self.call_graph.component_of(name), []).append(name)
+        for component in sorted(components):
+            members = components[component]
+            recursive = self.call_graph.is_recursive_component(component)
+            for name in members:
+                cost = dict(local[name])
+                cost['degree'] = cost['local_degree']
+                cost['dominant_call'] = None
+                for callee, line, depth, indirect in self.hot_paths.call_sites(name):
+                    callee_cost = costs.get(callee)
+                    if callee_cost is None:
+                        # 外部函数，或同一递归组中尚未完成的函数（由递归加成统一处理）
+                        continue
+                    block_cfg = self.analyzer.functions[name].get('block_cfg')
+                    variable_depth = block_cfg.variable_loop_depth_at(line) if block_cfg is not None else 0
+                    degree = variable_depth + callee_cost['degree']
+                    if degree > cost['degree']:
+                        cost['degree'] = degree
+                        cost['dominant_call'] = {'callee': callee, 'line': line, 'loop_depth': variable_depth,
+                                                 'indirect': indirect}
+                cost['recursive'] = recursive
+                costs[name] = cost
+            if recursive:
+                # 递归调用的次数不可静态确定，按线性递归估计：组内取最大次数再乘n
+                degree = max(costs[name]['degree'] for name in members) + 1
+                for name in members:
+                    costs[name]['degree'] = degree
+
+        for name, cost in costs.items():
+            cost['complexity'] = complexity_label(cost['degree'])
+            cost['local_complexity'] = complexity_label(cost['local_degree'])
+            cost['cost_chain'] = self._cost_chain(name, costs)
+
+        return {
+            'functions': costs,
+            'entry_points': {entry: self._most_expensive(entry, costs) for entry in self.hot_paths.entry_points},
+        }
+
+    @staticmethod
+    def _local_cost(name, block_cfg, traversal_lines):
+        """函数体自身的循环结构"""
+        if block_cfg is None:
+            return {'local_degree': 0, 'max_loop_depth': 0, 'loops': 0, 'constant_loops': 0,
+                    'traversal_loops': 0, 'calls_in_loops': []}
+        loops = block_cfg.loops
+        local_degree = max((block_cfg.variable_loop_depth_at(loop['start_line'])
+                            for loop in loops if not loop['constant_bound']), default=0)
+        calls_in_loops = []
+        for block, calls in sorted(block_cfg.block_calls.items()):
+            depth = block_cfg.block_loop_depth[block]
+            if not depth:
+                continue
+            for callee, line, _, indirect in calls:
+                calls_in_loops.append({'callee': callee, 'line': line, 'loop_depth': depth, 'indirect': indirect})
+        return {
+            'local_degree': local_degree,
+            'max_loop_depth': block_cfg.max_loop_depth,
+            'loops': len(loops),
+            'constant_loops': sum(1 for loop in loops if loop['constant_bound']),
+            'traversal_loops': sum(1 for loop in loops if loop['start_line'] in traversal_lines),
+            'calls_in_loops': calls_in_loops,
+        }
+
+    @staticmethod
+    def _cost_chain(name, costs):
+        """沿决定代价的调用点逐层向下，直到代价由函数自身的循环决定"""
+        chain = [name]
+        current = costs[name].get('dominant_call')
+        while current is not None and current['callee'] not in chain:
+            chain.append(current['callee'])
+            current = costs.get(current['callee'], {}).get('dominant_call')
+        return chain
+
+    @staticmethod
+    def _rank_key(name, cost):
+        return (-cost['degree'], -cost['local_degree'], -cost['loops'], -len(cost['calls_in_loops']), name)
+
+    def _most_expensive(self, entry, costs):
+        reachable = set(self.call_graph.transitive_callees(entry)) | {entry}
+        ranked = sorted((name for name in reachable if name in costs),
+                        key=lambda name: self._rank_key(name, costs[name]))
+        return [
+            {
+                'function': name,
+                'complexity': costs[name]['complexity'],
+                'degree': costs[name]['degree'],
+                'local_complexity': costs[name]['local_complexity'],
+                'call_chain': self.call_graph.call_chain(entry, (name,)),
+            }
+            for name in ranked[:self.top_n]
+        ]
+
+    @staticmethod
+    def summary(report, limit=10):
+        """代价最高的函数的文字摘要"""
+        functions = report['functions']
+        ranked = sorted(functions, key=lambda name: CostModel._rank_key(name, functions[name]))
+        lines = []
+        for name in ranked[:limit]:
+            cost = functions[name]
+            if not cost['degree']:
+                break
+            line = f"{name}: {cost['complexity']} (local {cost['local_complexity']}, {cost['loops']} loop(s)"
+            if cost['traversal_loops']:
+                line += f", {cost['traversal_loops']} list traversal(s)"
+            line += ')'
+            if len(cost['cost_chain']) > 1:
+                line += f" via {' -> '.join(cost['cost_chain'])}"
+            if cost['recursive']:
+                line += ', recursive'
+            lines.append(line)
+        return lines
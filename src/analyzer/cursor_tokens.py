@@ -0,0 +1,106 @@
+"""表达式词法单元查询模块
+
+libclang的Python接口不提供运算符的种类，只能从词法单元中找出运算符符号。
+Cursor.get_tokens()每次都对整个表达式范围重新分词，嵌套表达式的每一层都这样做时
+总代价与表达式长度成平方关系。本模块只对运算符所在的间隙分词：
+- 二元运算符位于左操作数结束与右操作数开始之间
+- 一元运算符位于表达式开始与操作数开始之间（前缀），或操作数结束与表达式结束之间（后缀）
+
+操作数的范围无法定位时（来自宏展开、位于不同文件）退回对整个表达式分词。
+"""
+
+import clang.cindex
+
+
+NULL_CONSTANTS = ('NULL', '0', 'nullptr')
+
+
+def _tokens_between(cursor, start, end):
+    """start到end之间的词法单元（含与end相接的词法单元），范围无法定位时返回空列表
+
+    来自宏展开的操作数（如NULL）的范围端点是宏位置，clang_tokenize无法处理，
+    因此按展开后的文件和偏移重新构造端点。
+    """
+    if start.file is None or end.file is None or start.file.name != end.file.name or end.offset < start.offset:
+        return []
+    tu = cursor.translation_unit
+    SourceLocation = clang.cindex.SourceLocation
+    extent = clang.cindex.SourceRange.from_locations(SourceLocation.from_offset(tu, start.file, start.offset),
+                                                     SourceLocation.from_offset(tu, end.file, end.offset))
+    return tu.get_tokens(extent=extent)
+
+
+def _first_token(tokens, accept):
+    return next((token.spelling for token in tokens if accept(token)), None)
+
+
+def _within(cursor, accept):
+    """在accept之外还要求词法单元位于表达式范围内
+
+    宏参数中的表达式（atomic_fetch_add(&x, 1)中的&x）各端点都落在宏调用处，
+    间隙分词会取到宏名，此时没有合格的词法单元，调用者退回整体分词。
+    """
+    start, end = cursor.extent.start.offset, cursor.extent.end.offset
+    return lambda token: (start <= token.extent.start.offset and token.extent.end.offset <= end
+                          and accept(token))
+
+
+def binary_operator(cursor):
+    """二元运算符的符号（左操作数之后的第一个词法单元）"""
+    operands = list(cursor.get_children())
+    if not operands:
+        return ''
+    lhs_end = operands[0].extent.end.offset
+    accept = (lambda token: token.extent.start.offset >= lhs_end)
+    operator = None
+    if len(operands) == 2:
+        operator = _first_token(_tokens_between(cursor, operands[0].extent.end, operands[1].extent.start),
+                                _within(cursor, accept))
+    if operator is None:
+        operator = _first_token(cursor.get_tokens(), accept)
+    return operator or ''
+
+
+def unary_operator(cursor):
+    """一元运算符的符号：前缀运算符为操作数之前的词法单元，后缀运算符（p++）为操作数之后的词法单元"""
+    operand = next(cursor.get_children(), None)
+    if operand is None:
+        token = next(cursor.get_tokens(), None)
+        return token.spelling if token is not None else ''
+    start, end = cursor.extent.start, cursor.extent.end
+    operand_start, operand_end = operand.extent.start.offset, operand.extent.end.offset
+    if operand_start > start.offset:
+        operator = _first_token(_tokens_between(cursor, start, operand.extent.start),
+                                _within(cursor, lambda token: token.extent.end.offset <= operand_start))
+    else:
+        operator = _first_token(_tokens_between(cursor, operand.extent.end, end),
+                                _within(cursor, lambda token: token.extent.start.offset >= operand_end))
+    if operator is None:
+        # 宏展开等无法定位操作数的情况：取操作数范围之外的第一个词法单元
+        operator = _first_token(cursor.get_tokens(), lambda token: token.extent.end.offset <= operand_start
+                                or token.extent.start.offset >= operand_end)
+    return operator or ''
+
+
+def token_text(cursor):
+    """表达式的源码（词法单元直接相连，不含空白）"""
+    if cursor is None:
+        return ''
+    return ''.join(token.spelling for token in cursor.get_tokens())
+
+
+def callee_text(call_expr):
+    """调用表达式中被调用者的源码（间接调用的函数指针表达式，如timer->callback）"""
+    return token_text(next(call_expr.get_children(), None))
+
+
+def is_null_constant(expr, constants=NULL_CONSTANTS):
+    """表达式是否为空指针常量（NULL、0等单个词法单元）"""
+    if expr is None:
+        return True
+    extent = expr.extent
+    # 单个词法单元的范围不会超过最长的常量名，较长的表达式不必分词
+    if extent.start.file is not None and extent.end.offset - extent.start.offset > max(map(len, constants)):
+        return False
+    tokens = [token.spelling for token in expr.get_tokens()]
+    return len(tokens) == 1 and tokens[0] in constants
@@ -0,0 +1,173 @@
+"""堆分配逃逸分析模块
+
+heap_vars只标记指向堆内存的指针变量，不区分分配的对象是否离开分配它的函数。
+本模块以指针分析中的堆分配点对象为单位，按对象出现在哪些节点的指向集合中分类：
+- global：存入全局/静态变量
+- heap：存入结构体字段或经指针写入其他对象（链表节点、容器等堆上结构）
+- thread：作为线程参数传给pthread_create/thrd_create
+- external：传给没有函数体、且不在已知不保留指针列表中的外部函数
+- returned：由分配它的函数返回，调用者中只由局部变量持有
+- local：只由分配函数内的局部变量持有（可以经参数借给被调函数）
+
+指针分析是过程间的，实参流入被调函数形参、返回值流入调用者变量都已体现在指向集合中，
+因此存入全局变量或字段的被调函数、以及接收返回值后再存储的调用者都会被计入。
+分配函数之外持有对象的函数附带与分配函数之间的调用链。
+
+local的分配点可以改为栈上分配，returned的分配点可以改为从调用者提供的arena中分配。
+"""
+
+from .allocation_analysis import FREE_FUNCTIONS
+from .lock_analysis import sync_operation
+from .shared_state import THREAD_CREATE_FUNCTIONS
+from .source_location import location_line
+
+
+# 不保留指针实参的外部函数
+NON_RETAINING_FUNCTIONS = FREE_FUNCTIONS + (
+    'realloc', 'memset', 'memcpy', 'memmove', 'memcmp', 'strcpy', 'strncpy', 'strcat', 'strncat',
+    'strlen', 'strnlen', 'strcmp', 'strncmp', 'strchr', 'strrchr', 'strstr', 'printf', 'fprintf',
+    'sprintf', 'snprintf', 'puts', 'fputs', 'fgets', 'fread', 'fwrite', 'qsort', 'bsearch',
+)
+ESCAPE_ORDER = ('global', 'heap', 'thread', 'external', 'returned', 'local')
+
+
+class EscapeAnalyzer:
+    """堆分配点的逃逸分类"""
+
+    def __init__(self, analyzer):
+        self.analyzer = analyzer
+        self.points_to = analyzer.points_to
+        self.call_graph = analyzer.call_graph
+
+    def analyze(self):
+        """返回逃逸分析报告
+        Returns:
+            {
+                'sites': 分配点列表（逃逸程度最低的排在前面，即最适合改为栈或arena分配的）,
+                'by_escape': {逃逸类别: 分配点数}
+            }
+        """
+        holders = self._holders()
+        sites = []
+        for object_id, obj in enumerate(self.points_to.objects):
+            if obj['kind'] != 'heap':
+                continue
+            sites.append(self._classify(object_id, obj, holders.get(object_id, {})))
+
+        sites.sort(key=lambda site: (-ESCAPE_ORDER.index(site['escape']), -site['loop_depth'],
+                                     site['function'] or '', site['line']))
+        by_escape = {}
+        for site in sites:
+            by_escape[site['escape']] = by_escape.get(site['escape'], 0) + 1
+        return {'sites': sites, 'by_escape': by_escape}
+
+    def _holders(self):
+        """对象id -> {逃逸位置类别: [名称]}，由每个节点的指向集合反查"""
+        symbols = {symbol.id: symbol for symbol in self.analyzer.symbols.symbols()}
+        holders = {}
+        for node_id, key in enumerate(self.points_to.node_keys):
+            object_ids = [object_id for object_id in self.points_to.points_to(node_id)
+                          if self.points_to.objects[object_id]['kind'] == 'heap']
+            if not object_ids:
+                continue
+            kind = key[0]
+            if kind == 'symbol':
+                symbol = symbols.get(key[1])
+                if symbol is None:
+                    continue
+                if symbol.is_global_or_static:
+                    slot, name = 'global', symbol.qualified_name
+                else:
+                    slot, name = 'local', (symbol.scope, symbol.qualified_name)
+            elif kind in ('field', 'object'):
+                # 结构体字段或堆对象的内容（经*p = q写入）
+                slot, name = 'heap', self.points_to.node_labels[node_id]
+            elif kind == 'return':
+                slot, name = 'returned', key[1]
+            elif kind == 'param':
+                slot, name = 'param', (key[1], key[2])
+            else:
+                continue
+            for object_id in object_ids:
+                names = holders.setdefault(object_id, {}).setdefault(slot, [])
+                if name not in names:
+                    names.append(name)
+        return holders
+
+    def _classify(self, object_id, obj, holders):
+        function = obj['function']
+        line = location_line(obj['location'])
+        block_cfg = self.analyzer.functions.get(function, {}).get('block_cfg') if function else None
+
+        escapes = {}
+        if holders.get('global'):
+            escapes['global'] = sorted(holders['global'])
+        if holders.get('heap'):
+            escapes['heap'] = sorted(holders['heap'])
+        for callee, index in holders.get('param', []):
+            if callee in THREAD_CREATE_FUNCTIONS and index == THREAD_CREATE_FUNCTIONS[callee][1]:
+                escapes.setdefault('thread', []).append(callee)
+            elif self._retains(callee):
+                escapes.setdefault('external', []).append(f"{callee}#arg{index}")
+        returned_by = sorted(holders.get('returned', []))
+        if function in returned_by:
+            escapes['returned'] = returned_by
+
+        held_in = sorted({scope for scope, _ in holders.get('local', []) if scope})
+        escape = next((kind for kind in ESCAPE_ORDER if kind in escapes), 'local')
+        if escape == 'local' and any(scope != function and self.call_graph.reaches(scope, function)
+                                     and not self.call_graph.reaches(function, scope) for scope in held_in):
+            # 调用者的局部变量持有对象（经间接途径传回）：生存期超出分配函数，按返回处理；
+            # 被调函数经参数持有只是借用
+            escape = 'returned'
+
+        if escape == 'local':
+            candidate = 'stack'
+        elif escape == 'returned':
+            candidate = 'arena'
+        else:
+            candidate = None
+        return {
+            'object': object_id,
+            'function': function,
+            'line': line,
+            'location': obj['location'],
+            'allocator': obj['allocator'],
+            'loop_depth': block_cfg.loop_depth_at(line) if block_cfg is not None else 0,
+            'escape': escape,
+            'escapes': escapes,
+            'held_in': held_in,
+            'holder_chains': {scope: self._holder_chain(function, scope) for scope in held_in if scope != function},
+            'candidate': candidate,
+        }
+
+    def _retains(self, callee):
+        """外部函数是否可能保留指针实参"""
+        func_info = self.analyzer.functions.get(callee)
+        if func_info is not None and func_info.get('has_body'):
+            # 有函数体的被调函数的存储已体现在指向集合中
+            return False
+        return callee not in NON_RETAINING_FUNCTIONS and sync_operation(callee) is None
+
+    def _holder_chain(self, function, holder):
+        """持有者与分配函数之间的调用链：持有者调用到分配函数（经返回值得到对象），或分配函数调用到持有者"""
+        if function is None:
+            return [holder]
+        if self.call_graph.reaches(holder, function):
+            return self.call_graph.call_chain(holder, (function,))
+        if self.call_graph.reaches(function, holder):
+            return self.call_graph.call_chain(function, (holder,))
+        return [holder]
+
+    @staticmethod
+    def summary(report, limit=10):
+        lines = []
+        for site in report['sites'][:limit]:
+            line = f"{site['allocator']}() in {site['function']}:{site['line']}: {site['escape']}"
+            details = site['escapes'].get(site['escape'])
+            if details:
+                line += f" ({', '.join(details)})"
+            if site['candidate']:
+                line += f" -> {site['candidate']} allocation candidate"
+            lines.append(line)
+        return lines
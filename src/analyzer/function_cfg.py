@@ -0,0 +1,490 @@
+"""函数内部控制流图模块
+
+self.cfg记录的是函数之间的调用关系。本模块为每个函数定义构建语句级的控制流图：
+把函数体划分为基本块，按IF/WHILE/DO/FOR/SWITCH/BREAK/CONTINUE/RETURN/GOTO
+连接分支边，并记录循环头、循环嵌套深度以及每个基本块中的函数调用，
+用于定位热点循环（如timer_update中遍历定时器链表的循环）。
+
+基本块和边的属性按列保存在紧凑的整数数组中，不为每个语句创建图节点。
+"""
+
+from array import array
+
+import clang.cindex
+
+from .cursor_tokens import binary_operator, callee_text
+
+
+class FunctionCFG:
+    """单个函数的基本块控制流图"""
+
+    BLOCK_KINDS = ('entry', 'exit', 'basic', 'condition', 'loop_header', 'case', 'label')
+    EDGE_KINDS = ('fallthrough', 'true', 'false', 'back', 'case', 'return', 'break', 'continue', 'goto')
+
+    _BLOCK_CODES = {kind: code for code, kind in enumerate(BLOCK_KINDS)}
+    _EDGE_CODES = {kind: code for code, kind in enumerate(EDGE_KINDS)}
+
+    def __init__(self, name):
+        self.name = name
+        # 基本块属性（按块id索引的列）
+        self.block_kind = array('b')
+        self.block_start_line = array('i')
+        self.block_end_line = array('i')
+        self.block_statements = array('i')
+        self.block_loop_depth = array('h')
+        self.block_calls = {}  # 块id -> [(被调函数, 行号, 列号, 是否间接调用)]，按源码顺序，只记录包含调用的块
+        # 边属性（按边id索引的列）
+        self.edge_source = array('i')
+        self.edge_target = array('i')
+        self.edge_kind = array('b')
+        # 循环信息
+        self.loops = []
+        self.entry = None
+        self.exit = None
+        self._successors = None
+
+    @property
+    def block_count(self):
+        return len(self.block_kind)
+
+    @property
+    def edge_count(self):
+        return len(self.edge_source)
+
+    def add_block(self, kind, loop_depth, line=0):
+        self.block_kind.append(self._BLOCK_CODES[kind])
+        self.block_start_line.append(line)
+        self.block_end_line.append(line)
+        self.block_statements.append(0)
+        self.block_loop_depth.append(loop_depth)
+        self._successors = None
+        return len(self.block_kind) - 1
+
+    def mark_condition(self, block):
+        """以条件分支结束的普通基本块标记为条件块（循环头等保持原类型）"""
+        if self.block_kind[block] == self._BLOCK_CODES['basic']:
+            self.block_kind[block] = self._BLOCK_CODES['condition']
+
+    def add_edge(self, source, target, kind):
+        self.edge_source.append(source)
+        self.edge_target.append(target)
+        self.edge_kind.append(self._EDGE_CODES[kind])
+        self._successors = None
+
+    def add_statement(self, block, start_line, end_line):
+        if self.block_statements[block] == 0 or self.block_start_line[block] == 0:
+            self.block_start_line[block] = start_line
+        if end_line > self.block_end_line[block]:
+            self.block_end_line[block] = end_line
+        self.block_statements[block] += 1
+
+    def add_call(self, block, callee, line, column, indirect):
+        self.block_calls.setdefault(block, []).append((callee, line, column, indirect))
+
+    def successors(self, block):
+        """返回[(后继块id, 边类型)]"""
+        if self._successors is None:
+            successors = [[] for _ in range(self.block_count)]
+            for source, target, kind in zip(self.edge_source, self.edge_target, self.edge_kind):
+                successors[source].append((target, self.EDGE_KINDS[kind]))
+            self._successors = successors
+        return self._successors[block]
+
+    def block_kind_name(self, block):
+        return self.BLOCK_KINDS[self.block_kind[block]]
+
+    def reachable_blocks(self):
+        """从入口可达的基本块集合"""
+        seen = {self.entry}
+        stack = [self.entry]
+        while stack:
+            block = stack.pop()
+            for successor, _ in self.successors(block):
+                if successor not in seen:
+                    seen.add(successor)
+                    stack.append(successor)
+        return seen
+
+    @property
+    def cyclomatic_complexity(self):
+        """圈复杂度 E - N + 2（只统计从入口可达的部分）"""
+        reachable = self.reachable_blocks()
+        edges = sum(1 for source in self.edge_source if source in reachable)
+        return edges - len(reachable) + 2
+
+    def loop_depth_at(self, line):
+        """源码行所在的循环嵌套深度（不在循环中为0）"""
+        return max((loop['depth'] for loop in self.loops if loop['start_line'] <= line <= loop['end_line']), default=0)
+
+    def variable_loop_depth_at(self, line):
+        """源码行外层循环中迭代次数随输入变化的循环层数（不计常量上界的循环）"""
+        return sum(1 for loop in self.loops
+                   if loop['start_line'] <= line <= loop['end_line'] and not loop['constant_bound'])
+
+    @property
+    def max_loop_depth(self):
+        return max(self.block_loop_depth, default=0)
+
+    def to_dict(self):
+        """按列导出为可JSON序列化的字典"""
+        return {
+            'entry': self.entry,
+            'exit': self.exit,
+            'blocks': {
+                'kind': [self.BLOCK_KINDS[code] for code in self.block_kind],
+                'start_line': self.block_start_line.tolist(),
+                'end_line': self.block_end_line.tolist(),
+                'statements': self.block_statements.tolist(),
+                'loop_depth': self.block_loop_depth.tolist()
+            },
+            'edges': {
+                'source': self.edge_source.tolist(),
+                'target': self.edge_target.tolist(),
+                'kind': [self.EDGE_KINDS[code] for code in self.edge_kind]
+            },
+            'calls': {
+                str(block): [[callee, line, column, indirect] for callee, line, column, indirect in calls]
+                for block, calls in self.block_calls.items()
+            },
+            'loops': self.loops,
+            'cyclomatic_complexity': self.cyclomatic_complexity,
+            'max_loop_depth': self.max_loop_depth
+        }
+
+
+class FunctionCFGBuilder:
+    """从函数定义游标构建FunctionCFG"""
+
+    LOOP_KINDS = {
+        clang.cindex.CursorKind.WHILE_STMT: 'while',
+        clang.cindex.CursorKind.DO_STMT: 'do',
+        clang.cindex.CursorKind.FOR_STMT: 'for',
+    }
+
+    def build(self, func_cursor):
+        cfg = FunctionCFG(func_cursor.spelling)
+        self.cfg = cfg
+        self.loop_depth = 0
+        self.break_targets = []
+        self.continue_targets = []
+        self.switch_heads = []  # [(switch条件所在块, 是否有default)]
+        self.labels = {}
+        self.pending_gotos = []
+
+        cfg.entry = cfg.add_block('entry', 0, func_cursor.extent.start.line)
+        cfg.exit = cfg.add_block('exit', 0, func_cursor.extent.end.line)
+
+        body = None
+        for child in func_cursor.get_children():
+            if child.kind == clang.cindex.CursorKind.COMPOUND_STMT:
+                body = child
+        current = cfg.add_block('basic', 0)
+        cfg.add_edge(cfg.entry, current, 'fallthrough')
+        if body is not None:
+            current = self._visit(body, current)
+        if current is not None:
+            cfg.add_edge(current, cfg.exit, 'fallthrough')
+
+        for block, label in self.pending_gotos:
+            target = self.labels.get(label)
+            if target is not None:
+                cfg.add_edge(block, target, 'goto')
+        return cfg
+
+    def _new_block(self, kind='basic', line=0):
+        return self.cfg.add_block(kind, self.loop_depth, line)
+
+    def _ensure_block(self, current):
+        """break/return之后的语句不可达，放入新的基本块"""
+        return current if current is not None else self._new_block()
+
+    def _add_statement(self, block, stmt):
+        """把语句（或条件表达式）加入基本块，并记录其中的函数调用"""
+        self.cfg.add_statement(block, stmt.extent.start.line, stmt.extent.end.line)
+        stack = [stmt]
+        while stack:
+            node = stack.pop()
+            if node.kind == clang.cindex.CursorKind.CALL_EXPR:
+                callee = node.referenced
+                indirect = callee is None or callee.kind != clang.cindex.CursorKind.FUNCTION_DECL
+                self.cfg.add_call(block, node.spelling or callee_text(node), node.location.line,
+                                  node.location.column, indirect)
+            # 子节点逆序入栈，按源码顺序访问（同一语句中的加锁、解锁保持先后次序）
+            stack.extend(reversed(list(node.get_children())))
+
+    def _visit(self, stmt, current):
+        """处理语句，返回语句之后控制流所在的基本块（不可达时返回None）"""
+        kind = stmt.kind
+        CursorKind = clang.cindex.CursorKind
+
+        if kind == CursorKind.COMPOUND_STMT:
+            for child in stmt.get_children():
+                current = self._visit(child, current)
+            return current
+
+        if kind == CursorKind.IF_STMT:
+            return self._visit_if(stmt, current)
+        if kind in self.LOOP_KINDS:
+            return self._visit_loop(stmt, current)
+        if kind == CursorKind.SWITCH_STMT:
+            return self._visit_switch(stmt, current)
+
+        if kind in (CursorKind.CASE_STMT, CursorKind.DEFAULT_STMT):
+            block = self._new_block('case', stmt.extent.start.line)
+            if self.switch_heads:
+                head, has_default = self.switch_heads[-1]
+                self.cfg.add_edge(head, block, 'case')
+                if kind == CursorKind.DEFAULT_STMT:
+                    self.switch_heads[-1] = (head, True)
+            if current is not None:
+                self.cfg.add_edge(current, block, 'fallthrough')
+            children = list(stmt.get_children())
+            return self._visit(children[-1], block) if children else block
+
+        if kind == CursorKind.LABEL_STMT:
+            block = self._new_block('label', stmt.extent.start.line)
+            self.labels[stmt.spelling] = block
+            if current is not None:
+                self.cfg.add_edge(current, block, 'fallthrough')
+            children = list(stmt.get_children())
+            return self._visit(children[-1], block) if children else block
+
+        if kind == CursorKind.BREAK_STMT:
+            current = self._ensure_block(current)
+            if self.break_targets:
+                self.cfg.add_edge(current, self.break_targets[-1], 'break')
+            return None
+
+        if kind == CursorKind.CONTINUE_STMT:
+            current = self._ensure_block(current)
+            if self.continue_targets:
+                self.cfg.add_edge(current, self.continue_targets[-1], 'continue')
+            return None
+
+        if kind == CursorKind.RETURN_STMT:
+            current = self._ensure_block(current)
+            self._add_statement(current, stmt)
+            self.cfg.add_edge(current, self.cfg.exit, 'return')
+            return None
+
+        if kind == CursorKind.GOTO_STMT:
+            current = self._ensure_block(current)
+            self._add_statement(current, stmt)
+            label = next((child.spelling for child in stmt.get_children()
+                          if child.kind == CursorKind.LABEL_REF), None)
+            if label:
+                self.pending_gotos.append((current, label))
+            return None
+
+        if kind == CursorKind.NULL_STMT:
+            return current
+
+        # 表达式语句、声明语句等顺序执行的语句
+        current = self._ensure_block(current)
+        self._add_statement(current, stmt)
+        return current
+
+    def _visit_if(self, stmt, current):
+        children = list(stmt.get_children())
+        condition, then_stmt = children[0], children[1]
+        else_stmt = children[2] if len(children) > 2 else None
+
+        current = self._ensure_block(current)
+        self._add_statement(current, condition)
+        self.cfg.mark_condition(current)
+
+        then_block = self._new_block(line=then_stmt.extent.start.line)
+        self.cfg.add_edge(current, then_block, 'true')
+        then_end = self._visit(then_stmt, then_block)
+
+        else_end = current
+        if else_stmt is not None:
+            else_block = self._new_block(line=else_stmt.extent.start.line)
+            self.cfg.add_edge(current, else_block, 'false')
+            else_end = self._visit(else_stmt, else_block)
+
+        if then_end is None and else_end is None:
+            return None
+        join = self._new_block()
+        if then_end is not None:
+            self.cfg.add_edge(then_end, join, 'fallthrough')
+        if else_end is not None:
+            self.cfg.add_edge(else_end, join, 'false' if else_stmt is None else 'fallthrough')
+        return join
+
+    def _visit_loop(self, stmt, current):
+        CursorKind = clang.cindex.CursorKind
+        loop_kind = self.LOOP_KINDS[stmt.kind]
+        children = list(stmt.get_children())
+        current = self._ensure_block(current)
+
+        init = condition = increment = None
+        if stmt.kind == CursorKind.WHILE_STMT:
+            condition, body = children[0], children[-1]
+        elif stmt.kind == CursorKind.DO_STMT:
+            body, condition = children[0], children[-1]
+        else:
+            body = children[-1]
+            init, condition, increment = self._for_parts(stmt, children[:-1])
+            if init is not None:
+                self._add_statement(current, init)
+
+        after = self._new_block()
+        self.loop_depth += 1
+        first_block = self.cfg.block_count
+
+        header = self._new_block('loop_header', stmt.extent.start.line)
+        self.cfg.add_edge(current, header, 'fallthrough')
+
+        if stmt.kind == CursorKind.DO_STMT:
+            # do-while：循环体入口即循环头，条件在循环体之后判断
+            condition_block = self._new_block('condition', condition.extent.start.line)
+            self.break_targets.append(after)
+            self.continue_targets.append(condition_block)
+            body_end = self._visit(body, header)
+            if body_end is not None:
+                self.cfg.add_edge(body_end, condition_block, 'fallthrough')
+            self._add_statement(condition_block, condition)
+            self.cfg.add_edge(condition_block, header, 'back')
+            self.cfg.add_edge(condition_block, after, 'false')
+        else:
+            if condition is not None:
+                self._add_statement(header, condition)
+                self.cfg.add_edge(header, after, 'false')
+            body_block = self._new_block(line=body.extent.start.line)
+            self.cfg.add_edge(header, body_block, 'true')
+
+            continue_target = header
+            increment_block = None
+            if increment is not None:
+                increment_block = self._new_block(line=increment.extent.start.line)
+                self._add_statement(increment_block, increment)
+                self.cfg.add_edge(increment_block, header, 'back')
+                continue_target = increment_block
+
+            self.break_targets.append(after)
+            self.continue_targets.append(continue_target)
+            body_end = self._visit(body, body_block)
+            if body_end is not None:
+                if increment_block is not None:
+                    self.cfg.add_edge(body_end, increment_block, 'fallthrough')
+                else:
+                    self.cfg.add_edge(body_end, header, 'back')
+
+        self.break_targets.pop()
+        self.continue_targets.pop()
+
+        blocks = list(range(first_block, self.cfg.block_count))
+        calls = []
+        for block in blocks:
+            calls.extend(call[0] for call in self.cfg.block_calls.get(block, ()))
+        self.cfg.loops.append({
+            'header': header,
+            'kind': loop_kind,
+            'start_line': stmt.extent.start.line,
+            'end_line': stmt.extent.end.line,
+            'depth': self.loop_depth,
+            'constant_bound': self._constant_bound(condition),
+            'blocks': blocks,
+            'calls': calls
+        })
+        self.loop_depth -= 1
+        return after
+
+    def _visit_switch(self, stmt, current):
+        children = list(stmt.get_children())
+        condition, body = children[0], children[-1]
+
+        current = self._ensure_block(current)
+        self._add_statement(current, condition)
+        self.cfg.mark_condition(current)
+
+        after = self._new_block()
+        self.break_targets.append(after)
+        self.switch_heads.append((current, False))
+        # 第一个case之前的语句不可达
+        body_end = self._visit(body, None)
+        head, has_default = self.switch_heads.pop()
+        self.break_targets.pop()
+
+        if body_end is not None:
+            self.cfg.add_edge(body_end, after, 'fallthrough')
+        if not has_default:
+            self.cfg.add_edge(head, after, 'false')
+        return after
+
+    COMPARISON_OPERATORS = ('<', '<=', '>', '>=', '!=')
+
+    @classmethod
+    def _constant_bound(cls, condition):
+        """循环条件是否为与常量的比较（i < 10、i < MAX_TIMERS、i != COUNT）
+
+        常量操作数中只能出现字面量、sizeof和枚举常量，不能引用变量、字段或调用函数。
+        指针比较（p != NULL）、没有条件的循环（for (;;)）和while (1)不视为常量上界。
+        """
+        CursorKind = clang.cindex.CursorKind
+        while condition is not None and condition.kind in (CursorKind.UNEXPOSED_EXPR, CursorKind.PAREN_EXPR):
+            condition = next(condition.get_children(), None)
+        if condition is None or condition.kind != CursorKind.BINARY_OPERATOR:
+            return False
+        operands = list(condition.get_children())
+        if len(operands) != 2:
+            return False
+        if binary_operator(condition) not in cls.COMPARISON_OPERATORS:
+            return False
+        if any(operand.type.get_canonical().kind == clang.cindex.TypeKind.POINTER for operand in operands):
+            # 与NULL比较的是链表等数据结构的遍历，迭代次数取决于数据规模
+            return False
+
+        def is_constant(expr):
+            stack = [expr]
+            while stack:
+                node = stack.pop()
+                if node.kind == CursorKind.CXX_UNARY_EXPR:
+                    # sizeof/alignof在编译期求值，不展开操作数
+                    continue
+                if node.kind in (CursorKind.CALL_EXPR, CursorKind.MEMBER_REF_EXPR,
+                                 CursorKind.ARRAY_SUBSCRIPT_EXPR):
+                    return False
+                if node.kind == CursorKind.DECL_REF_EXPR:
+                    declaration = node.referenced
+                    if declaration is None or declaration.kind != CursorKind.ENUM_CONSTANT_DECL:
+                        return False
+                stack.extend(node.get_children())
+            return True
+
+        return any(is_constant(operand) for operand in operands)
+
+    @staticmethod
+    def _for_parts(stmt, parts):
+        """区分for语句头部的初始化、条件和增量部分
+
+        libclang会省略缺失的部分，因此按子节点相对于头部两个分号的位置判断。
+        """
+        semicolons = []
+        depth = 0
+        for token in stmt.get_tokens():
+            spelling = token.spelling
+            if spelling == '(':
+                depth += 1
+            elif spelling == ')':
+                depth -= 1
+                if depth == 0:
+                    break
+            elif spelling == ';' and depth == 1:
+                semicolons.append(token.extent.start.offset)
+
+        init = condition = increment = None
+        if len(semicolons) < 2:
+            # 头部来自宏展开等无法定位分号的情况，按顺序对应
+            parts = list(parts) + [None] * (3 - len(parts))
+            return parts[0], parts[1], parts[2]
+        for part in parts:
+            offset = part.extent.start.offset
+            if offset < semicolons[0]:
+                init = part
+            elif offset < semicolons[1]:
+                condition = part
+            else:
+                increment = part
+        return init, condition, increment
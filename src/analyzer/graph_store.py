@@ -0,0 +1,470 @@
+"""紧凑图存储模块
+
+以整数编号存储有向图，替代控制流图、数据流图和业务逻辑图所用的networkx.DiGraph：
+- 节点键（函数名、变量限定名等）驻留为连续的整数id
+- 边保存在两个整数数组中（源节点id、目标节点id），查询前后继时按需整理为CSR数组（numpy），
+  重复添加的边在整理时合并属性；按边查询时在按目标节点排序的CSR列切片上二分查找，不为每条边维护字典
+- 节点和边的属性按列存储：每个属性一列，列中保存取值编码，取值本身只存一份
+
+对分析器内部使用的接口（add_node、add_edge、nodes、edges、successors、predecessors、
+has_edge等）与networkx.DiGraph保持一致。布局、绘图和社区检测等networkx算法
+通过networkx_view获取按需构建并缓存的networkx.DiGraph视图。
+"""
+
+from array import array
+from collections import namedtuple
+
+import networkx as nx
+import numpy as np
+
+
+def strongly_connected_components(node_count, indptr, targets):
+    """迭代Tarjan算法求强连通分量
+
+    Args:
+        node_count: 节点数
+        indptr: CSR行指针（长度node_count + 1）
+        targets: CSR列索引
+    Returns:
+        (components, component_count)。components[v]为节点v所属分量的编号，
+        编号按逆拓扑序分配：若存在跨分量的边a->b，则components[a] > components[b]
+    """
+    index = [-1] * node_count
+    low = [0] * node_count
+    on_stack = [False] * node_count
+    components = [-1] * node_count
+    stack = []
+    counter = 0
+    component_count = 0
+
+    for root in range(node_count):
+        if index[root] != -1:
+            continue
+        index[root] = low[root] = counter
+        counter += 1
+        stack.append(root)
+        on_stack[root] = True
+        work = [(root, indptr[root])]
+
+        while work:
+            node, position = work[-1]
+            if position < indptr[node + 1]:
+                work[-1] = (node, position + 1)
+                successor = targets[position]
+                if index[successor] == -1:
+                    index[successor] = low[successor] = counter
+                    counter += 1
+                    stack.append(successor)
+                    on_stack[successor] = True
+                    work.append((successor, indptr[successor]))
+                elif on_stack[successor] and index[successor] < low[node]:
+                    low[node] = index[successor]
+                continue
+
+            work.pop()
+            if work:
+                parent = work[-1][0]
+                if low[node] < low[parent]:
+                    low[parent] = low[node]
+            if low[node] == index[node]:
+                while True:
+                    member = stack.pop()
+                    on_stack[member] = False
+                    components[member] = component_count
+                    if member == node:
+                        break
+                component_count += 1
+
+    return components, component_count
+
+
+def build_csr(node_count, sources, targets):
+    """把边列表整理为去重后的CSR数组（numpy）
+
+    Returns:
+        (indptr, columns, sources, targets)，后两者为去重后的边
+    """
+    sources = np.asarray(sources, dtype=np.int64)
+    targets = np.asarray(targets, dtype=np.int64)
+    if len(sources):
+        edges = np.unique(sources * node_count + targets)
+        sources = edges // node_count
+        targets = edges % node_count
+    indptr = np.zeros(node_count + 1, dtype=np.int64)
+    np.cumsum(np.bincount(sources, minlength=node_count), out=indptr[1:])
+    # np.unique的结果已按源节点排序
+    return indptr, targets, sources, targets
+
+
+def _int64_view(values):
+    """array('q')的numpy视图（不复制；视图存在期间不能再向array追加元素）"""
+    return np.frombuffer(values, dtype=np.int64) if values else np.zeros(0, np.int64)
+
+
+def networkx_view(graph):
+    """返回可直接交给networkx算法和绘图函数的图
+
+    CompactDiGraph返回其缓存的networkx.DiGraph视图，networkx图原样返回。
+    """
+    if isinstance(graph, CompactDiGraph):
+        return graph.as_networkx()
+    return graph
+
+
+class _Column:
+    """按列存储的属性：每个元素保存取值编码（-1表示未设置），取值表中每个不同的值只存一份"""
+
+    __slots__ = ('codes', 'values', '_value_codes')
+
+    def __init__(self, length):
+        self.codes = array('i', [-1]) * length
+        self.values = []  # 编码 -> 取值
+        self._value_codes = {}  # 取值 -> 编码
+
+    def set(self, index, value):
+        code = self._value_codes.get(value)
+        if code is None:
+            code = len(self.values)
+            self._value_codes[value] = code
+            self.values.append(value)
+        self.codes[index] = code
+
+
+class _AttributeTable:
+    """一组按列存储的属性，行号为节点id或边id"""
+
+    __slots__ = ('length', 'columns')
+
+    def __init__(self):
+        self.length = 0
+        self.columns = {}  # 属性名 -> _Column
+
+    def append_row(self):
+        self.length += 1
+        for column in self.columns.values():
+            column.codes.append(-1)
+
+    def update(self, row, attributes):
+        for name, value in attributes.items():
+            column = self.columns.get(name)
+            if column is None:
+                column = self.columns[name] = _Column(self.length)
+            column.set(row, value)
+
+    def merge_rows(self, rows, into):
+        """把rows中各行已设置的属性依次写入into中对应的行（后写入的覆盖先写入的）"""
+        for column in self.columns.values():
+            codes = column.codes
+            for row, target in zip(rows, into):
+                if codes[row] >= 0:
+                    codes[target] = codes[row]
+
+    def take(self, rows):
+        """只保留rows（numpy整数数组）中的行，按rows的顺序重新编号"""
+        table = _AttributeTable()
+        table.length = len(rows)
+        for name, column in self.columns.items():
+            taken = _Column(0)
+            taken.codes = array('i', np.frombuffer(column.codes, dtype=np.int32)[rows].tobytes())
+            taken.values = column.values
+            taken._value_codes = column._value_codes
+            table.columns[name] = taken
+        return table
+
+    def row(self, row):
+        """把一行属性还原为字典"""
+        return {name: column.values[column.codes[row]]
+                for name, column in self.columns.items() if column.codes[row] >= 0}
+
+    def copy(self):
+        table = _AttributeTable()
+        table.length = self.length
+        for name, column in self.columns.items():
+            copied = _Column(0)
+            copied.codes = array('i', column.codes)
+            copied.values = list(column.values)
+            copied._value_codes = dict(column._value_codes)
+            table.columns[name] = copied
+        return table
+
+
+class _NodeView:
+    """与networkx的G.nodes用法一致：可迭代、可判断成员、可调用（nodes(data=True)逐个生成）、可按节点取属性"""
+
+    __slots__ = ('_graph',)
+
+    def __init__(self, graph):
+        self._graph = graph
+
+    def __call__(self, data=False):
+        if not data:
+            return self
+        graph = self._graph
+        return ((key, graph._node_attrs.row(node_id)) for node_id, key in enumerate(graph._node_keys))
+
+    def __iter__(self):
+        return iter(self._graph._node_keys)
+
+    def __len__(self):
+        return len(self._graph._node_keys)
+
+    def __contains__(self, node):
+        return node in self._graph._node_ids
+
+    def __getitem__(self, node):
+        return self._graph._node_attrs.row(self._graph._node_ids[node])
+
+
+class _EdgeView:
+    """与networkx的G.edges用法一致：可迭代（(u, v)二元组）、可调用（edges(data=True)逐个生成）、可按(u, v)取属性"""
+
+    __slots__ = ('_graph',)
+
+    def __init__(self, graph):
+        self._graph = graph
+
+    def __call__(self, data=False):
+        # 与networkx相同：按源节点的添加顺序分组，同一源节点的边按添加顺序排列
+        graph = self._graph
+        return (graph._edge_tuple(edge_id, data) for edge_id in graph._adjacency().by_source.tolist())
+
+    def __iter__(self):
+        return self()
+
+    def __len__(self):
+        return self._graph.number_of_edges()
+
+    def __contains__(self, edge):
+        return self._graph.has_edge(*edge)
+
+    def __getitem__(self, edge):
+        edge_id = self._graph._edge_id(*edge)
+        if edge_id is None:
+            raise KeyError(edge)
+        return self._graph._edge_attrs.row(edge_id)
+
+
+# 后继和前驱两个方向的CSR索引（numpy数组）：
+# by_source/by_target为按源/目标节点稳定排序的边id（同一节点的边保持添加顺序），
+# by_pair为按(源节点, 目标节点)排序的边id，pair_targets为其目标节点，与succ_indptr一起供二分查找边
+_CSR = namedtuple('_CSR', ['succ_indptr', 'by_source', 'pred_indptr', 'by_target', 'by_pair', 'pair_targets'])
+
+
+class CompactDiGraph:
+    """整数编号的有向图（简单图：同一对节点之间至多一条边）
+
+    重复添加节点或边时与networkx相同，只更新其属性。
+    """
+
+    def __init__(self):
+        self._node_ids = {}  # 节点键 -> 节点id
+        self._node_keys = []  # 节点id -> 节点键
+        self._node_attrs = _AttributeTable()
+        self._edge_sources = array('q')  # 边id -> 源节点id
+        self._edge_targets = array('q')  # 边id -> 目标节点id
+        self._edge_attrs = _AttributeTable()
+        self._csr = None  # _CSR索引，添加节点或边后失效
+        self._networkx = None  # 缓存的networkx视图
+
+    # 构建
+    def add_node(self, node, **attr):
+        node_id = self._intern(node)
+        if attr:
+            self._node_attrs.update(node_id, attr)
+            self._networkx = None
+        return node_id
+
+    def add_edge(self, u, v, **attr):
+        """添加边；已存在的边在下次整理索引时与之合并（_merge_duplicate_edges）"""
+        source = self._intern(u)
+        target = self._intern(v)
+        self._edge_sources.append(source)
+        self._edge_targets.append(target)
+        self._edge_attrs.append_row()
+        if attr:
+            self._edge_attrs.update(len(self._edge_sources) - 1, attr)
+        self._csr = None
+        self._networkx = None
+
+    def _intern(self, node):
+        node_id = self._node_ids.get(node)
+        if node_id is None:
+            node_id = len(self._node_keys)
+            self._node_ids[node] = node_id
+            self._node_keys.append(node)
+            self._node_attrs.append_row()
+            self._csr = None
+            self._networkx = None
+        return node_id
+
+    # 查询
+    @property
+    def nodes(self):
+        return _NodeView(self)
+
+    @property
+    def edges(self):
+        return _EdgeView(self)
+
+    def has_node(self, node):
+        return node in self._node_ids
+
+    def has_edge(self, u, v):
+        return self._edge_id(u, v) is not None
+
+    def _edge_id(self, u, v):
+        """在源节点的CSR列切片（按目标节点排序）上二分查找边id，边不存在时返回None"""
+        source = self._node_ids.get(u)
+        target = self._node_ids.get(v)
+        if source is None or target is None:
+            return None
+        csr = self._adjacency()
+        start, end = csr.succ_indptr[source], csr.succ_indptr[source + 1]
+        position = start + int(np.searchsorted(csr.pair_targets[start:end], target))
+        if position < end and csr.pair_targets[position] == target:
+            return int(csr.by_pair[position])
+        return None
+
+    def successors(self, node):
+        source = self._require(node)
+        csr = self._adjacency()
+        edge_ids = csr.by_source[csr.succ_indptr[source]:csr.succ_indptr[source + 1]]
+        targets = _int64_view(self._edge_targets)[edge_ids]
+        return iter([self._node_keys[target] for target in targets.tolist()])
+
+    neighbors = successors
+
+    def predecessors(self, node):
+        target = self._require(node)
+        csr = self._adjacency()
+        edge_ids = csr.by_target[csr.pred_indptr[target]:csr.pred_indptr[target + 1]]
+        sources = _int64_view(self._edge_sources)[edge_ids]
+        return iter([self._node_keys[source] for source in sources.tolist()])
+
+    def out_edges(self, node, data=False):
+        source = self._require(node)
+        csr = self._adjacency()
+        edge_ids = csr.by_source[csr.succ_indptr[source]:csr.succ_indptr[source + 1]]
+        return [self._edge_tuple(edge_id, data) for edge_id in edge_ids.tolist()]
+
+    def in_edges(self, node, data=False):
+        target = self._require(node)
+        csr = self._adjacency()
+        edge_ids = csr.by_target[csr.pred_indptr[target]:csr.pred_indptr[target + 1]]
+        return [self._edge_tuple(edge_id, data) for edge_id in edge_ids.tolist()]
+
+    def out_degree(self, node):
+        indptr = self._adjacency().succ_indptr
+        source = self._require(node)
+        return int(indptr[source + 1] - indptr[source])
+
+    def in_degree(self, node):
+        indptr = self._adjacency().pred_indptr
+        target = self._require(node)
+        return int(indptr[target + 1] - indptr[target])
+
+    def number_of_nodes(self):
+        return len(self._node_keys)
+
+    def number_of_edges(self):
+        self._adjacency()
+        return len(self._edge_sources)
+
+    def is_directed(self):
+        return True
+
+    def is_multigraph(self):
+        return False
+
+    def __contains__(self, node):
+        return node in self._node_ids
+
+    def __iter__(self):
+        return iter(self._node_keys)
+
+    def __len__(self):
+        return len(self._node_keys)
+
+    def _require(self, node):
+        node_id = self._node_ids.get(node)
+        if node_id is None:
+            raise nx.NetworkXError(f"The node {node} is not in the digraph.")
+        return node_id
+
+    def _edge_tuple(self, edge_id, data):
+        u = self._node_keys[self._edge_sources[edge_id]]
+        v = self._node_keys[self._edge_targets[edge_id]]
+        return (u, v, self._edge_attrs.row(edge_id)) if data else (u, v)
+
+    def _adjacency(self):
+        """按需构建后继和前驱两个方向的CSR索引（_CSR），再次添加节点或边后失效"""
+        if self._csr is None:
+            self._merge_duplicate_edges()
+            node_count = len(self._node_keys)
+            sources = _int64_view(self._edge_sources)
+            targets = _int64_view(self._edge_targets)
+            # 稳定排序保持同一节点的边按添加顺序排列，与networkx的迭代顺序一致
+            by_source = np.argsort(sources, kind='stable')
+            by_target = np.argsort(targets, kind='stable')
+            by_pair = np.lexsort((targets, sources))
+            succ_indptr = np.zeros(node_count + 1, dtype=np.int64)
+            pred_indptr = np.zeros(node_count + 1, dtype=np.int64)
+            np.cumsum(np.bincount(sources, minlength=node_count), out=succ_indptr[1:])
+            np.cumsum(np.bincount(targets, minlength=node_count), out=pred_indptr[1:])
+            self._csr = _CSR(succ_indptr, by_source, pred_indptr, by_target, by_pair, targets[by_pair])
+        return self._csr
+
+    def _merge_duplicate_edges(self):
+        """同一对节点之间重复添加的边合并到第一次添加的边上，属性按添加顺序覆盖"""
+        edge_count = len(self._edge_sources)
+        if not edge_count:
+            return
+        sources = _int64_view(self._edge_sources)
+        targets = _int64_view(self._edge_targets)
+        _, first, inverse = np.unique(sources * len(self._node_keys) + targets, return_index=True,
+                                      return_inverse=True)
+        if len(first) == edge_count:
+            return
+        merged_into = first[inverse.reshape(-1)]
+        duplicates = np.flatnonzero(merged_into != np.arange(edge_count))
+        self._edge_attrs.merge_rows(duplicates.tolist(), merged_into[duplicates].tolist())
+        kept = np.sort(first)
+        self._edge_sources = array('q', sources[kept].tobytes())
+        self._edge_targets = array('q', targets[kept].tobytes())
+        self._edge_attrs = self._edge_attrs.take(kept)
+
+    # 整数编号访问，供SCC、可达性等图算法直接使用
+    def node_id(self, node):
+        """节点键对应的整数id，节点不存在时返回None"""
+        return self._node_ids.get(node)
+
+    def node_key(self, node_id):
+        return self._node_keys[node_id]
+
+    def csr(self):
+        """返回后继方向的CSR数组(indptr, targets)（numpy），targets为节点id"""
+        csr = self._adjacency()
+        return csr.succ_indptr, _int64_view(self._edge_targets)[csr.by_source]
+
+    # 复制与转换
+    def copy(self):
+        graph = CompactDiGraph()
+        graph._node_ids = dict(self._node_ids)
+        graph._node_keys = list(self._node_keys)
+        graph._node_attrs = self._node_attrs.copy()
+        graph._edge_sources = array('q', self._edge_sources)
+        graph._edge_targets = array('q', self._edge_targets)
+        graph._edge_attrs = self._edge_attrs.copy()
+        return graph
+
+    def as_networkx(self):
+        """networkx.DiGraph视图：首次访问时构建，图被修改后重新构建
+
+        视图与本图共享节点键，供布局、绘图、连通分量等networkx算法只读使用。
+        """
+        if self._networkx is None:
+            graph = nx.DiGraph()
+            graph.add_nodes_from(self.nodes(data=True))
+            graph.add_edges_from(self.edges(data=True))
+            self._networkx = graph
+        return self._networkx
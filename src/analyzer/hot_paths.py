@@ -0,0 +1,110 @@
+"""热点路径索引模块
+
+性能相关的分析（循环中的内存分配、链表线性查找、阻塞调用等）都需要回答以下问题：
+- 某个函数能否从配置的入口函数（analysis_options中的entry_points）到达，经过哪条调用链
+- 函数中的每个调用点位于几层循环中，间接调用实际调用了哪些函数
+- 入口函数每被调用一次，某个函数被静态调用几次、是否在循环或递归中被反复调用
+
+HotPathIndex在调用图索引和各函数的基本块控制流图之上统一回答这些问题。
+"""
+
+from .source_location import location_position
+
+
+class HotPathIndex:
+    """入口函数可达性与调用点循环深度查询"""
+
+    def __init__(self, analyzer, entry_points=None):
+        """初始化索引
+        Args:
+            analyzer: 已完成分析的CCodeAnalyzer（需要functions、call_graph和indirect_calls）
+            entry_points: 入口函数列表，默认使用analyzer.options中的entry_points
+        """
+        self.analyzer = analyzer
+        self.call_graph = analyzer.call_graph
+        if entry_points is None:
+            entry_points = analyzer.options.get('entry_points', [])
+        # 只保留调用图中存在的入口函数
+        self.entry_points = [name for name in entry_points if self.call_graph.component_of(name) is not None]
+
+        # 间接调用的目标按 (调用者, 行号, 列号, 函数指针表达式) 索引，同一宏展开中的多个间接调用互不混淆
+        self._indirect_targets = {}
+        for call_info in analyzer.indirect_calls.values():
+            line, column = location_position(call_info['location'])
+            key = (call_info['caller'], line, column, call_info['function'])
+            self._indirect_targets.setdefault(key, []).extend(call_info['targets'])
+        self._chain_cache = {}
+        self._invocation_cache = {}
+
+    def call_sites(self, function):
+        """函数中的调用点：[(被调函数, 行号, 循环深度, 是否间接调用)]
+
+        间接调用展开为指针分析解析出的每个目标函数，未解析的间接调用不返回。
+        """
+        block_cfg = self.analyzer.functions.get(function, {}).get('block_cfg')
+        if block_cfg is None:
+            return []
+        sites = []
+        for block, calls in block_cfg.block_calls.items():
+            depth = block_cfg.block_loop_depth[block]
+            for callee, line, column, indirect in calls:
+                if indirect:
+                    for target in self._indirect_targets.get((function, line, column, callee), ()):
+                        sites.append((target, line, depth, True))
+                else:
+                    sites.append((callee, line, depth, False))
+        sites.sort(key=lambda site: site[1])
+        return sites
+
+    def entries_reaching(self, function):
+        """能调用到该函数的入口函数（函数本身是入口时包含自身）"""
+        return [entry for entry in self.entry_points
+                if entry == function or self.call_graph.reaches(entry, function)]
+
+    def is_hot(self, function):
+        return bool(self.entries_reaching(function))
+
+    def entry_chain(self, function):
+        """从入口函数到该函数的最短调用链，不可达时返回None"""
+        if function not in self._chain_cache:
+            best = None
+            for entry in self.entry_points:
+                chain = self.call_graph.call_chain(entry, (function,))
+                if chain is not None and (best is None or len(chain) < len(best)):
+                    best = chain
+            self._chain_cache[function] = best
+        return self._chain_cache[function]
+
+    def invocations(self, entry):
+        """入口函数执行一次时各函数的静态调用次数估计
+        
+        在调用图上按调用者先于被调用者的顺序传播：被调用次数为各调用者的调用次数之和
+        （每个调用点计一次），调用点位于循环中或处于递归调用环中的函数标记为反复调用。
+        Returns:
+            {函数名: {'calls': 调用路径数, 'in_loop': 是否在循环或递归中被调用}}，只包含入口可达的函数
+        """
+        result = self._invocation_cache.get(entry)
+        if result is not None:
+            return result
+        result = {}
+        if entry in self.entry_points:
+            reachable = set(self.call_graph.transitive_callees(entry)) | {entry}
+            result[entry] = {'calls': 1, 'in_loop': self.call_graph.is_recursive(entry)}
+            # 分量编号为逆拓扑序，编号大的（调用者）先处理
+            for function in sorted(reachable, key=lambda name: -self.call_graph.component_of(name)):
+                info = result.get(function)
+                if info is None:
+                    continue
+                component = self.call_graph.component_of(function)
+                for callee, _, depth, _ in self.call_sites(function):
+                    if callee not in reachable or callee == entry:
+                        continue
+                    callee_info = result.setdefault(callee, {'calls': 0, 'in_loop': False})
+                    if self.call_graph.component_of(callee) == component:
+                        # 递归调用环内的调用：次数不可静态确定
+                        callee_info['in_loop'] = True
+                        continue
+                    callee_info['calls'] += info['calls']
+                    callee_info['in_loop'] = callee_info['in_loop'] or info['in_loop'] or depth > 0
+        self._invocation_cache[entry] = result
+        return result
@@ -0,0 +1,216 @@
+"""链表遍历与线性查找检测模块
+
+识别沿自引用指针字段推进的循环（p = p->next，或先保存next = p->next再p = next），
+并按循环体内的比较判断循环的用途：
+- search：比较游标所指节点的字段（p->id == id、strcmp(p->name, key)）且找到后提前退出
+- filter：比较节点字段但遍历整个链表
+- walk：只遍历（计数、释放等）
+
+链表遍历的代价与链表长度成正比，位于热点路径上、或入口函数每执行一次就被调用多次
+（调用点在循环中、多个调用点、递归）的遍历会成为O(n²)的瓶颈，报告中单独标记。
+"""
+
+import clang.cindex
+
+from .cursor_tokens import binary_operator, is_null_constant
+from .hot_paths import HotPathIndex
+from .symbol_table import SymbolTable
+
+
+LOOP_KINDS = (
+    clang.cindex.CursorKind.WHILE_STMT,
+    clang.cindex.CursorKind.DO_STMT,
+    clang.cindex.CursorKind.FOR_STMT,
+)
+COMPARISON_OPERATORS = ('==', '!=', '<', '>', '<=', '>=')
+COMPARISON_FUNCTIONS = ('strcmp', 'strncmp', 'strcasecmp', 'strncasecmp', 'memcmp')
+
+
+def _declaration_key(expr):
+    """变量引用表达式所引用声明的键，不是变量引用时返回None"""
+    expr = SymbolTable.strip(expr)
+    if expr is None or expr.kind != clang.cindex.CursorKind.DECL_REF_EXPR:
+        return None
+    declaration = expr.referenced
+    if declaration is None:
+        return None
+    return declaration.get_usr() or declaration.spelling
+
+
+def _is_link_field(field):
+    """字段是否为指向所在结构体自身的指针（链表的next、prev等）"""
+    if field is None or field.kind != clang.cindex.CursorKind.FIELD_DECL:
+        return False
+    field_type = field.type.get_canonical()
+    if field_type.kind != clang.cindex.TypeKind.POINTER:
+        return False
+    pointee = field_type.get_pointee().get_canonical().get_declaration()
+    record = field.semantic_parent
+    return pointee is not None and record is not None and bool(record.get_usr()) and \
+        pointee.get_usr() == record.get_usr()
+
+
+class LinkedListTraversalDetector:
+    """链表遍历循环检测"""
+
+    def __init__(self):
+        self.loops = []  # 检测到的链表遍历循环
+
+    def add_loop(self, loop, function):
+        """检查函数中的一个循环语句，是链表遍历时登记"""
+        nodes = list(self._loop_nodes(loop))
+
+        # 链接赋值：x = base->next（或声明Timer* x = base->next）
+        links = []  # (被赋值变量, 基址变量, 字段)
+        moves = []  # (被赋值变量, 来源变量)
+        names = {}  # 变量键 -> 变量名
+        for node in nodes:
+            target = value = None
+            if node.kind == clang.cindex.CursorKind.BINARY_OPERATOR and binary_operator(node) == '=':
+                children = list(node.get_children())
+                if len(children) == 2:
+                    target, value = _declaration_key(children[0]), children[1]
+                    if target is not None:
+                        names[target] = SymbolTable.strip(children[0]).spelling
+            elif node.kind == clang.cindex.CursorKind.VAR_DECL:
+                target = node.get_usr() or node.spelling
+                value = next((child for child in node.get_children() if child.kind.is_expression()), None)
+                names[target] = node.spelling
+            if target is None or value is None:
+                continue
+            value = SymbolTable.strip(value)
+            if value is None:
+                continue
+            if value.kind == clang.cindex.CursorKind.MEMBER_REF_EXPR and _is_link_field(value.referenced):
+                base = _declaration_key(next(value.get_children(), None))
+                if base is not None:
+                    links.append((target, base, value.referenced))
+            else:
+                source = _declaration_key(value)
+                if source is not None:
+                    moves.append((target, source))
+
+        # 游标：沿链接字段推进的变量（p = p->next，或next = p->next; p = next）
+        cursors = {}
+        for target, base, field in links:
+            if target == base:
+                cursors[target] = field
+        for target, source in moves:
+            for link_target, base, field in links:
+                if link_target == source and base == target:
+                    cursors[target] = field
+        if not cursors:
+            return None
+
+        # 游标所指节点上的键比较
+        compared = []
+        for node in nodes:
+            fields = None
+            if node.kind == clang.cindex.CursorKind.BINARY_OPERATOR and binary_operator(node) in COMPARISON_OPERATORS:
+                operands = list(node.get_children())
+                if len(operands) == 2 and not any(is_null_constant(SymbolTable.strip(operand)) for operand in operands):
+                    fields = [field for operand in operands for field in self._cursor_fields(operand, cursors)]
+            elif node.kind == clang.cindex.CursorKind.CALL_EXPR and node.spelling in COMPARISON_FUNCTIONS:
+                fields = [field for arg in node.get_arguments() for field in self._cursor_fields(arg, cursors)]
+            for field in fields or ():
+                if field not in compared:
+                    compared.append(field)
+        early_exit = any(node.kind in (clang.cindex.CursorKind.RETURN_STMT, clang.cindex.CursorKind.BREAK_STMT)
+                         for node in nodes)
+
+        cursor_key, link_field = next(iter(cursors.items()))
+        record = link_field.semantic_parent
+        if compared:
+            kind = 'search' if early_exit else 'filter'
+        else:
+            kind = 'walk'
+        info = {
+            'function': function,
+            'line': loop.extent.start.line,
+            'end_line': loop.extent.end.line,
+            'location': f"{loop.location.file}:{loop.location.line}:{loop.location.column}",
+            'cursor': names.get(cursor_key, ''),
+            'link': f"{record.spelling or record.type.spelling}.{link_field.spelling}",
+            'kind': kind,
+            'key_fields': compared,
+            'early_exit': early_exit,
+        }
+        self.loops.append(info)
+        return info
+
+    @staticmethod
+    def _loop_nodes(loop):
+        """循环语句子树中的节点（不进入嵌套循环，嵌套循环单独检测）"""
+        stack = list(loop.get_children())
+        while stack:
+            node = stack.pop()
+            if node.kind in LOOP_KINDS:
+                continue
+            yield node
+            stack.extend(node.get_children())
+
+    @staticmethod
+    def _cursor_fields(expr, cursors):
+        """表达式中经游标访问的非链接字段名（p->id、p->name）"""
+        fields = []
+        stack = [expr]
+        while stack:
+            node = stack.pop()
+            if node.kind == clang.cindex.CursorKind.MEMBER_REF_EXPR:
+                base = _declaration_key(next(node.get_children(), None))
+                if base in cursors and not _is_link_field(node.referenced):
+                    fields.append(node.spelling)
+            stack.extend(node.get_children())
+        return fields
+
+    def analyze(self, analyzer, entry_points=None):
+        """为检测到的循环补充调用者、循环深度和入口调用频率
+        Returns:
+            链表遍历循环列表，热点路径上被反复执行的排在前面
+        """
+        hot_paths = HotPathIndex(analyzer, entry_points)
+        report = []
+        for loop in self.loops:
+            function = loop['function']
+            block_cfg = analyzer.functions.get(function, {}).get('block_cfg')
+            entries = {}
+            for entry in hot_paths.entries_reaching(function):
+                invocation = hot_paths.invocations(entry).get(function)
+                if invocation is None:
+                    continue
+                entries[entry] = {
+                    'calls_per_operation': invocation['calls'],
+                    'in_loop': invocation['in_loop'],
+                    'call_chain': analyzer.call_graph.call_chain(entry, (function,)),
+                }
+            # 循环本身位于外层循环中，或所在函数每次操作被调用多次
+            repeated = [entry for entry, info in entries.items()
+                        if info['calls_per_operation'] > 1 or info['in_loop']]
+            loop_depth = block_cfg.loop_depth_at(loop['line']) if block_cfg is not None else 1
+            report.append({
+                **loop,
+                'loop_depth': loop_depth,
+                'callers': sorted(analyzer.cfg.predecessors(function)) if analyzer.cfg.has_node(function) else [],
+                'entry_points': entries,
+                'repeated_per_operation': repeated,
+                'flagged': bool(repeated) or loop_depth > 1,
+            })
+        report.sort(key=lambda item: (not item['flagged'], -len(item['repeated_per_operation']),
+                                      -len(item['entry_points']), item['kind'] != 'search',
+                                      item['function'], item['line']))
+        return report
+
+    @staticmethod
+    def summary(report, limit=10):
+        lines = []
+        for item in report[:limit]:
+            line = f"{item['function']}:{item['line']} {item['kind']} over {item['link']}"
+            if item['key_fields']:
+                line += f" by {', '.join(item['key_fields'])}"
+            line += f", callers: {', '.join(item['callers']) or '-'}"
+            if item['repeated_per_operation']:
+                line += f"; repeated per operation from {', '.join(item['repeated_per_operation'])}"
+            elif item['entry_points']:
+                line += f"; reachable from {len(item['entry_points'])} entry point(s)"
+            lines.append(line)
+        return lines
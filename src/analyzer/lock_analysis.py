@@ -0,0 +1,462 @@
+"""锁与临界区分析模块
+
+识别pthread互斥锁、读写锁、自旋锁、C11 mtx/cnd以及原子操作，
+在每个函数的基本块控制流图上做前向数据流分析，求出每个程序点可能持有的锁：
+- 临界区：从加锁点到解锁点之间执行的调用、内存分配和循环，
+  以及临界区内代码的复杂度（循环层数 + 被调函数的复杂度估计）
+- 嵌套加锁与锁顺序：持有锁A时直接或经调用链加锁B，记录A -> B；
+  锁顺序图中的环（A -> B且B -> A）即可能死锁的锁顺序反转
+- 函数返回时仍持有的锁（加锁封装函数或遗漏解锁）
+
+锁按加锁实参区分：&g_lock为变量名，&timer->lock为"结构体名.字段名"（不区分实例），
+经指针传入的锁由指针分析解析为所指向的变量。每个锁汇总加锁点、可能加锁的线程数
+（线程入口来自共享数据分析）和临界区长度，作为该锁的争用报告。
+"""
+
+from .graph_store import strongly_connected_components
+from .hot_paths import HotPathIndex
+
+
+# 函数名 -> (操作, 原语, 锁所在的实参序号)
+SYNC_FUNCTIONS = {
+    'pthread_mutex_lock': ('acquire', 'mutex', 0),
+    'pthread_mutex_timedlock': ('acquire', 'mutex', 0),
+    'pthread_mutex_trylock': ('try_acquire', 'mutex', 0),
+    'pthread_mutex_unlock': ('release', 'mutex', 0),
+    'pthread_rwlock_rdlock': ('acquire', 'rwlock_read', 0),
+    'pthread_rwlock_timedrdlock': ('acquire', 'rwlock_read', 0),
+    'pthread_rwlock_tryrdlock': ('try_acquire', 'rwlock_read', 0),
+    'pthread_rwlock_wrlock': ('acquire', 'rwlock_write', 0),
+    'pthread_rwlock_timedwrlock': ('acquire', 'rwlock_write', 0),
+    'pthread_rwlock_trywrlock': ('try_acquire', 'rwlock_write', 0),
+    'pthread_rwlock_unlock': ('release', 'rwlock', 0),
+    'pthread_spin_lock': ('acquire', 'spinlock', 0),
+    'pthread_spin_trylock': ('try_acquire', 'spinlock', 0),
+    'pthread_spin_unlock': ('release', 'spinlock', 0),
+    'mtx_lock': ('acquire', 'mutex', 0),
+    'mtx_timedlock': ('acquire', 'mutex', 0),
+    'mtx_trylock': ('try_acquire', 'mutex', 0),
+    'mtx_unlock': ('release', 'mutex', 0),
+    # 条件变量等待期间释放并重新获得互斥锁，锁参数为第二个实参
+    'pthread_cond_wait': ('wait', 'condition', 1),
+    'pthread_cond_timedwait': ('wait', 'condition', 1),
+    'cnd_wait': ('wait', 'condition', 1),
+    'cnd_timedwait': ('wait', 'condition', 1),
+}
+ATOMIC_PREFIXES = ('atomic_', '__atomic_', '__sync_', '__c11_atomic_')
+CRITICAL_SECTION_LINES = 30
+
+
+def sync_operation(function_name):
+    """同步原语调用的(操作, 原语, 锁实参序号)，不是同步原语时返回None"""
+    operation = SYNC_FUNCTIONS.get(function_name)
+    if operation is not None:
+        return operation
+    if function_name.startswith(ATOMIC_PREFIXES) and function_name not in ('atomic_init', 'atomic_thread_fence',
+                                                                             'atomic_signal_fence'):
+        return ('atomic', 'atomic', 0)
+    return None
+
+
+class LockAnalyzer:
+    """锁持有区间、锁顺序和原子操作分析"""
+
+    def __init__(self, critical_section_lines=CRITICAL_SECTION_LINES):
+        self.critical_section_lines = critical_section_lines
+        self.operations = {}  # (函数, 行号, 列号, 被调函数) -> 同步操作（同一行的多次加锁按列区分）
+        self.atomics = []
+
+    def add_operation(self, function, callee, line, column, location, lock_label, lock_sources):
+        """登记一次同步原语调用
+        Args:
+            lock_label: 锁实参的名称（变量限定名、"结构体名.字段名"或实参源码）
+            lock_sources: 锁实参的指针值来源，实参是&变量或&字段时为None
+        """
+        operation, primitive, _ = sync_operation(callee)
+        info = {
+            'function': function,
+            'callee': callee,
+            'line': line,
+            'location': location,
+            'operation': operation,
+            'primitive': primitive,
+            'label': lock_label,
+            'sources': lock_sources,
+        }
+        if operation == 'atomic':
+            # 原子内建表达式外层的隐式转换与其共享同一位置
+            if all(atomic['location'] != location for atomic in self.atomics):
+                self.atomics.append(info)
+        else:
+            self.operations[(function, line, column, callee)] = info
+
+    def analyze(self, analyzer):
+        """计算锁报告
+        Returns:
+            {
+                'locks': 每个锁的争用汇总,
+                'critical_sections': 临界区列表，长临界区排在前面,
+                'lock_order': 锁顺序边,
+                'inversions': 锁顺序反转（锁顺序图中的环）,
+                'held_at_exit': 返回时仍可能持有的锁,
+                'atomics': 原子操作调用点
+            }
+        """
+        self.analyzer = analyzer
+        self.call_graph = analyzer.call_graph
+        self.hot_paths = HotPathIndex(analyzer)
+        costs = analyzer.cost_report.get('functions', {}) if analyzer.cost_report else {}
+
+        for info in self.operations.values():
+            info['locks'] = self._lock_names(info)
+        self._acquire_primitives = {(info['function'], info['line']): info['primitive']
+                                    for info in self.operations.values()
+                                    if info['operation'] in ('acquire', 'try_acquire')}
+        acquirers = {}  # 锁 -> 直接加锁的函数
+        for info in self.operations.values():
+            if info['operation'] in ('acquire', 'try_acquire'):
+                for lock in info['locks']:
+                    acquirers.setdefault(lock, set()).add(info['function'])
+        acquires = self._transitive_acquires(acquirers)
+
+        sections = {}
+        order_edges = {}
+        held_at_exit = []
+        functions = sorted({info['function'] for info in self.operations.values()})
+        for function in functions:
+            self._analyze_function(function, costs, acquires, acquirers, sections, order_edges, held_at_exit)
+
+        critical_sections = list(sections.values())
+        for section in critical_sections:
+            self._classify(section)
+        critical_sections.sort(key=lambda section: (not section['long'], -section['degree'], -section['lines'],
+                                                    section['function'], section['acquire_line']))
+        edges = list(order_edges.values())
+        return {
+            'locks': self._lock_summaries(critical_sections, edges),
+            'critical_sections': critical_sections,
+            'lock_order': edges,
+            'inversions': self._inversions(edges),
+            'held_at_exit': held_at_exit,
+            'atomics': [
+                {key: info[key] for key in ('function', 'line', 'callee', 'label', 'location')}
+                for info in self.atomics
+            ],
+        }
+
+    # 锁的识别
+    def _lock_names(self, info):
+        """锁实参对应的锁名：指针实参解析为所指向的变量或堆对象"""
+        if info['sources'] is None:
+            return [info['label']]
+        points_to = self.analyzer.points_to
+        names = []
+        for source_kind, source_id in info['sources']:
+            object_ids = [source_id] if source_kind == 'object' else points_to.points_to(source_id)
+            for object_id in object_ids:
+                obj = points_to.objects[object_id]
+                name = obj.get('variable') or obj['label']
+                if name not in names:
+                    names.append(name)
+        return names or [info['label']]
+
+    def _transitive_acquires(self, acquirers):
+        """每个函数直接或经调用链可能获得的锁，按调用图分量自底向上传播"""
+        direct = {}
+        for lock, functions in acquirers.items():
+            for function in functions:
+                direct.setdefault(function, set()).add(lock)
+        acquires = {}
+        components = {}
+        for function in self.analyzer.functions:
+            component = self.call_graph.component_of(function)
+            if component is not None:
+                components.setdefault(component, []).append(function)
+        for component in sorted(components):
+            members = components[component]
+            locks = set()
+            for function in members:
+                locks |= direct.get(function, set())
+                for callee, _, _, _ in self.hot_paths.call_sites(function):
+                    locks |= acquires.get(callee, set())
+            for function in members:
+                acquires[function] = locks
+        return acquires
+
+    # 函数内的锁持有区间
+    def _analyze_function(self, function, costs, acquires, acquirers, sections, order_edges, held_at_exit):
+        func_info = self.analyzer.functions.get(function, {})
+        block_cfg = func_info.get('block_cfg')
+        if block_cfg is None:
+            return
+
+        # 前向数据流：块入口可能持有的(锁, 加锁行号)集合
+        held_in = {block_cfg.entry: frozenset()}
+        worklist = [block_cfg.entry]
+        while worklist:
+            block = worklist.pop()
+            held = self._transfer(function, block_cfg, block, held_in[block])
+            for successor, _ in block_cfg.successors(block):
+                merged = held_in.get(successor, frozenset()) | held
+                if successor not in held_in or merged != held_in[successor]:
+                    held_in[successor] = merged
+                    worklist.append(successor)
+
+        def section_for(lock, acquire_line):
+            key = (function, lock, acquire_line)
+            section = sections.get(key)
+            if section is None:
+                section = sections[key] = {
+                    'function': function,
+                    'lock': lock,
+                    'primitive': self._acquire_primitives.get((function, acquire_line), ''),
+                    'acquire_line': acquire_line,
+                    'release_lines': [],
+                    'blocks': 0,
+                    'statements': 0,
+                    'calls': [],
+                    'allocations': [],
+                    'loops': [],
+                    'waits': [],
+                    'nested_locks': [],
+                    'degree': 0,
+                    'end_line': func_info.get('end_line', acquire_line),
+                }
+            return section
+
+        # 循环头可能在持有锁时执行的循环
+        for loop in block_cfg.loops:
+            for lock, acquire_line in held_in.get(loop['header'], ()):
+                section = section_for(lock, acquire_line)
+                section['loops'].append({'line': loop['start_line'], 'end_line': loop['end_line'],
+                                         'kind': loop['kind'], 'constant_bound': loop['constant_bound']})
+
+        for block, held in held_in.items():
+            for lock, acquire_line in held:
+                section = section_for(lock, acquire_line)
+                section['blocks'] += 1
+                section['statements'] += block_cfg.block_statements[block]
+            for callee, line, column, indirect in block_cfg.block_calls.get(block, ()):
+                operation = self.operations.get((function, line, column, callee))
+                if operation is not None:
+                    kind = operation['operation']
+                    if kind in ('acquire', 'try_acquire'):
+                        for lock in operation['locks']:
+                            section_for(lock, line)
+                            for held_lock, held_line in held:
+                                if held_lock == lock and (kind == 'try_acquire'
+                                                          or operation['primitive'] == 'rwlock_read'):
+                                    # 重复的读锁和trylock不会自死锁
+                                    continue
+                                section = section_for(held_lock, held_line)
+                                if lock not in section['nested_locks']:
+                                    section['nested_locks'].append(lock)
+                                self._add_order_edge(order_edges, held_lock, lock, function, line, [function])
+                    elif kind == 'release':
+                        for held_lock, held_line in held:
+                            if held_lock in operation['locks']:
+                                section = section_for(held_lock, held_line)
+                                if line not in section['release_lines']:
+                                    section['release_lines'].append(line)
+                    elif kind == 'wait':
+                        for held_lock, held_line in held:
+                            if held_lock not in operation['locks']:
+                                # 等待条件变量时仍持有其他锁
+                                section_for(held_lock, held_line)['waits'].append({'callee': callee, 'line': line})
+                    held = self._apply(operation, held, line)
+                    continue
+                if not held:
+                    continue
+                targets = [callee]
+                if indirect:
+                    targets = [target for target, site_line, _, _ in self.hot_paths.call_sites(function)
+                               if site_line == line and target != callee] or [callee]
+                for held_lock, held_line in held:
+                    section = section_for(held_lock, held_line)
+                    variable_depth = sum(1 for loop in section['loops']
+                                         if not loop['constant_bound'] and loop['line'] <= line <= loop['end_line'])
+                    for target in targets:
+                        call = {'callee': target, 'line': line, 'complexity': costs.get(target, {}).get('complexity',
+                                                                                                   'O(1)')}
+                        section['calls'].append(call)
+                        section['degree'] = max(section['degree'],
+                                                variable_depth + costs.get(target, {}).get('degree', 0))
+                        if target in self.analyzer.allocation_functions:
+                            section['allocations'].append({'callee': target, 'line': line})
+                        for lock in sorted(acquires.get(target, ())):
+                            chain = self.call_graph.call_chain(target, acquirers.get(lock, ())) or [target]
+                            if lock not in section['nested_locks']:
+                                section['nested_locks'].append(lock)
+                            self._add_order_edge(order_edges, held_lock, lock, function, line, [function] + chain)
+
+        for section in sections.values():
+            if section['function'] != function:
+                continue
+            variable_loops = [loop for loop in section['loops'] if not loop['constant_bound']]
+            for loop in variable_loops:
+                nest = sum(1 for outer in variable_loops if outer['line'] <= loop['line'] <= outer['end_line'])
+                section['degree'] = max(section['degree'], nest)
+
+        for lock, acquire_line in sorted(held_in.get(block_cfg.exit, ())):
+            held_at_exit.append({'function': function, 'lock': lock, 'acquire_line': acquire_line})
+
+    def _transfer(self, function, block_cfg, block, held):
+        for callee, line, column, _ in block_cfg.block_calls.get(block, ()):
+            operation = self.operations.get((function, line, column, callee))
+            if operation is not None:
+                held = self._apply(operation, held, line)
+        return held
+
+    @staticmethod
+    def _apply(operation, held, line):
+        kind = operation['operation']
+        if kind in ('acquire', 'try_acquire'):
+            return held | {(lock, line) for lock in operation['locks']}
+        if kind == 'release':
+            return frozenset(item for item in held if item[0] not in operation['locks'])
+        return held
+
+    @staticmethod
+    def _add_order_edge(order_edges, held_lock, lock, function, line, chain):
+        key = (held_lock, lock)
+        edge = order_edges.get(key)
+        if edge is None:
+            edge = order_edges[key] = {'from': held_lock, 'to': lock, 'self': held_lock == lock, 'sites': []}
+        site = {'function': function, 'line': line, 'call_chain': chain}
+        if site not in edge['sites']:
+            edge['sites'].append(site)
+
+    # 汇总
+    def _classify(self, section):
+        """临界区较长的原因"""
+        reasons = []
+        if any(not loop['constant_bound'] for loop in section['loops']):
+            reasons.append('loop')
+        if any(call['complexity'] != 'O(1)' for call in section['calls']):
+            reasons.append('expensive call')
+        if section['allocations']:
+            reasons.append('allocation')
+        if section['nested_locks']:
+            reasons.append('nested lock')
+        if section['waits']:
+            reasons.append('wait')
+        end = max(section['release_lines'], default=section['end_line'])
+        section['lines'] = max(end - section['acquire_line'] + 1, 1)
+        if section['lines'] > self.critical_section_lines:
+            reasons.append('lines')
+        section['complexity'] = 'O(1)' if not section['degree'] else \
+            'O(n)' if section['degree'] == 1 else f"O(n^{section['degree']})"
+        section['reasons'] = reasons
+        section['long'] = bool(reasons)
+
+    def _lock_summaries(self, sections, edges):
+        threads = []
+        if self.analyzer.shared_state_report:
+            threads = [thread['entry'] for thread in self.analyzer.shared_state_report.get('threads', [])]
+
+        summaries = {}
+        for info in self.operations.values():
+            if info['operation'] not in ('acquire', 'try_acquire'):
+                continue
+            for lock in info['locks']:
+                summary = summaries.setdefault(lock, {
+                    'lock': lock, 'primitives': [], 'acquisitions': [], 'functions': [], 'threads': [],
+                    'critical_sections': 0, 'long_sections': 0, 'max_lines': 0, 'max_complexity': 'O(1)',
+                    'calls_under_lock': [], 'allocations_under_lock': 0, 'loops_under_lock': 0,
+                    'nested_with': [], 'inverted_with': [],
+                })
+                primitive = info['primitive'].split('_')[0]
+                if primitive not in summary['primitives']:
+                    summary['primitives'].append(primitive)
+                summary['acquisitions'].append(f"{info['function']}:{info['line']}")
+                if info['function'] not in summary['functions']:
+                    summary['functions'].append(info['function'])
+
+        max_degree = {}
+        for section in sections:
+            summary = summaries.get(section['lock'])
+            if summary is None:
+                continue
+            summary['critical_sections'] += 1
+            summary['long_sections'] += section['long']
+            summary['max_lines'] = max(summary['max_lines'], section['lines'])
+            if section['degree'] > max_degree.get(section['lock'], -1):
+                max_degree[section['lock']] = section['degree']
+                summary['max_complexity'] = section['complexity']
+            for call in section['calls']:
+                if call['callee'] not in summary['calls_under_lock']:
+                    summary['calls_under_lock'].append(call['callee'])
+            summary['allocations_under_lock'] += len(section['allocations'])
+            summary['loops_under_lock'] += len(section['loops'])
+            for lock in section['nested_locks']:
+                if lock not in summary['nested_with']:
+                    summary['nested_with'].append(lock)
+        for edge in edges:
+            reverse = any(other['from'] == edge['to'] and other['to'] == edge['from'] for other in edges)
+            if reverse and not edge['self'] and edge['from'] in summaries and \
+                    edge['to'] not in summaries[edge['from']]['inverted_with']:
+                summaries[edge['from']]['inverted_with'].append(edge['to'])
+
+        for summary in summaries.values():
+            summary['threads'] = [entry for entry in threads
+                                  if any(entry == function or self.call_graph.reaches(entry, function)
+                                         for function in summary['functions'])]
+        return sorted(summaries.values(), key=lambda summary: (
+            -len(summary['threads']), -summary['long_sections'], -len(summary['acquisitions']), summary['lock']))
+
+    @staticmethod
+    def _inversions(edges):
+        """锁顺序图的强连通分量：分量中的锁之间存在相反的加锁顺序"""
+        locks = sorted({edge['from'] for edge in edges} | {edge['to'] for edge in edges})
+        index = {lock: position for position, lock in enumerate(locks)}
+        successors = [[] for _ in locks]
+        for edge in edges:
+            if not edge['self']:
+                successors[index[edge['from']]].append(index[edge['to']])
+        indptr = [0]
+        targets = []
+        for items in successors:
+            targets.extend(sorted(set(items)))
+            indptr.append(len(targets))
+        components, component_count = strongly_connected_components(len(locks), indptr, targets)
+        members = [[] for _ in range(component_count)]
+        for position, component in enumerate(components):
+            members[component].append(locks[position])
+        inversions = []
+        for group in members:
+            if len(group) < 2:
+                continue
+            group_edges = [edge for edge in edges
+                           if not edge['self'] and edge['from'] in group and edge['to'] in group]
+            inversions.append({'locks': group, 'edges': group_edges})
+        # 同一非递归锁的重复加锁（自死锁）
+        for edge in edges:
+            if edge['self']:
+                inversions.append({'locks': [edge['from']], 'edges': [edge], 'self_deadlock': True})
+        return inversions
+
+    @staticmethod
+    def summary(report, limit=10):
+        """锁争用、长临界区和锁顺序反转的文字摘要"""
+        lines = []
+        for lock in report['locks'][:limit]:
+            line = f"lock {lock['lock']} ({', '.join(lock['primitives'])}): {len(lock['acquisitions'])} acquisition(s)"
+            if lock['threads']:
+                line += f" from {len(lock['threads'])} thread(s)"
+            line += f", {lock['long_sections']}/{lock['critical_sections']} long critical section(s), " \
+                    f"max {lock['max_lines']} lines, {lock['max_complexity']}"
+            lines.append(line)
+        for section in report['critical_sections'][:limit]:
+            if not section['long']:
+                break
+            lines.append(f"{section['function']}:{section['acquire_line']} holds {section['lock']} for "
+                         f"{section['lines']} lines ({section['complexity']}): {', '.join(section['reasons'])}")
+        for inversion in report['inversions'][:limit]:
+            if inversion.get('self_deadlock'):
+                site = inversion['edges'][0]['sites'][0]
+                lines.append(f"{inversion['locks'][0]} re-acquired while held: {' -> '.join(site['call_chain'])}")
+                continue
+            sites = [f"{edge['from']} -> {edge['to']} in {edge['sites'][0]['function']}:{edge['sites'][0]['line']}"
+                     for edge in inversion['edges']]
+            lines.append(f"lock order inversion between {', '.join(inversion['locks'])}: {'; '.join(sites)}")
+        return lines
@@ -0,0 +1,490 @@
+"""堆内存生存期与泄漏路径分析模块
+
+_track_heap_variables只传播"指向堆内存"标记，不把分配与释放对应起来。
+本模块以分配点（指针分析中的堆对象）为单位：
+- 大小：分配函数的大小实参（malloc(sizeof(Timer))、calloc(n, sizeof(int))），
+  能静态求值时给出字节数，并列出其中的sizeof类型
+- 释放点：free实参的指向集合包含该对象的调用点
+- 所有者：对象只在分配函数内使用时为分配函数本身；经返回值传给调用者时为持有它的调用者；
+  存入全局变量或堆上结构时为调用到分配函数的顶层函数（通常是main）
+- 泄漏路径：在所有者的基本块控制流图上，从获得对象的调用点出发、不经过任何释放
+  （直接free，或调用传递释放该对象的函数）即到达函数出口的路径；
+  回到获得对象的调用点本身说明循环中的下一次分配覆盖了指针。
+  判断分配是否成功的分支（if (!p)、if (id == 0)、if (!init())）中失败的一侧不计入
+- 重复释放：同一函数中释放同一表达式（free(p)，或调用直接释放其参数的函数）两次，
+  且两次之间没有对该表达式重新赋值的路径
+
+调用点、释放点和赋值按(行号, 列号)排序，同一行上的free(p); free(p);也能区分先后。
+
+存入全局变量而没有调用到分配函数的顶层调用者（库的入口函数）时，不做路径分析，
+只报告释放该对象的函数（如timer_system_init的分配只在timer_system_destroy中释放）。
+"""
+
+import clang.cindex
+
+from .allocation_analysis import FREE_FUNCTIONS
+from .cursor_tokens import NULL_CONSTANTS, binary_operator, is_null_constant, token_text, unary_operator
+from .source_location import location_line, location_position
+from .symbol_table import SymbolTable
+
+
+# 分配函数 -> 大小实参的序号（多个序号时相乘）
+SIZE_ARGUMENTS = {
+    'malloc': (0,),
+    'calloc': (0, 1),
+    'realloc': (1,),
+    'aligned_alloc': (1,),
+    'valloc': (0,),
+    'pvalloc': (0,),
+}
+RELEASE_FUNCTIONS = FREE_FUNCTIONS + ('realloc',)
+NULL_TOKENS = NULL_CONSTANTS + ('false',)
+# sizeof(int)等内建类型没有类型引用子节点，按LP64数据模型取大小
+BUILTIN_SIZES = {
+    'char': 1, 'signedchar': 1, 'unsignedchar': 1, 'short': 2, 'unsignedshort': 2, 'int': 4, 'unsigned': 4,
+    'unsignedint': 4, 'long': 8, 'unsignedlong': 8, 'longlong': 8, 'unsignedlonglong': 8, 'float': 4,
+    'double': 8, 'longdouble': 16, '_Bool': 1, 'bool': 1,
+}
+
+
+def _expression_text(expr):
+    return token_text(SymbolTable.strip(expr))
+
+
+def _size_value(expr, sizeof_types):
+    """大小表达式的字节数，不能静态求值时返回None；表达式中的sizeof类型加入sizeof_types"""
+    expr = SymbolTable.strip(expr)
+    if expr is None:
+        return None
+    kind = expr.kind
+    if kind == clang.cindex.CursorKind.INTEGER_LITERAL:
+        token = next(expr.get_tokens(), None)
+        try:
+            return int(token.spelling.rstrip('uUlL'), 0) if token is not None else None
+        except ValueError:
+            return None
+    if kind == clang.cindex.CursorKind.CXX_UNARY_EXPR:
+        tokens = [token.spelling for token in expr.get_tokens()]
+        if not tokens or tokens[0] != 'sizeof':
+            return None
+        child = next(expr.get_children(), None)
+        if child is not None:
+            # sizeof(Timer)的子节点是类型引用，sizeof(*p)的子节点是表达式，类型都在子节点上
+            size_type = child.type
+        else:
+            size_type = None
+        text = ''.join(tokens[1:]).strip('()')
+        if text not in sizeof_types:
+            sizeof_types.append(text)
+        if size_type is None:
+            if text.endswith('*'):
+                return 8
+            return BUILTIN_SIZES.get(text)
+        size = size_type.get_size()
+        return size if size >= 0 else None
+    if kind == clang.cindex.CursorKind.BINARY_OPERATOR:
+        operands = list(expr.get_children())
+        if len(operands) != 2:
+            return None
+        operator = binary_operator(expr)
+        left, right = _size_value(operands[0], sizeof_types), _size_value(operands[1], sizeof_types)
+        if left is None or right is None:
+            return None
+        if operator == '*':
+            return left * right
+        if operator == '+':
+            return left + right
+    return None
+
+
+class MemoryLifetimeAnalyzer:
+    """分配与释放配对、泄漏路径和重复释放检测"""
+
+    def __init__(self):
+        self.allocations = {}  # 分配调用位置 -> 分配信息
+        self.frees = []  # {'function', 'line', 'column', 'callee', 'expression', 'sources'}
+        self.assignments = {}  # 函数 -> [((行号, 列号), 被赋值表达式)]
+        self.checks = {}  # 函数 -> {条件结束行号: [{'failure', 'variable', 'callee', 'sources'}]}
+        self.call_graph = None
+        self.functions = {}
+        self.return_values = {}  # (调用者, 行号) -> 接收调用返回值的变量
+
+    def add_allocation(self, function, call_expr):
+        """登记一次分配调用及其大小"""
+        location = f"{call_expr.location.file}:{call_expr.location.line}:{call_expr.location.column}"
+        args = list(call_expr.get_arguments())
+        indexes = SIZE_ARGUMENTS.get(call_expr.spelling, ())
+        sizeof_types = []
+        size = None
+        expression = None
+        if indexes and all(index < len(args) for index in indexes):
+            values = [_size_value(args[index], sizeof_types) for index in indexes]
+            expression = ' * '.join(_expression_text(args[index]) for index in indexes)
+            if all(value is not None for value in values):
+                size = 1
+                for value in values:
+                    size *= value
+        self.allocations[location] = {
+            'function': function,
+            'line': call_expr.location.line,
+            'column': call_expr.location.column,
+            'allocator': call_expr.spelling,
+            'size_expression': expression,
+            'bytes': size,
+            'sizeof': sizeof_types,
+        }
+
+    def add_free(self, function, call_expr, sources):
+        """登记一次释放调用（realloc也释放第一个实参）"""
+        pointer = next(iter(call_expr.get_arguments()), None)
+        if pointer is None:
+            return
+        self.frees.append({
+            'function': function,
+            'line': call_expr.location.line,
+            'column': call_expr.location.column,
+            'callee': call_expr.spelling,
+            'expression': _expression_text(pointer),
+            'sources': sources,
+        })
+
+    def add_assignment(self, function, position, target):
+        """登记一次指针赋值，重复释放检测中重新赋值的表达式不再指向已释放的内存
+        Args:
+            position: 赋值的(行号, 列号)
+        """
+        self.assignments.setdefault(function, []).append((position, _expression_text(target)))
+
+    def add_condition(self, function, condition, sources_of):
+        """登记判断指针或调用结果是否为空/假的条件
+        Args:
+            condition: if语句的条件表达式
+            sources_of: 求指针表达式值来源的函数
+        """
+        condition = SymbolTable.strip(condition)
+        if condition is None:
+            return
+        failure = 'false'
+        tested = condition
+        children = list(condition.get_children())
+        if condition.kind == clang.cindex.CursorKind.UNARY_OPERATOR and unary_operator(condition) == '!' and children:
+            failure, tested = 'true', children[0]
+        elif condition.kind == clang.cindex.CursorKind.BINARY_OPERATOR and len(children) == 2:
+            operator = binary_operator(condition)
+            if operator not in ('==', '!='):
+                return
+            operands = [SymbolTable.strip(child) for child in children]
+            if operands[1] is not None and is_null_constant(operands[1], NULL_TOKENS):
+                tested = operands[0]
+            elif operands[0] is not None and is_null_constant(operands[0], NULL_TOKENS):
+                tested = operands[1]
+            else:
+                return
+            failure = 'true' if operator == '==' else 'false'
+        tested = SymbolTable.strip(tested)
+        if tested is None:
+            return
+        check = {'failure': failure, 'variable': None, 'callee': None, 'sources': []}
+        if tested.kind == clang.cindex.CursorKind.CALL_EXPR:
+            check['callee'] = tested.spelling
+        elif tested.kind in (clang.cindex.CursorKind.DECL_REF_EXPR, clang.cindex.CursorKind.MEMBER_REF_EXPR):
+            check['variable'] = _expression_text(tested)
+            if tested.type.get_canonical().kind == clang.cindex.TypeKind.POINTER:
+                check['sources'] = sources_of(tested)
+        else:
+            return
+        self.checks.setdefault(function, {}).setdefault(condition.extent.end.line, []).append(check)
+
+    def analyze(self, analyzer):
+        """配对分配与释放
+        Returns:
+            {
+                'sites': 分配点列表（泄漏风险高的排在前面）,
+                'double_frees': 重复释放,
+                'statistics': 分配点统计
+            }
+        """
+        points_to = analyzer.points_to
+        self.call_graph = analyzer.call_graph
+        self.functions = analyzer.functions
+        escape_sites = {site['object']: site for site in analyzer.escape_report.get('sites', [])}
+        heap_objects = {obj['location']: object_id for object_id, obj in enumerate(points_to.objects)
+                        if obj['kind'] == 'heap'}
+        self.return_values = {(call['caller'], location_line(call['location'])): call['return_value']
+                              for call in analyzer.function_calls if call.get('return_value')}
+
+        free_objects = []
+        for free in self.frees:
+            objects = set()
+            for source_kind, source_id in free['sources']:
+                objects.update([source_id] if source_kind == 'object' else points_to.points_to(source_id))
+            free_objects.append(objects)
+
+        sites = []
+        for location, allocation in self.allocations.items():
+            object_id = heap_objects.get(location)
+            site = {'location': location, **allocation, 'object': object_id}
+            if object_id is None:
+                # 返回值没有存入任何指针，分配的内存立即丢失
+                site.update({'escape': None, 'freed_at': [], 'owners': [], 'leak_paths': [],
+                             'release_functions': [], 'status': 'discarded'})
+                sites.append(site)
+                continue
+            frees = [free for free, objects in zip(self.frees, free_objects) if object_id in objects]
+            escape_site = escape_sites.get(object_id)
+            site['escape'] = escape_site['escape'] if escape_site else None
+            site['freed_at'] = [{'function': free['function'], 'line': free['line'], 'callee': free['callee']}
+                                for free in frees]
+            site['release_functions'] = sorted({free['function'] for free in frees})
+            owners = self._owners(allocation['function'], escape_site)
+            site['owners'] = owners
+            site['leak_paths'] = []
+            if frees:
+                for owner, acquire_callee in owners:
+                    site['leak_paths'].extend(self._leak_paths(owner, acquire_callee, allocation, object_id,
+                                                               frees, points_to))
+            if not frees:
+                site['status'] = 'never_freed'
+            elif site['leak_paths']:
+                site['status'] = 'leak_path'
+            else:
+                site['status'] = 'paired'
+            site['owners'] = [owner for owner, _ in owners]
+            sites.append(site)
+
+        order = ('discarded', 'never_freed', 'leak_path', 'paired')
+        sites.sort(key=lambda site: (order.index(site['status']), site['function'] or '', site['line']))
+        double_frees = self._double_frees()
+        statistics = {
+            'sites': len(sites),
+            'by_status': {status: sum(1 for site in sites if site['status'] == status) for status in order},
+            'by_allocator': {},
+            'known_bytes': sum(site['bytes'] for site in sites if site['bytes'] is not None),
+            'unknown_size_sites': sum(1 for site in sites if site['bytes'] is None),
+            'double_frees': len(double_frees),
+        }
+        for site in sites:
+            statistics['by_allocator'][site['allocator']] = statistics['by_allocator'].get(site['allocator'], 0) + 1
+        return {'sites': sites, 'double_frees': double_frees, 'statistics': statistics}
+
+    def _owners(self, function, escape_site):
+        """负责释放对象的函数及其中获得对象的调用：[(所有者, 获得对象时调用的函数)]"""
+        if function is None or self.call_graph.component_of(function) is None:
+            return []
+        escape = escape_site['escape'] if escape_site else 'local'
+        if escape == 'local':
+            return [(function, None)]
+        if escape == 'thread':
+            return []
+        if escape == 'returned':
+            returned_by = set(escape_site['escapes'].get('returned', []))
+            holders = [holder for holder in escape_site['held_in']
+                       if holder != function and holder not in returned_by
+                       and self.call_graph.reaches(holder, function)]
+        else:
+            # 存入全局变量或堆上结构：由调用到分配函数的顶层函数负责
+            holders = sorted(caller for caller in self.call_graph.transitive_callers(function)
+                             if caller != function and not self.call_graph.transitive_callers(caller))
+        owners = []
+        for holder in holders:
+            chain = self.call_graph.call_chain(holder, (function,))
+            if chain and len(chain) > 1:
+                owners.append((holder, chain[1]))
+        return owners
+
+    def _leak_paths(self, owner, acquire_callee, allocation, object_id, frees, points_to):
+        """所有者中获得对象后不经释放到达出口（或再次到达获得对象的调用点）的路径"""
+        block_cfg = self.functions.get(owner, {}).get('block_cfg')
+        if block_cfg is None:
+            return []
+        if acquire_callee is None:
+            acquire_callee, acquire_lines = allocation['allocator'], {allocation['line']}
+        else:
+            acquire_lines = None
+
+        # 释放：直接free该对象，或调用传递释放该对象的函数
+        free_functions = {free['function'] for free in frees}
+        release_positions = {(free['line'], free['column']) for free in frees if free['function'] == owner}
+        releases = {}
+        acquires = []
+        for block, calls in block_cfg.block_calls.items():
+            for callee, line, column, _ in calls:
+                if (line, column) in release_positions and callee in RELEASE_FUNCTIONS or \
+                        callee != acquire_callee and any(callee == name or self.call_graph.reaches(callee, name)
+                                                        for name in free_functions):
+                    releases.setdefault(block, []).append((line, column))
+                if callee == acquire_callee and (acquire_lines is None or line in acquire_lines):
+                    acquires.append((block, (line, column)))
+
+        paths = []
+        for acquire_block, acquire_position in acquires:
+            if any(position > acquire_position for position in releases.get(acquire_block, ())):
+                continue
+            acquire_line = acquire_position[0]
+            variable = self.return_values.get((owner, acquire_line))
+            path = self._path_to_exit(block_cfg, owner, acquire_block, acquire_callee, variable, object_id,
+                                      releases, points_to)
+            if path is not None:
+                blocks, kind = path
+                lines = [block_cfg.block_start_line[block] for block in blocks if block_cfg.block_start_line[block]]
+                paths.append({
+                    'owner': owner,
+                    'acquire_line': acquire_line,
+                    'acquired_via': acquire_callee,
+                    'kind': kind,
+                    'exit_line': block_cfg.block_end_line[blocks[-1]] or acquire_line,
+                    'path_lines': lines,
+                })
+        return paths
+
+    def _path_to_exit(self, block_cfg, owner, start, acquire_callee, variable, object_id, releases, points_to):
+        """从获得对象的基本块出发、避开释放块的最短路径，返回(块列表, 'exit'|'overwritten')或None"""
+        checks = self.checks.get(owner, {})
+        parents = {start: None}
+        queue = [start]
+        while queue:
+            block = queue.pop(0)
+            failure_edges = set()
+            if block_cfg.block_kind_name(block) == 'condition':
+                for check in checks.get(block_cfg.block_end_line[block], ()):
+                    if check['callee'] == acquire_callee or (variable and check['variable'] == variable) or \
+                            self._check_covers(check, object_id, points_to):
+                        failure_edges.add(check['failure'])
+            for successor, kind in block_cfg.successors(block):
+                if kind in failure_edges:
+                    continue
+                if successor == start:
+                    return self._unwind(parents, block), 'overwritten'
+                if successor in parents or successor in releases:
+                    continue
+                parents[successor] = block
+                if successor == block_cfg.exit:
+                    return self._unwind(parents, block), 'exit'
+                queue.append(successor)
+        return None
+
+    @staticmethod
+    def _check_covers(check, object_id, points_to):
+        for source_kind, source_id in check['sources']:
+            objects = [source_id] if source_kind == 'object' else points_to.points_to(source_id)
+            if object_id in objects:
+                return True
+        return False
+
+    @staticmethod
+    def _unwind(parents, block):
+        path = []
+        while block is not None:
+            path.append(block)
+            block = parents[block]
+        return path[::-1]
+
+    def _double_frees(self):
+        """同一函数中对同一表达式的两次释放之间存在没有重新赋值的路径"""
+        # 直接释放自己参数的函数：参数序号集合
+        param_freeing = {}
+        for free in self.frees:
+            if free['callee'] not in FREE_FUNCTIONS:
+                continue
+            parameters = self.functions.get(free['function'], {}).get('parameters', [])
+            for index, param in enumerate(parameters):
+                if param['name'] == free['expression']:
+                    param_freeing.setdefault(free['function'], set()).add(index)
+
+        events = {}  # 函数 -> [((行号, 列号), 表达式, 经由的函数)]
+        for free in self.frees:
+            if free['callee'] in FREE_FUNCTIONS:
+                events.setdefault(free['function'], []).append(((free['line'], free['column']), free['expression'],
+                                                                None))
+        for function, func_info in self.functions.items():
+            for call in func_info.get('calls', []) or []:
+                indexes = param_freeing.get(call['function'])
+                if not indexes:
+                    continue
+                position = location_position(call['location'])
+                for index in indexes:
+                    if index < len(call['arguments']):
+                        events.setdefault(function, []).append((position, call['arguments'][index],
+                                                                call['function']))
+
+        double_frees = []
+        for function, function_events in events.items():
+            block_cfg = self.functions.get(function, {}).get('block_cfg')
+            if block_cfg is None:
+                continue
+            blocks = {}
+            for block, calls in block_cfg.block_calls.items():
+                for _, line, column, _ in calls:
+                    blocks.setdefault((line, column), block)
+            kills = {}
+            for position, target in self.assignments.get(function, ()):
+                kills.setdefault(target, []).append(position)
+            function_events.sort()
+            for first in function_events:
+                for second in function_events:
+                    if first[1] != second[1] or first[1] == '':
+                        continue
+                    if self._reaches_without_kill(block_cfg, blocks, first[0], second[0],
+                                                  kills.get(first[1], [])):
+                        double_frees.append({
+                            'function': function,
+                            'expression': first[1],
+                            'first_line': first[0][0],
+                            'first_column': first[0][1],
+                            'first_via': first[2],
+                            'second_line': second[0][0],
+                            'second_column': second[0][1],
+                            'second_via': second[2],
+                        })
+        return double_frees
+
+    @staticmethod
+    def _reaches_without_kill(block_cfg, blocks, first, second, kills):
+        """第一次释放之后能否不经重新赋值到达第二次释放（位置均为(行号, 列号)）"""
+        first_block, second_block = blocks.get(first), blocks.get(second)
+        if first_block is None or second_block is None:
+            return False
+
+        def killed(block, after=None, before=None):
+            start, end = block_cfg.block_start_line[block], block_cfg.block_end_line[block]
+            return any(start <= position[0] <= end and (after is None or position > after)
+                       and (before is None or position < before) for position in kills)
+
+        if first_block == second_block and second > first:
+            return not killed(first_block, after=first, before=second)
+        if killed(first_block, after=first):
+            return False
+        seen = {first_block}
+        queue = [first_block]
+        while queue:
+            block = queue.pop(0)
+            for successor, _ in block_cfg.successors(block):
+                if successor == second_block:
+                    if not killed(successor, before=second):
+                        return True
+                    continue
+                if successor in seen or killed(successor):
+                    continue
+                seen.add(successor)
+                queue.append(successor)
+        return False
+
+    @staticmethod
+    def summary(report, limit=10):
+        lines = []
+        for site in report['sites'][:limit]:
+            size = f"{site['bytes']} bytes" if site['bytes'] is not None else (site['size_expression'] or 'unknown size')
+            line = f"{site['allocator']}({size}) in {site['function']}:{site['line']}: {site['status']}"
+            if site['release_functions']:
+                line += f", freed in {', '.join(site['release_functions'])}"
+            for path in site['leak_paths'][:2]:
+                how = 'pointer overwritten' if path['kind'] == 'overwritten' else f"exits at line {path['exit_line']}"
+                line += f"; {path['owner']}:{path['acquire_line']} {how} without free"
+            lines.append(line)
+        for item in report['double_frees'][:limit]:
+            first = f" via {item['first_via']}" if item['first_via'] else ''
+            second = f" via {item['second_via']}" if item['second_via'] else ''
+            lines.append(f"double free of {item['expression']} in {item['function']}: "
+                         f"line {item['first_line']}:{item['first_column']}{first}, "
+                         f"line {item['second_line']}:{item['second_column']}{second}")
+        return lines
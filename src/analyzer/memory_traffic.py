@@ -0,0 +1,211 @@
+"""内存访问量与指针追逐估计模块
+
+遍历函数体时分析器登记每个内存访问表达式：
+- field：结构体字段访问，p->f经指针访问，s.f为直接访问
+- deref：*p解引用
+- element：数组元素访问，p[i]经指针访问，局部或全局数组a[i]为直接访问
+- global：全局/静态标量变量
+
+经指针的访问需要先得到指针值，指针值本身又可能来自内存（p->next->next->id）。
+访问的依赖链长度是求出被访问地址所需的串行读取次数加一，链越长，缓存未命中越无法并行。
+赋值、复合赋值和自增自减的左值按写登记，同一位置的读写合并。
+
+每个函数的估计值：
+- 读写次数（按循环深度加权，每层循环放大LOOP_WEIGHT倍）
+- 经指针访问的最长依赖链，以及链表遍历循环（p = p->next）中的循环携带依赖：
+  下一次迭代的地址来自本次迭代的读取，未命中完全串行
+- 访问的结构体字段及其在结构体布局中占用的缓存行数
+
+缓存未命中压力 = 经指针访问的依赖链长度之和（按循环深度加权，指针追逐循环中的访问再乘2），
+按该值给函数排序。
+"""
+
+import clang.cindex
+
+from .cursor_tokens import unary_operator
+from .struct_layout import CACHE_LINE_SIZE, LOOP_WEIGHT
+from .symbol_table import SymbolTable
+
+
+CHASING_WEIGHT = 2
+
+
+def _pointer_expression(expr):
+    expr = SymbolTable.strip(expr)
+    return expr is not None and expr.type.get_canonical().kind == clang.cindex.TypeKind.POINTER
+
+
+class MemoryTrafficAnalyzer:
+    """函数级内存访问量与指针追逐估计"""
+
+    def __init__(self, cache_line_size=CACHE_LINE_SIZE):
+        self.cache_line_size = cache_line_size
+        self.accesses = {}  # (访问位置, 访问类型) -> 访问信息
+        self._writes = set()  # 作为左值被写入的(表达式位置, 访问类型)
+
+    @staticmethod
+    def dependence_depth(expr):
+        """求出表达式的值需要的串行内存读取次数（局部变量和参数按寄存器计）"""
+        expr = SymbolTable.strip(expr)
+        if expr is None:
+            return 0
+        kind = expr.kind
+        children = list(expr.get_children())
+        if kind == clang.cindex.CursorKind.MEMBER_REF_EXPR and children:
+            base = children[0]
+            # 嵌入的结构体（a.b.f）不需要额外读取
+            return MemoryTrafficAnalyzer.dependence_depth(base) + (1 if _pointer_expression(base) else 0)
+        if kind == clang.cindex.CursorKind.ARRAY_SUBSCRIPT_EXPR and len(children) == 2:
+            depth = max(MemoryTrafficAnalyzer.dependence_depth(child) for child in children)
+            return depth + (1 if _pointer_expression(children[0]) else 0)
+        if kind == clang.cindex.CursorKind.UNARY_OPERATOR and children:
+            operator = unary_operator(expr)
+            if operator == '*':
+                return MemoryTrafficAnalyzer.dependence_depth(children[0]) + 1
+            if operator == '&':
+                # 取地址只计算地址，不读取
+                operand = SymbolTable.strip(children[0])
+                if operand is not None and operand.kind == clang.cindex.CursorKind.MEMBER_REF_EXPR:
+                    return MemoryTrafficAnalyzer.dependence_depth(next(operand.get_children(), None))
+                return 0
+        if kind == clang.cindex.CursorKind.CALL_EXPR:
+            return 0
+        return max((MemoryTrafficAnalyzer.dependence_depth(child) for child in children), default=0)
+
+    def mark_write(self, location, kind):
+        """登记一个被写入的左值表达式"""
+        self._writes.add((location, kind))
+
+    def add_access(self, function, kind, line, location, indirect, depth, field=None, layout=None):
+        """登记一次内存访问
+        Args:
+            kind: 'field'、'deref'、'element'或'global'
+            indirect: 是否经指针访问
+            depth: 依赖链长度（包括本次访问）
+            field: 字段访问的"结构体名.字段名"
+            layout: 字段所属结构体在结构体布局报告中的限定名
+        """
+        if (location, kind) in self.accesses:
+            return
+        self.accesses[(location, kind)] = {
+            'function': function,
+            'kind': kind,
+            'line': line,
+            'indirect': indirect,
+            'depth': depth,
+            'field': field,
+            'layout': layout,
+        }
+
+    def analyze(self, analyzer):
+        """计算每个函数的内存访问估计，写入函数信息的memory_traffic键
+        Returns:
+            按缓存未命中压力排序的函数列表
+        """
+        chasing = {}
+        for loop in analyzer.list_traversal_report:
+            chasing.setdefault(loop['function'], []).append(loop)
+
+        by_function = {}
+        for key, access in self.accesses.items():
+            by_function.setdefault(access['function'], []).append((key, access))
+
+        report = []
+        for function, func_info in analyzer.functions.items():
+            if not func_info.get('has_body'):
+                continue
+            traffic = self._function_traffic(by_function.get(function, []), func_info.get('block_cfg'),
+                                             chasing.get(function, []), analyzer.struct_layout_report)
+            func_info['memory_traffic'] = traffic
+            if traffic['loads'] or traffic['stores']:
+                report.append({'function': function, **traffic})
+        report.sort(key=lambda item: (-item['pressure'], -item['max_chain'], -item['indirect_loads'],
+                                      item['function']))
+        return report
+
+    def _function_traffic(self, accesses, block_cfg, chasing_loops, layouts):
+        loads = stores = indirect_loads = indirect_stores = 0
+        weighted_loads = weighted_stores = 0
+        pressure = 0
+        max_chain = 0
+        deepest = None
+        fields_read = set()
+        fields_written = set()
+        field_layouts = {}
+        kinds = {}
+        for key, access in sorted(accesses, key=lambda item: item[1]['line']):
+            write = key in self._writes
+            line = access['line']
+            loop_depth = block_cfg.loop_depth_at(line) if block_cfg is not None else 0
+            weight = LOOP_WEIGHT ** loop_depth
+            kinds[access['kind']] = kinds.get(access['kind'], 0) + 1
+            if write:
+                stores += 1
+                weighted_stores += weight
+                indirect_stores += access['indirect']
+            else:
+                loads += 1
+                weighted_loads += weight
+                indirect_loads += access['indirect']
+            if access['field']:
+                (fields_written if write else fields_read).add(access['field'])
+                field_layouts[access['field']] = access['layout']
+            if not access['indirect']:
+                continue
+            chased = any(loop['line'] <= line <= loop['end_line'] for loop in chasing_loops)
+            pressure += access['depth'] * weight * (CHASING_WEIGHT if chased else 1)
+            if access['depth'] > max_chain:
+                max_chain = access['depth']
+                deepest = {'line': line, 'depth': access['depth'], 'field': access['field']}
+
+        touched = fields_read | fields_written
+        return {
+            'loads': loads,
+            'stores': stores,
+            'indirect_loads': indirect_loads,
+            'indirect_stores': indirect_stores,
+            'weighted_loads': weighted_loads,
+            'weighted_stores': weighted_stores,
+            'accesses_by_kind': kinds,
+            'max_chain': max_chain,
+            'deepest_chain': deepest,
+            'pointer_chasing_loops': [{'line': loop['line'], 'link': loop['link']} for loop in chasing_loops],
+            'fields_read': sorted(fields_read),
+            'fields_written': sorted(fields_written),
+            'cache_lines_touched': self._cache_lines(touched, field_layouts, layouts),
+            'pressure': pressure,
+        }
+
+    def _cache_lines(self, fields, field_layouts, layouts):
+        """访问的字段在各结构体布局中占用的缓存行数（按对象与缓存行对齐计算），以结构体限定名为键"""
+        line_size = self.cache_line_size
+        lines = {}
+        for label in fields:
+            name = label.rpartition('.')[2]
+            record = field_layouts.get(label)
+            layout = layouts.get(record)
+            if layout is None:
+                continue
+            for field in layout['fields']:
+                if field['name'] == name and field['size']:
+                    for line in range(field['offset'] // line_size,
+                                      (field['offset'] + field['size'] - 1) // line_size + 1):
+                        lines.setdefault(record, set()).add(line)
+        return {record: len(record_lines) for record, record_lines in sorted(lines.items())}
+
+    @staticmethod
+    def summary(report, limit=10):
+        lines = []
+        for item in report[:limit]:
+            if not item['pressure']:
+                break
+            line = (f"{item['function']}: pressure {item['pressure']}, {item['indirect_loads']} pointer load(s), "
+                    f"{item['indirect_stores']} pointer store(s), longest chain {item['max_chain']}")
+            if item['pointer_chasing_loops']:
+                links = ', '.join(loop['link'] for loop in item['pointer_chasing_loops'])
+                line += f", chases {links}"
+            fields = len(set(item['fields_read']) | set(item['fields_written']))
+            if fields:
+                line += f", {fields} field(s)"
+            lines.append(line)
+        return lines
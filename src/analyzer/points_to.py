@@ -0,0 +1,234 @@
+"""指针指向分析模块
+
+基于包含约束的流不敏感、上下文不敏感指针分析（Andersen风格）：
+- 节点：变量符号、结构体字段（按字段区分、不区分基址）、抽象对象的内容、
+  解引用表达式的读写位置、函数参数和返回值
+- 抽象对象：堆分配点、取地址的变量、函数地址；变量对象的内容就是该变量的符号节点，
+  堆对象的内容是单独的节点，函数对象没有内容
+- 约束：取地址（对象加入节点的指向集合）、复制（源节点的指向集合包含于目标节点）、
+  读取（x = *p：pts(p)中每个对象的内容流入x）和写入（*p = y：y流入pts(p)中每个对象的内容）
+
+求解时先把复制边整理为CSR数组，用迭代Tarjan算法求强连通分量并收缩，
+再按拓扑序一次性传播指向集合（以Python整数作为位集合），
+总代价为O(节点数 + 边数)次位集合并运算，不需要反复扫描全部边。
+存在读写约束时再以工作表迭代到不动点：指针节点的指向集合中新增的对象
+为读取添加"对象内容 -> 目标"、为写入添加"来源 -> 对象内容"的复制边，并沿新边继续传播。
+"""
+
+from array import array
+from collections import deque
+
+import numpy as np
+
+from .graph_store import build_csr, strongly_connected_components
+
+
+class PointsToGraph:
+    """指针约束图及其求解器"""
+
+    def __init__(self):
+        self._node_ids = {}  # 节点键 -> 节点id
+        self.node_keys = []  # 节点id -> 节点键
+        self.node_labels = []  # 节点id -> 可读名称
+        self._object_ids = {}  # 对象键 -> 对象id
+        self.objects = []  # 对象id -> 对象信息字典
+        # 复制边以紧凑的整数数组保存，求解时零拷贝转换为numpy数组
+        self._copy_sources = array('q')
+        self._copy_targets = array('q')
+        self._object_nodes = []  # 对象id -> 对象内容节点id（函数对象为None）
+        self._loads = []  # [(指针节点id, 目标节点id)]：目标 ⊇ *指针
+        self._stores = []  # [(来源节点id, 指针节点id)]：*指针 ⊇ 来源
+        self._base = {}  # 节点id -> 直接取地址得到的对象位集合
+        self._heap_mask = 0
+        self._points_to = None  # 求解结果：节点id -> 对象位集合
+
+    def node(self, key, label=None):
+        """返回节点id，不存在时创建"""
+        node_id = self._node_ids.get(key)
+        if node_id is None:
+            node_id = len(self.node_keys)
+            self._node_ids[key] = node_id
+            self.node_keys.append(key)
+            self.node_labels.append(label if label is not None else str(key))
+            self._points_to = None
+        return node_id
+
+    def find_node(self, key):
+        return self._node_ids.get(key)
+
+    def object(self, kind, key, label, node=None, **info):
+        """返回抽象对象id，不存在时创建
+        Args:
+            kind: 对象类型，'heap'（堆分配点）、'variable'（取地址的变量）或'function'（函数地址）
+            key: 对象的唯一键（如分配点位置、变量限定名、函数名）
+            label: 可读名称
+            node: 对象内容对应的节点id（如取地址变量的符号节点），不指定时创建单独的内容节点
+            info: 附加信息（如分配函数、所在函数、位置）
+        """
+        object_key = (kind, key)
+        object_id = self._object_ids.get(object_key)
+        if object_id is None:
+            object_id = len(self.objects)
+            self._object_ids[object_key] = object_id
+            self.objects.append({'id': object_id, 'kind': kind, 'label': label, **info})
+            if kind == 'function':
+                node = None
+            elif node is None:
+                node = self.node(('object', object_id), f"*{label}")
+            self._object_nodes.append(node)
+            if kind == 'heap':
+                self._heap_mask |= 1 << object_id
+        return object_id
+
+    def object_node(self, object_id):
+        """对象内容对应的节点id，函数对象返回None"""
+        return self._object_nodes[object_id]
+
+    def add_address(self, node_id, object_id):
+        """约束：对象 ∈ pts(节点)"""
+        self._base[node_id] = self._base.get(node_id, 0) | (1 << object_id)
+        self._points_to = None
+
+    def add_copy(self, source_id, target_id):
+        """约束：pts(源节点) ⊆ pts(目标节点)"""
+        if source_id != target_id:
+            self._copy_sources.append(source_id)
+            self._copy_targets.append(target_id)
+            self._points_to = None
+
+    def add_load(self, pointer_id, target_id):
+        """约束：对pts(指针节点)中的每个对象o，pts(o的内容) ⊆ pts(目标节点)"""
+        self._loads.append((pointer_id, target_id))
+        self._points_to = None
+
+    def add_store(self, source_id, pointer_id):
+        """约束：对pts(指针节点)中的每个对象o，pts(源节点) ⊆ pts(o的内容)"""
+        self._stores.append((source_id, pointer_id))
+        self._points_to = None
+
+    @property
+    def edge_count(self):
+        return len(self._copy_sources)
+
+    def solve(self):
+        """求解全部约束，结果缓存到再次添加约束为止"""
+        node_count = len(self.node_keys)
+        if node_count == 0:
+            self._points_to = []
+            return self._points_to
+
+        indptr, columns, sources, targets = build_csr(node_count, self._copy_sources, self._copy_targets)
+        components, component_count = strongly_connected_components(
+            node_count, indptr.tolist(), columns.tolist())
+
+        # 收缩强连通分量：同一分量中的节点指向集合相同
+        component_points_to = [0] * component_count
+        for node_id, bits in self._base.items():
+            component_points_to[components[node_id]] |= bits
+
+        component_array = np.asarray(components, dtype=np.int64)
+        component_sources = component_array[sources]
+        component_targets = component_array[targets]
+        cross = component_sources != component_targets
+        component_indptr, component_columns, _, _ = build_csr(
+            component_count, component_sources[cross], component_targets[cross])
+        component_indptr = component_indptr.tolist()
+        component_columns = component_columns.tolist()
+
+        # 分量编号为逆拓扑序，从大到小处理时所有前驱都已处理完毕
+        for component in range(component_count - 1, -1, -1):
+            bits = component_points_to[component]
+            if not bits:
+                continue
+            for position in range(component_indptr[component], component_indptr[component + 1]):
+                successor = component_columns[position]
+                component_points_to[successor] |= bits
+
+        if self._loads or self._stores:
+            self._solve_complex(components, component_points_to, component_indptr, component_columns)
+
+        self._points_to = [component_points_to[component] for component in components]
+        return self._points_to
+
+    def _solve_complex(self, components, component_points_to, component_indptr, component_columns):
+        """以工作表求解读写约束，直到指向集合不再变化"""
+        successors = [set(component_columns[component_indptr[component]:component_indptr[component + 1]])
+                      for component in range(len(component_points_to))]
+        loads = {}
+        for pointer_id, target_id in self._loads:
+            loads.setdefault(components[pointer_id], set()).add(components[target_id])
+        stores = {}
+        for source_id, pointer_id in self._stores:
+            stores.setdefault(components[pointer_id], set()).add(components[source_id])
+        content_components = [components[node_id] if node_id is not None else None
+                              for node_id in self._object_nodes]
+
+        worklist = deque(component for component in set(loads) | set(stores) if component_points_to[component])
+        queued = set(worklist)
+
+        def propagate(source, target):
+            if component_points_to[source] & ~component_points_to[target]:
+                component_points_to[target] |= component_points_to[source]
+                if target not in queued:
+                    queued.add(target)
+                    worklist.append(target)
+
+        def connect(source, target):
+            if source != target and target not in successors[source]:
+                successors[source].add(target)
+                propagate(source, target)
+
+        handled = {}  # 分量 -> 已为读写约束展开过的对象位集合
+        while worklist:
+            component = worklist.popleft()
+            queued.discard(component)
+            bits = component_points_to[component]
+            new_bits = bits & ~handled.get(component, 0)
+            if new_bits and (component in loads or component in stores):
+                handled[component] = bits
+                for object_id in self._bits_to_ids(new_bits):
+                    content = content_components[object_id]
+                    if content is None:
+                        continue
+                    for target in loads.get(component, ()):
+                        connect(content, target)
+                    for source in stores.get(component, ()):
+                        connect(source, content)
+            for successor in successors[component]:
+                propagate(component, successor)
+
+    def points_to(self, node_id):
+        """返回节点可能指向的对象id列表"""
+        if self._points_to is None:
+            self.solve()
+        return self._bits_to_ids(self._points_to[node_id])
+
+    def points_to_key(self, key):
+        node_id = self._node_ids.get(key)
+        return [] if node_id is None else self.points_to(node_id)
+
+    def may_point_to_heap(self, node_id):
+        if self._points_to is None:
+            self.solve()
+        return bool(self._points_to[node_id] & self._heap_mask)
+
+    def to_dict(self):
+        """导出为可JSON序列化的字典：抽象对象列表，以及每个节点可能指向的对象id"""
+        return {'objects': self.objects, 'nodes': dict(self.iter_nodes())}
+
+    def iter_nodes(self):
+        """逐个产生指向集合非空的节点：(节点标签, 对象id列表)，供流式导出使用"""
+        if self._points_to is None:
+            self.solve()
+        for node_id, bits in enumerate(self._points_to):
+            if bits:
+                yield self.node_labels[node_id], self._bits_to_ids(bits)
+
+    @staticmethod
+    def _bits_to_ids(bits):
+        ids = []
+        while bits:
+            low_bit = bits & -bits
+            ids.append(low_bit.bit_length() - 1)
+            bits ^= low_bit
+        return ids
@@ -0,0 +1,282 @@
+"""分析结果流式导出模块
+
+export_to_json先把全部结果组装成一个字典再整体序列化，峰值内存是图规模的数倍。
+本模块边遍历分析器的数据结构边写出，内存占用只与单条记录（单个函数、单条边）相关：
+- JSONL格式：每行一条带"record"字段的记录，可逐行读取
+- JSON格式：与analysis_result.json结构相同的单个JSON文档，逐项写出（指针分析结果也逐个节点写出）
+- 紧凑分隔符，不缩进；可选gzip或zstd压缩（zstd需要安装zstandard包）
+
+JSONL记录类型：
+    header          {"record":"header","format_version":1,"files":[...]}
+    function        {"record":"function","name":...,<函数信息>}
+    variable        {"record":"variable","qualified_name":...,<符号信息>}
+    call            {"record":"call","caller":...,"callee":...}
+    node            {"record":"node","graph":"control_flow"|"data_flow"|"business_logic","id":...,<属性>}
+    edge            {"record":"edge","graph":...,"source":...,"target":...,<属性>}
+    variable_set    {"record":"variable_set","name":"global_vars"|"static_vars"|"heap_vars","values":[...]}
+    points_to_object {"record":"points_to_object",<抽象对象信息>}
+    points_to       {"record":"points_to","node":...,"objects":[对象id...]}
+    call_graph      {"record":"call_graph","components":[...],"recursive_groups":[...],"functions":{...}}
+    indirect_call   {"record":"indirect_call","caller":...,"function":<函数指针表达式>,"targets":[...],...}
+    struct_layout   {"record":"struct_layout","name":...,"qualified_name":<文件::结构体名>,"size":...,"holes":[...],"suggestions":[...],...}
+    allocation_site {"record":"allocation_site","function":...,"line":...,"kind":"allocate"|"free","call_chain":[...],...}
+    list_traversal  {"record":"list_traversal","function":...,"kind":"search"|"filter"|"walk","callers":[...],...}
+    function_cost   {"record":"function_cost","function":...,"complexity":"O(n^2)","degree":2,"cost_chain":[...],...}
+    entry_cost      {"record":"entry_cost","entry":...,"functions":[代价最高的可达函数...]}
+    thread          {"record":"thread","entry":...,"origin":"thread_create"|"configured"|"creator",...}
+    shared_data     {"record":"shared_data","target":...,"kind":"global"|"field","writers":[...],"contended":...,...}
+    false_sharing   {"record":"false_sharing","record_name":...,"layout":<结构体限定名>,"cache_line":...,"pairs":[...],...}
+    lock            {"record":"lock","lock":...,"acquisitions":[...],"threads":[...],"long_sections":...,...}
+    critical_section {"record":"critical_section","function":...,"lock":...,"acquire_line":...,"reasons":[...],...}
+    lock_inversion  {"record":"lock_inversion","locks":[...],"edges":[...]}
+    blocking_call   {"record":"blocking_call","function":...,"callee":...,"class":"sleep"|"file_io"|...,"root":...,"call_chain":[...],...}
+    memory_traffic  {"record":"memory_traffic","function":...,"pressure":...,"max_chain":...,"fields_read":[...],...}
+    allocation_escape {"record":"allocation_escape","function":...,"allocator":...,"escape":"local"|"returned"|"heap"|...,"candidate":...,...}
+    allocation_lifetime {"record":"allocation_lifetime","function":...,"allocator":...,"bytes":...,"status":"paired"|"leak_path"|...,"freed_at":[...],"leak_paths":[...],...}
+    double_free     {"record":"double_free","function":...,"expression":...,"first_line":...,"first_column":...,"second_line":...,"second_column":...}
+    end             {"record":"end","counts":{记录类型: 条数}}
+最后一行的end记录可用于判断文件是否完整写出。
+"""
+
+import gzip
+import io
+import json
+
+from .function_cfg import FunctionCFG
+from .graph_store import CompactDiGraph
+
+
+class StreamingResultExporter:
+    """分析结果流式导出器"""
+
+    FORMATS = ('jsonl', 'json')
+    COMPRESSIONS = (None, 'gzip', 'zstd')
+    SUFFIXES = {None: '', 'gzip': '.gz', 'zstd': '.zst'}
+    FORMAT_VERSION = 1
+
+    # 各图在导出结果中的名称与对应的分析器属性
+    GRAPHS = (('control_flow', 'cfg'), ('data_flow', 'global_dfg'), ('business_logic', 'business_logic'))
+    VARIABLE_SETS = ('global_vars', 'static_vars', 'heap_vars')
+
+    def __init__(self, output_file, fmt='jsonl', compress=None):
+        """初始化导出器
+        Args:
+            output_file: 输出文件路径（启用压缩时自动追加.gz或.zst后缀）
+            fmt: 输出格式，'jsonl'或'json'
+            compress: 压缩方式，None、'gzip'或'zstd'
+        """
+        if fmt not in self.FORMATS:
+            raise ValueError(f"不支持的导出格式: {fmt}，可选: {', '.join(self.FORMATS)}")
+        if compress not in self.COMPRESSIONS:
+            raise ValueError(f"不支持的压缩方式: {compress}，可选: gzip, zstd")
+
+        self.output_file = output_file + self.SUFFIXES[compress]
+        self.fmt = fmt
+        self.compress = compress
+        self.counts = {}
+
+        self._encoder = json.JSONEncoder(separators=(',', ':'), ensure_ascii=False, default=self._default)
+
+    def export(self, analyzer):
+        """导出分析器的全部结果，返回各类记录的条数"""
+        self.counts = {}
+        out = self._open()
+        try:
+            if self.fmt == 'jsonl':
+                self._write_jsonl(out, analyzer)
+            else:
+                self._write_json(out, analyzer)
+        finally:
+            out.close()
+        return self.counts
+
+    def _open(self):
+        if self.compress == 'gzip':
+            return gzip.open(self.output_file, 'wt', encoding='utf-8')
+        if self.compress == 'zstd':
+            try:
+                import zstandard
+            except ImportError:
+                raise RuntimeError("zstd压缩需要安装zstandard包: pip install zstandard") from None
+            raw = open(self.output_file, 'wb')
+            # 关闭文本包装时依次关闭压缩写入器和底层文件
+            writer = zstandard.ZstdCompressor().stream_writer(raw, closefd=True)
+            return io.TextIOWrapper(writer, encoding='utf-8')
+        return open(self.output_file, 'w', encoding='utf-8', buffering=1 << 20)
+
+    # 记录生成：JSONL与JSON两种格式共用，每次只产生一条记录
+    @staticmethod
+    def _iter_functions(analyzer):
+        """按export_to_json的顺序输出函数：先输出有函数体的定义，再输出其余声明"""
+        defined = set()
+        for name, func_info in analyzer.functions.items():
+            if not func_info.get('is_declaration', True) and func_info.get('has_body', False):
+                defined.add(name)
+                yield name, func_info
+        for name, func_info in analyzer.functions.items():
+            if name not in defined:
+                yield name, func_info
+
+    @staticmethod
+    def _iter_graph(graph):
+        for node, data in graph.nodes(data=True):
+            yield 'node', {'id': node, **data}
+        for source, target, data in graph.edges(data=True):
+            yield 'edge', {'source': source, 'target': target, **data}
+
+    @staticmethod
+    def _iter_calls(analyzer):
+        for call_info in analyzer.function_calls:
+            yield {'caller': call_info['caller'], 'callee': call_info['function']}
+
+    @staticmethod
+    def _default(value):
+        """JSON编码器无法直接处理的值：集合、紧凑图、基本块控制流图"""
+        if isinstance(value, (set, frozenset)):
+            return list(value)
+        if isinstance(value, CompactDiGraph):
+            return {
+                'nodes': [{'id': node, **data} for node, data in value.nodes(data=True)],
+                'edges': [{'source': source, 'target': target, **data}
+                          for source, target, data in value.edges(data=True)]
+            }
+        if isinstance(value, FunctionCFG):
+            return value.to_dict()
+        return str(value)
+
+    # JSONL
+    def _write_jsonl(self, out, analyzer):
+        encode = self._encoder.encode
+
+        def emit(record_type, record):
+            out.write(encode({'record': record_type, **record}))
+            out.write('\n')
+            self.counts[record_type] = self.counts.get(record_type, 0) + 1
+
+        emit('header', {'format_version': self.FORMAT_VERSION, 'files': analyzer.files})
+        for name, func_info in self._iter_functions(analyzer):
+            emit('function', {'name': name, **func_info})
+        for qualified_name, symbol in analyzer.symbols.items():
+            emit('variable', {'qualified_name': qualified_name, **symbol.to_dict()})
+        for call in self._iter_calls(analyzer):
+            emit('call', call)
+        for graph_name, attribute in self.GRAPHS:
+            for record_type, record in self._iter_graph(getattr(analyzer, attribute)):
+                emit(record_type, {'graph': graph_name, **record})
+        for set_name in self.VARIABLE_SETS:
+            emit('variable_set', {'name': set_name, 'values': getattr(analyzer, set_name)})
+        for obj in analyzer.points_to.objects:
+            emit('points_to_object', obj)
+        for label, object_ids in analyzer.points_to.iter_nodes():
+            emit('points_to', {'node': label, 'objects': object_ids})
+        if analyzer.call_graph is not None:
+            emit('call_graph', analyzer.call_graph.to_dict())
+        for call_info in analyzer.indirect_calls.values():
+            emit('indirect_call', call_info)
+        for layout in analyzer.struct_layout_report.values():
+            emit('struct_layout', layout)
+        for site in analyzer.allocation_report.get('sites', []):
+            emit('allocation_site', site)
+        for loop in analyzer.list_traversal_report:
+            emit('list_traversal', loop)
+        for name, cost in analyzer.cost_report.get('functions', {}).items():
+            emit('function_cost', {'function': name, **cost})
+        for entry, functions in analyzer.cost_report.get('entry_points', {}).items():
+            emit('entry_cost', {'entry': entry, 'functions': functions})
+        for thread in analyzer.shared_state_report.get('threads', []):
+            emit('thread', thread)
+        for info in analyzer.shared_state_report.get('shared', []):
+            emit('shared_data', info)
+        for item in analyzer.shared_state_report.get('false_sharing', []):
+            # record字段已用于记录类型
+            emit('false_sharing', {'record_name': item['record'],
+                                   **{key: value for key, value in item.items() if key != 'record'}})
+        for lock in analyzer.lock_report.get('locks', []):
+            emit('lock', lock)
+        for section in analyzer.lock_report.get('critical_sections', []):
+            emit('critical_section', section)
+        for inversion in analyzer.lock_report.get('inversions', []):
+            emit('lock_inversion', inversion)
+        for site in analyzer.blocking_report.get('sites', []):
+            emit('blocking_call', site)
+        for item in analyzer.memory_traffic_report:
+            emit('memory_traffic', item)
+        for site in analyzer.escape_report.get('sites', []):
+            emit('allocation_escape', site)
+        for site in analyzer.memory_lifetime_report.get('sites', []):
+            emit('allocation_lifetime', site)
+        for item in analyzer.memory_lifetime_report.get('double_frees', []):
+            emit('double_free', item)
+
+        out.write(encode({'record': 'end', 'counts': self.counts}))
+        out.write('\n')
+
+    # JSON（与export_to_json相同的文档结构）
+    def _write_json(self, out, analyzer):
+        encode = self._encoder.encode
+
+        def write_object(section, items, counter=None):
+            out.write(f'{encode(section)}:{{')
+            count = 0
+            for key, value in items:
+                if count:
+                    out.write(',')
+                out.write(f'{encode(key)}:{encode(value)}')
+                count += 1
+            out.write('}')
+            self.counts[counter or section] = count
+
+        def write_array(items):
+            out.write('[')
+            count = 0
+            for value in items:
+                if count:
+                    out.write(',')
+                out.write(encode(value))
+                count += 1
+            out.write(']')
+            return count
+
+        def write_graph(section, graph):
+            out.write(f'{encode(section)}:{{"nodes":')
+            nodes = write_array({'id': node, **data} for node, data in graph.nodes(data=True))
+            out.write(',"edges":')
+            edges = write_array({'source': source, 'target': target, **data}
+                                for source, target, data in graph.edges(data=True))
+            out.write('}')
+            self.counts[section] = nodes + edges
+
+        out.write(f'{{"files":{encode(analyzer.files)},')
+        write_object('variables', ((name, symbol.to_dict()) for name, symbol in analyzer.symbols.items()))
+        out.write(',"function_calls":')
+        self.counts['function_calls'] = write_array(self._iter_calls(analyzer))
+        for graph_name, attribute in self.GRAPHS:
+            out.write(',')
+            write_graph(graph_name, getattr(analyzer, attribute))
+        out.write(',')
+        write_object('functions', self._iter_functions(analyzer))
+        for set_name in self.VARIABLE_SETS:
+            out.write(f',{encode(set_name)}:{encode(getattr(analyzer, set_name))}')
+        out.write(',"points_to":{"objects":')
+        self.counts['points_to_object'] = write_array(analyzer.points_to.objects)
+        out.write(',')
+        write_object('nodes', analyzer.points_to.iter_nodes(), 'points_to')
+        out.write('}')
+        call_graph = analyzer.call_graph.to_dict() if analyzer.call_graph is not None else None
+        out.write(f',"call_graph":{encode(call_graph)}')
+        out.write(',"indirect_calls":')
+        self.counts['indirect_calls'] = write_array(analyzer.indirect_calls.values())
+        out.write(',')
+        write_object('struct_layouts', analyzer.struct_layout_report.items())
+        out.write(f',"allocations":{encode(analyzer.allocation_report)}')
+        out.write(',"list_traversals":')
+        self.counts['list_traversals'] = write_array(analyzer.list_traversal_report)
+        out.write(f',"complexity":{encode(analyzer.cost_report)}')
+        out.write(f',"shared_state":{encode(analyzer.shared_state_report)}')
+        out.write(f',"locks":{encode(analyzer.lock_report)}')
+        out.write(f',"blocking_calls":{encode(analyzer.blocking_report)}')
+        out.write(',"memory_traffic":')
+        self.counts['memory_traffic'] = write_array(analyzer.memory_traffic_report)
+        out.write(f',"escape_analysis":{encode(analyzer.escape_report)}')
+        out.write(f',"memory_lifetime":{encode(analyzer.memory_lifetime_report)}')
+        out.write('}\n')
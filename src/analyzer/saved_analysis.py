@@ -0,0 +1,280 @@
+"""已保存分析结果的按需读取模块
+
+打开analyze_c_code.py --store写出的SQLite分析结果库，提供与CCodeAnalyzer相同的属性
+（functions、variables、function_calls、cfg、global_dfg、business_logic、call_graph、
+global_vars、static_vars、heap_vars），工具可以直接复用面向分析器编写的代码，
+不需要重新分析源码，也不需要解析完整的JSON。
+
+所有数据都在首次访问时才从库中读取：
+- functions/variables是按键查询的映射，访问单个函数或变量只读取对应的行
+- 函数信息中的local_dfg和side_effects在首次访问该键时才构建
+- cfg、global_dfg等全局图在首次访问属性时构建
+"""
+
+import json
+from collections.abc import Mapping
+
+from .analysis_store import AnalysisStore
+from .call_graph import CallGraphIndex
+from .graph_store import CompactDiGraph
+
+
+# 副作用类别中以集合保存的全局变量读写，以及其余类别记录中保存对象的字段名
+SIDE_EFFECT_SETS = ('global_vars_read', 'global_vars_write')
+SIDE_EFFECT_SUBJECT_KEYS = {
+    'heap_operations': 'variable',
+    'file_operations': 'file',
+    'network_operations': 'target',
+    'sync_operations': 'target',
+}
+
+
+def _format_location(file_name, line, column):
+    if file_name is None:
+        return None
+    if column is None:
+        return f"{file_name}:{line}"
+    return f"{file_name}:{line}:{column}"
+
+
+class _LazyFunction(Mapping):
+    """单个函数的信息，键与CCodeAnalyzer.functions中的函数信息字典相同"""
+
+    KEYS = ('name', 'start_line', 'end_line', 'return_type', 'parameters', 'local_variables', 'calls',
+            'location', 'is_declaration', 'has_body', 'local_dfg', 'side_effects', 'block_cfg', 'memory_traffic')
+
+    # details列（JSON）中保存的键
+    DETAIL_KEYS = ('location', 'parameters', 'local_variables', 'calls', 'block_cfg', 'memory_traffic')
+
+    def __init__(self, analysis, row):
+        self._analysis = analysis
+        self._data = {
+            'name': row['name'],
+            'start_line': row['start_line'],
+            'end_line': row['end_line'],
+            'return_type': row['return_type'],
+            'is_declaration': bool(row['is_declaration']),
+            'has_body': bool(row['has_body']),
+        }
+        self._details = row['details']
+
+    def __getitem__(self, key):
+        if key in self._data:
+            return self._data[key]
+        if key in self.DETAIL_KEYS:
+            self._load_details()
+        elif key == 'local_dfg':
+            self._data[key] = self._analysis._load_local_dfg(self._data['name'])
+        elif key == 'side_effects':
+            self._data[key] = self._analysis._load_side_effects(self._data['name'])
+        if key not in self._data:
+            raise KeyError(key)
+        return self._data[key]
+
+    def _load_details(self):
+        details = json.loads(self._details) if self._details else {}
+        for key in ('parameters', 'local_variables', 'calls'):
+            self._data.setdefault(key, details.get(key, []))
+        for key in ('location', 'block_cfg', 'memory_traffic'):
+            self._data.setdefault(key, details.get(key))
+        self._details = None
+
+    def __iter__(self):
+        return iter(self.KEYS)
+
+    def __len__(self):
+        return len(self.KEYS)
+
+    def __repr__(self):
+        return f"<function {self._data['name']!r}>"
+
+
+class _LazyTable(Mapping):
+    """按主键逐行读取的映射，读取过的行缓存在内存中"""
+
+    def __init__(self, analysis, table, key_column, make):
+        self._analysis = analysis
+        self._table = table
+        self._key_column = key_column
+        self._make = make
+        self._cache = {}
+
+    def __getitem__(self, key):
+        value = self._cache.get(key)
+        if value is None:
+            row = self._analysis.store.connection.execute(
+                f'SELECT * FROM {self._table} WHERE {self._key_column} = ?', (key,)).fetchone()
+            if row is None:
+                raise KeyError(key)
+            value = self._cache[key] = self._make(row)
+        return value
+
+    def __contains__(self, key):
+        if key in self._cache:
+            return True
+        return self._analysis.store.connection.execute(
+            f'SELECT 1 FROM {self._table} WHERE {self._key_column} = ?', (key,)).fetchone() is not None
+
+    def __iter__(self):
+        cursor = self._analysis.store.connection.execute(
+            f'SELECT {self._key_column} FROM {self._table} ORDER BY rowid')
+        return (row[0] for row in cursor)
+
+    def __len__(self):
+        return self._analysis.store.connection.execute(f'SELECT COUNT(*) FROM {self._table}').fetchone()[0]
+
+
+class SavedAnalysis:
+    """已保存的分析结果
+
+    用法：
+        with SavedAnalysis('output/analysis.db') as analysis:
+            info = analysis.functions['timer_update']
+            info['side_effects']          # 首次访问时读取
+            list(analysis.cfg.predecessors('find_timer'))
+    """
+
+    def __init__(self, db_path):
+        self.store = AnalysisStore(db_path, read_only=True)
+        self.functions = _LazyTable(self, 'functions', 'name', lambda row: _LazyFunction(self, row))
+        self.variables = _LazyTable(self, 'variables', 'qualified_name', self._make_variable)
+        self._graphs = {}
+        self._call_graph = None
+        self._variable_sets = None
+        self._function_calls = None
+
+    def close(self):
+        self.store.close()
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, exc_type, exc, tb):
+        self.close()
+
+    @property
+    def files(self):
+        return json.loads(self.store.meta('files', '[]'))
+
+    # 全局图
+    @property
+    def cfg(self):
+        return self._global_graph('control_flow')
+
+    @property
+    def global_dfg(self):
+        return self._global_graph('data_flow')
+
+    @property
+    def business_logic(self):
+        return self._global_graph('business_logic')
+
+    @property
+    def call_graph(self):
+        """调用图索引，首次访问时由cfg构建"""
+        if self._call_graph is None:
+            self._call_graph = CallGraphIndex(self.cfg)
+        return self._call_graph
+
+    def _global_graph(self, name):
+        graph = self._graphs.get(name)
+        if graph is None:
+            graph = self._graphs[name] = self._load_graph('graph = ?', (name,))
+        return graph
+
+    def _load_local_dfg(self, function):
+        return self._load_graph("graph = 'local_dfg' AND function = ?", (function,))
+
+    def _load_graph(self, condition, params):
+        connection = self.store.connection
+        graph = CompactDiGraph()
+        for row in connection.execute(f'SELECT node, type FROM graph_nodes WHERE {condition} ORDER BY rowid', params):
+            if row['type'] is None:
+                graph.add_node(row['node'])
+            else:
+                graph.add_node(row['node'], type=row['type'])
+        for row in connection.execute(
+                f'SELECT source, target, type, via_function FROM graph_edges WHERE {condition} ORDER BY rowid',
+                params):
+            attributes = {key: row[key] for key in ('type', 'via_function') if row[key] is not None}
+            graph.add_edge(row['source'], row['target'], **attributes)
+        return graph
+
+    # 函数副作用
+    def _load_side_effects(self, function):
+        side_effects = {'global_vars_read': set(), 'global_vars_write': set(),
+                        'file_operations': [], 'network_operations': [], 'heap_operations': [],
+                        'sync_operations': []}
+        for row in self.store.connection.execute(
+                'SELECT category, operation, subject, file, line, "column" FROM side_effects '
+                'WHERE function = ? ORDER BY rowid', (function,)):
+            category = row['category']
+            if category in SIDE_EFFECT_SETS:
+                side_effects.setdefault(category, set()).add(row['subject'])
+                continue
+            effect = {'operation': row['operation'],
+                      SIDE_EFFECT_SUBJECT_KEYS.get(category, 'subject'): row['subject'],
+                      'location': _format_location(row['file'], row['line'], row['column'])}
+            side_effects.setdefault(category, []).append(effect)
+        return side_effects
+
+    # 变量
+    def _make_variable(self, row):
+        references = []
+        for ref in self.store.connection.execute(
+                'SELECT kind, function, argument_index, assigned_to, file, line, "column" '
+                'FROM variable_references WHERE variable = ? ORDER BY rowid', (row['qualified_name'],)):
+            location = _format_location(ref['file'], ref['line'], ref['column'])
+            if ref['kind'] == 'argument':
+                references.append({'function': ref['function'], 'as_argument': ref['argument_index'],
+                                   'location': location})
+            else:
+                references.append({'assigned_to': ref['assigned_to'], 'location': location,
+                                   'in_function': ref['function']})
+        return {
+            'name': row['name'],
+            'kind': row['kind'],
+            'usr': row['usr'],
+            'type': row['type'],
+            'storage': row['storage'],
+            'location': _format_location(row['file'], row['line'], row['column']),
+            'is_pointer': bool(row['is_pointer']),
+            'references': references,
+            'is_global': bool(row['is_global']),
+            'is_static': bool(row['is_static']),
+            'is_heap': bool(row['is_heap']),
+            'parent_function': row['scope']
+        }
+
+    @property
+    def global_vars(self):
+        return self._load_variable_sets()['global_vars']
+
+    @property
+    def static_vars(self):
+        return self._load_variable_sets()['static_vars']
+
+    @property
+    def heap_vars(self):
+        return self._load_variable_sets()['heap_vars']
+
+    def _load_variable_sets(self):
+        if self._variable_sets is None:
+            query = 'SELECT qualified_name FROM variables WHERE {} = 1'
+            self._variable_sets = {
+                name: {row[0] for row in self.store.connection.execute(query.format(column))}
+                for name, column in (('global_vars', 'is_global'), ('static_vars', 'is_static'),
+                                     ('heap_vars', 'is_heap'))
+            }
+        return self._variable_sets
+
+    @property
+    def function_calls(self):
+        if self._function_calls is None:
+            self._function_calls = [
+                {'function': row['callee'], 'caller': row['caller'],
+                 'location': _format_location(row['file'], row['line'], row['column'])}
+                for row in self.store.connection.execute(
+                    'SELECT caller, callee, file, line, "column" FROM call_sites ORDER BY rowid')
+            ]
+        return self._function_calls
@@ -0,0 +1,264 @@
+"""共享状态与伪共享分析模块
+
+side_effects['global_vars_write']只记录每个函数写入的全局变量，不区分由哪个线程执行。
+本模块把全局变量和结构体字段的读写与线程入口结合起来：
+- 线程入口：pthread_create/thrd_create的线程函数（经指针分析解析），
+  以及analysis_options中thread_entries配置的可并发执行的函数；
+  创建线程的函数所在的顶层调用者（通常是main）作为创建者线程
+- 共享数据：全局/静态变量，以及基址为全局变量或可能指向全局可达对象
+  （全局指针、结构体字段、线程参数所指向的对象）的结构体字段
+- 争用：被至少一个线程写入、且被两个以上线程（或可能多实例运行的线程）访问的数据
+- 伪共享：同一结构体中位于同一缓存行的不同字段，一个线程写入其中一个字段，
+  另一个线程只访问另一个字段（如TimerSystem::next_id与TimerSystem::head）
+
+访问在遍历函数体时由分析器登记，线程到函数的可达性由调用图索引回答。
+"""
+
+from .struct_layout import CACHE_LINE_SIZE
+
+
+THREAD_CREATE_FUNCTIONS = {
+    'pthread_create': (2, 3),  # (线程函数, 线程参数)所在的实参序号
+    'thrd_create': (1, 2),
+}
+
+
+class SharedStateAnalyzer:
+    """多线程共享数据与伪共享风险分析"""
+
+    def __init__(self, cache_line_size=CACHE_LINE_SIZE):
+        self.cache_line_size = cache_line_size
+        self.thread_creations = []  # {'creator', 'line', 'location', 'sources', 'argument_sources'}
+        self.accesses = {}  # 访问位置 -> 访问信息（同一位置既读又写时记为写）
+
+    def add_thread_creation(self, creator, line, location, routine_sources, argument_sources):
+        """登记一次线程创建，线程函数由指针分析求解后解析，线程参数流入线程函数的第一个参数"""
+        self.thread_creations.append({
+            'creator': creator,
+            'line': line,
+            'location': location,
+            'sources': routine_sources,
+            'argument_sources': argument_sources,
+        })
+
+    def add_access(self, target, kind, function, line, location, write, base_sources=None, layout=None):
+        """登记一次全局变量或结构体字段访问
+        Args:
+            target: 全局变量的限定名，或字段的"结构体名.字段名"
+            kind: 'global'或'field'
+            base_sources: 字段访问基址指针的值来源，基址本身是全局变量时为None
+            layout: 字段所属结构体在结构体布局报告中的限定名
+        """
+        access = self.accesses.get(location)
+        if access is not None:
+            access['write'] = access['write'] or write
+            return
+        self.accesses[location] = {
+            'target': target,
+            'kind': kind,
+            'function': function,
+            'line': line,
+            'write': write,
+            'base_sources': base_sources,
+            'layout': layout,
+        }
+
+    def analyze(self, analyzer):
+        """计算共享数据与伪共享报告
+        Returns:
+            {
+                'threads': 线程入口列表,
+                'shared': 被多个线程访问的数据，争用的排在前面,
+                'false_sharing': 同一缓存行上被不同线程写入/访问的字段
+            }
+        """
+        call_graph = analyzer.call_graph
+        points_to = analyzer.points_to
+        threads = self._threads(analyzer)
+        if not threads:
+            return {'threads': [], 'shared': [], 'false_sharing': []}
+
+        # 全局可达对象：全局变量、结构体字段和线程参数可能指向的对象
+        shared_objects = 0
+        for symbol in analyzer.symbols.symbols():
+            if symbol.is_global_or_static:
+                node_id = points_to.find_node(('symbol', symbol.id))
+                if node_id is not None:
+                    shared_objects |= self._object_bits(points_to, [('node', node_id)])
+        for node_id, key in enumerate(points_to.node_keys):
+            if key[0] == 'field':
+                shared_objects |= self._object_bits(points_to, [('node', node_id)])
+        for thread in threads:
+            node_id = points_to.find_node(('param', thread['entry'], 0))
+            if node_id is not None:
+                shared_objects |= self._object_bits(points_to, [('node', node_id)])
+
+        # 各线程可执行的函数
+        thread_functions = {}
+        for thread in threads:
+            entry = thread['entry']
+            functions = set(call_graph.transitive_callees(entry)) | {entry}
+            thread['functions'] = len(functions)
+            thread_functions[entry] = functions
+        multiple = {thread['entry'] for thread in threads if thread['instances'] == 'multiple'}
+
+        targets = {}
+        for access in self.accesses.values():
+            sources = access['base_sources']
+            if sources is not None and not self._object_bits(points_to, sources) & shared_objects:
+                continue
+            accessors = [entry for entry, functions in thread_functions.items() if access['function'] in functions]
+            if not accessors:
+                continue
+            info = targets.setdefault(access['target'], {'target': access['target'], 'kind': access['kind'],
+                                                         'threads': {}})
+            if access['layout'] is not None:
+                info['layout'] = access['layout']
+            site = f"{access['function']}:{access['line']}"
+            for entry in accessors:
+                thread_info = info['threads'].setdefault(entry, {'reads': [], 'writes': []})
+                sites = thread_info['writes' if access['write'] else 'reads']
+                if site not in sites:
+                    sites.append(site)
+
+        shared = []
+        for info in targets.values():
+            writers = sorted(entry for entry, thread_info in info['threads'].items() if thread_info['writes'])
+            accessors = sorted(info['threads'])
+            if len(accessors) < 2 and not (set(accessors) & multiple):
+                continue
+            info['writers'] = writers
+            info['accessors'] = accessors
+            info['contended'] = bool(writers)
+            shared.append(info)
+        shared.sort(key=lambda info: (not info['contended'], -len(info['writers']), -len(info['accessors']),
+                                      info['target']))
+
+        return {
+            'threads': threads,
+            'shared': shared,
+            'false_sharing': self._false_sharing(targets, analyzer.struct_layout_report),
+        }
+
+    def _threads(self, analyzer):
+        """线程入口：线程创建点解析出的线程函数、配置的并发入口和创建者线程"""
+        call_graph = analyzer.call_graph
+        threads = {}
+        for creation in self.thread_creations:
+            block_cfg = analyzer.functions.get(creation['creator'], {}).get('block_cfg')
+            in_loop = block_cfg is not None and block_cfg.loop_depth_at(creation['line']) > 0
+            site = f"{creation['creator']}:{creation['line']}"
+            for routine in self._function_names(analyzer.points_to, creation['sources']):
+                thread = threads.get(routine)
+                if thread is None:
+                    thread = threads[routine] = {'entry': routine, 'origin': 'thread_create',
+                                                 'instances': 'single', 'created_at': []}
+                else:
+                    thread['instances'] = 'multiple'
+                if in_loop:
+                    thread['instances'] = 'multiple'
+                thread['created_at'].append(site)
+
+        for entry in analyzer.options.get('thread_entries', []):
+            if entry not in threads and call_graph.component_of(entry) is not None:
+                # 配置为可并发执行的函数可能同时在多个线程中运行
+                threads[entry] = {'entry': entry, 'origin': 'configured', 'instances': 'multiple',
+                                  'created_at': []}
+
+        # 创建者线程：创建线程的函数不在任何线程中执行时，取能调用到它的顶层函数
+        for creation in self.thread_creations:
+            creator = creation['creator']
+            if any(entry == creator or call_graph.reaches(entry, creator) for entry in threads):
+                continue
+            roots = [name for name in (set(call_graph.transitive_callers(creator)) | {creator})
+                     if analyzer.cfg.in_degree(name) == 0]
+            for root in sorted(roots) or [creator]:
+                threads.setdefault(root, {'entry': root, 'origin': 'creator', 'instances': 'single',
+                                          'created_at': []})
+        return list(threads.values())
+
+    @staticmethod
+    def _object_bits(points_to, sources):
+        bits = 0
+        for source_kind, source_id in sources:
+            object_ids = [source_id] if source_kind == 'object' else points_to.points_to(source_id)
+            for object_id in object_ids:
+                bits |= 1 << object_id
+        return bits
+
+    @staticmethod
+    def _function_names(points_to, sources):
+        names = []
+        for source_kind, source_id in sources:
+            object_ids = [source_id] if source_kind == 'object' else points_to.points_to(source_id)
+            for object_id in object_ids:
+                obj = points_to.objects[object_id]
+                if obj['kind'] == 'function' and obj['function'] not in names:
+                    names.append(obj['function'])
+        return names
+
+    def _false_sharing(self, targets, layouts):
+        """同一缓存行上由不同线程写入和访问的不同字段"""
+        line_size = self.cache_line_size
+        by_record = {}
+        for target, info in targets.items():
+            if info['kind'] == 'field' and info.get('layout') is not None:
+                field = target.rpartition('.')[2]
+                by_record.setdefault(info['layout'], {})[field] = info['threads']
+
+        report = []
+        for key, fields in by_record.items():
+            layout = layouts.get(key)
+            if layout is None or layout['kind'] != 'struct':
+                continue
+            lines = {}
+            for field in layout['fields']:
+                if field['name'] in fields and field['size']:
+                    for line in range(field['offset'] // line_size,
+                                      (field['offset'] + field['size'] - 1) // line_size + 1):
+                        lines.setdefault(line, []).append(field['name'])
+            for line, names in sorted(lines.items()):
+                pairs = []
+                for written in names:
+                    for writer, writer_info in fields[written].items():
+                        if not writer_info['writes']:
+                            continue
+                        for other in names:
+                            if other == written:
+                                continue
+                            for thread in fields[other]:
+                                # 另一线程只访问同一缓存行上的其他字段，缓存行争用完全来自布局
+                                if thread != writer and thread not in fields[written]:
+                                    pairs.append({'field': written, 'writer': writer,
+                                                  'other_field': other, 'other_thread': thread})
+                if not pairs:
+                    continue
+                written_fields = sorted({pair['field'] for pair in pairs})
+                report.append({
+                    'record': layout['name'],
+                    'layout': key,
+                    'cache_line': line,
+                    'fields': names,
+                    'pairs': pairs,
+                    'isolate': written_fields,
+                    'suggestion': f"move {', '.join(written_fields)} away from fields used by other threads "
+                                  f"(separate {line_size}-byte cache line via alignas({line_size}) or padding)",
+                })
+        report.sort(key=lambda item: (-len(item['pairs']), item['record'], item['layout'], item['cache_line']))
+        return report
+
+    @staticmethod
+    def summary(report, limit=10):
+        """争用数据和伪共享风险的文字摘要"""
+        lines = []
+        for info in report['shared'][:limit]:
+            if not info['contended']:
+                break
+            lines.append(f"{info['kind']} {info['target']}: written by {', '.join(info['writers'])}, "
+                         f"accessed by {', '.join(info['accessors'])}")
+        for item in report['false_sharing'][:limit]:
+            pair = item['pairs'][0]
+            lines.append(f"false sharing in {item['record']} cache line {item['cache_line']}: "
+                         f"{pair['field']} written by {pair['writer']}, {pair['other_field']} used by "
+                         f"{pair['other_thread']}; {item['suggestion']}")
+        return lines
@@ -0,0 +1,34 @@
+"""源码位置字符串解析模块
+
+分析结果中的位置统一记录为"文件:行:列"字符串。文件名本身可能含冒号
+（Windows盘符C:\\src\\a.c），因此只从右侧拆出行号和列号，各模块共用本模块的解析函数。
+"""
+
+
+def split_location(location):
+    """把"文件:行:列"（或"文件:行"）拆分为(文件, 行, 列)
+
+    缺少的部分为None；行号无法解析时整个字符串作为文件名。
+    """
+    if not location:
+        return None, None, None
+    location = str(location)
+    head, separator, tail = location.rpartition(':')
+    if not separator or not tail.isdigit():
+        return location, None, None
+    file_name, separator, line = head.rpartition(':')
+    if separator and line.isdigit():
+        return file_name, int(line), int(tail)
+    # 只有行号
+    return head, int(tail), None
+
+
+def location_line(location):
+    """位置中的行号，无法解析时为0"""
+    return split_location(location)[1] or 0
+
+
+def location_position(location):
+    """位置中的(行号, 列号)，无法解析的部分为0"""
+    _, line, column = split_location(location)
+    return line or 0, column or 0
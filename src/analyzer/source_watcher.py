@@ -0,0 +1,170 @@
+"""源文件监视模块
+
+监视源码目录中C源文件和头文件的变更，供监视模式（--watch）使用。
+Linux下通过ctypes直接调用inotify，其他平台退化为按修改时间轮询。
+"""
+
+import ctypes
+import ctypes.util
+import os
+import select
+import struct
+import sys
+import time
+
+
+class SourceWatcher:
+    """监视若干根目录下指定扩展名的文件变更"""
+
+    # inotify事件掩码（见<sys/inotify.h>）
+    IN_MODIFY = 0x00000002
+    IN_CLOSE_WRITE = 0x00000008
+    IN_MOVED_FROM = 0x00000040
+    IN_MOVED_TO = 0x00000080
+    IN_CREATE = 0x00000100
+    IN_DELETE = 0x00000200
+    IN_ISDIR = 0x40000000
+    IN_NONBLOCK = 0o4000
+    IN_CLOEXEC = 0o2000000
+
+    WATCH_MASK = IN_MODIFY | IN_CLOSE_WRITE | IN_MOVED_FROM | IN_MOVED_TO | IN_CREATE | IN_DELETE
+
+    EVENT_HEADER = struct.Struct('iIII')
+
+    def __init__(self, roots, extensions=('.c', '.h'), debounce=0.05, poll_interval=0.5):
+        """初始化监视器
+        Args:
+            roots: 需要监视的目录列表（递归监视子目录）
+            extensions: 关注的文件扩展名
+            debounce: 收到第一个事件后继续收集事件的静默时间（秒），用于合并编辑器的多次写入
+            poll_interval: 轮询模式下的扫描间隔（秒）
+        """
+        self.roots = sorted({os.path.abspath(root) for root in roots if os.path.isdir(root)})
+        self.extensions = tuple(extensions)
+        self.debounce = debounce
+        self.poll_interval = poll_interval
+
+        self._fd = None
+        self._watch_dirs = {}  # inotify watch descriptor -> 目录
+        self._mtimes = {}
+
+        if sys.platform.startswith('linux'):
+            try:
+                self._init_inotify()
+            except OSError as e:
+                print(f"Warning: inotify unavailable ({e}), falling back to polling")
+                self._fd = None
+
+        if self._fd is None:
+            self._mtimes = self._scan()
+
+    @property
+    def backend(self):
+        return 'inotify' if self._fd is not None else 'polling'
+
+    def _init_inotify(self):
+        libc = ctypes.CDLL(ctypes.util.find_library('c') or 'libc.so.6', use_errno=True)
+        self._libc = libc
+        fd = libc.inotify_init1(self.IN_NONBLOCK | self.IN_CLOEXEC)
+        if fd < 0:
+            errno = ctypes.get_errno()
+            raise OSError(errno, os.strerror(errno))
+        self._fd = fd
+        for root in self.roots:
+            for directory, _, _ in os.walk(root):
+                self._add_watch(directory)
+
+    def _add_watch(self, directory):
+        wd = self._libc.inotify_add_watch(self._fd, os.fsencode(directory), self.WATCH_MASK)
+        if wd < 0:
+            errno = ctypes.get_errno()
+            print(f"Warning: cannot watch {directory}: {os.strerror(errno)}")
+            return
+        self._watch_dirs[wd] = directory
+
+    def wait(self, timeout=None):
+        """阻塞直到有关注的文件发生变更
+        Args:
+            timeout: 最长等待时间（秒），None表示一直等待
+        Returns:
+            变更文件的绝对路径集合，超时返回空集合
+        """
+        if self._fd is not None:
+            return self._wait_inotify(timeout)
+        return self._wait_polling(timeout)
+
+    def _wait_inotify(self, timeout):
+        changed = set()
+        readable, _, _ = select.select([self._fd], [], [], timeout)
+        if not readable:
+            return changed
+        self._read_events(changed)
+        # 合并短时间内的连续事件（编辑器保存时常见的写临时文件+重命名）
+        while True:
+            readable, _, _ = select.select([self._fd], [], [], self.debounce)
+            if not readable:
+                break
+            self._read_events(changed)
+        return changed
+
+    def _read_events(self, changed):
+        try:
+            data = os.read(self._fd, 64 * 1024)
+        except BlockingIOError:
+            return
+        offset = 0
+        header_size = self.EVENT_HEADER.size
+        while offset + header_size <= len(data):
+            wd, mask, _, name_len = self.EVENT_HEADER.unpack_from(data, offset)
+            offset += header_size
+            name = data[offset:offset + name_len].rstrip(b'\0')
+            offset += name_len
+
+            directory = self._watch_dirs.get(wd)
+            if directory is None or not name:
+                continue
+            path = os.path.join(directory, os.fsdecode(name))
+            if mask & self.IN_ISDIR:
+                # 新建的子目录也需要监视
+                if mask & (self.IN_CREATE | self.IN_MOVED_TO):
+                    self._add_watch(path)
+                continue
+            if path.endswith(self.extensions):
+                changed.add(path)
+
+    def _scan(self):
+        mtimes = {}
+        for root in self.roots:
+            for directory, _, file_names in os.walk(root):
+                for file_name in file_names:
+                    if file_name.endswith(self.extensions):
+                        path = os.path.join(directory, file_name)
+                        try:
+                            mtimes[path] = os.stat(path).st_mtime_ns
+                        except OSError:
+                            continue
+        return mtimes
+
+    def _wait_polling(self, timeout):
+        deadline = None if timeout is None else time.monotonic() + timeout
+        while True:
+            current = self._scan()
+            changed = {path for path, mtime in current.items() if self._mtimes.get(path) != mtime}
+            changed.update(path for path in self._mtimes if path not in current)
+            self._mtimes = current
+            if changed:
+                return changed
+            if deadline is not None and time.monotonic() >= deadline:
+                return set()
+            time.sleep(self.poll_interval)
+
+    def close(self):
+        if self._fd is not None:
+            os.close(self._fd)
+            self._fd = None
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, exc_type, exc_value, traceback):
+        self.close()
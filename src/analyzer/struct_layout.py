@@ -0,0 +1,276 @@
+"""结构体布局分析模块
+
+按clang给出的字段偏移计算每个结构体/联合体的内存布局：
+- 大小、对齐、每个字段的偏移和大小
+- 字段之间的填充空洞和尾部填充
+- 占用的缓存行数，以及跨越缓存行边界的字段（按对象起始地址与缓存行对齐计算）
+
+并给出两类建议：
+- 重排：按对齐要求从大到小重排字段，若能减小结构体大小则给出新顺序和节省的字节数
+- 冷热分离：循环中访问的字段为热字段，只在循环外访问的为冷字段，
+  热字段集中放在前部，结构体超过一个缓存行时建议把冷字段拆分到单独的结构体
+
+字段访问在遍历函数体时由分析器登记，访问所在的循环深度由函数的基本块控制流图确定，
+每层循环的访问权重放大LOOP_WEIGHT倍。
+"""
+
+import os
+
+import clang.cindex
+
+
+CACHE_LINE_SIZE = 64
+LOOP_WEIGHT = 10
+
+
+def _align_up(value, alignment):
+    return (value + alignment - 1) // alignment * alignment if alignment > 0 else value
+
+
+def _packed_size(fields, record_align):
+    """按给定顺序依次放置字段后的结构体大小"""
+    offset = 0
+    for field in fields:
+        offset = _align_up(offset, field['align']) + field['size']
+    return _align_up(offset, record_align)
+
+
+class StructLayoutAnalyzer:
+    """结构体布局与字段访问统计"""
+
+    def __init__(self, cache_line_size=CACHE_LINE_SIZE):
+        self.cache_line_size = cache_line_size
+        self.records = {}  # 限定名 -> 布局信息
+        self._accesses = {}  # 限定名 -> {字段名: [(函数, 行号)]}
+
+    @staticmethod
+    def record_key(cursor):
+        """结构体的限定名：定义所在文件::结构体名
+
+        C结构体的USR不含文件，不同源文件中的同名结构体USR相同，因此以定义所在文件区分；
+        同一头文件被多个翻译单元包含时限定名相同，只登记一次。
+        """
+        location = cursor.location
+        # 经不同include路径（src/../include/x.h与include/x.h）到达的同一头文件规范化为同一路径
+        file_name = os.path.normpath(location.file.name) if location.file is not None else ''
+        return f"{file_name}::{cursor.spelling or cursor.type.spelling}"
+
+    def add_record(self, cursor):
+        """登记结构体或联合体定义（同一定义在多个翻译单元中出现时只登记一次）"""
+        key = self.record_key(cursor)
+        if key in self.records:
+            return
+        size = cursor.type.get_size()
+        align = cursor.type.get_align()
+        if size < 0 or align < 0:
+            # 不完整类型或无效声明，clang无法给出布局
+            return
+
+        fields = []
+        for child in cursor.get_children():
+            if child.kind != clang.cindex.CursorKind.FIELD_DECL:
+                continue
+            field_size = child.type.get_size()
+            offset_bits = child.get_field_offsetof()
+            if offset_bits < 0:
+                return
+            field = {
+                'name': child.spelling,
+                'type': child.type.spelling,
+                'offset': offset_bits // 8,
+                'size': max(field_size, 0),  # 柔性数组成员大小为0
+                'align': max(child.type.get_align(), 1),
+            }
+            if child.is_bitfield():
+                field['bit_offset'] = offset_bits
+                field['bit_width'] = child.get_bitfield_width()
+            fields.append(field)
+
+        self.records[key] = {
+            'name': cursor.spelling or cursor.type.spelling,
+            'qualified_name': key,
+            'kind': 'union' if cursor.kind == clang.cindex.CursorKind.UNION_DECL else 'struct',
+            'location': f"{cursor.location.file}:{cursor.location.line}:{cursor.location.column}",
+            'size': size,
+            'align': align,
+            'fields': fields,
+        }
+
+    def add_access(self, member_expr, function):
+        """登记函数中的一次字段访问（a.f或p->f）"""
+        field = member_expr.referenced
+        if field is None or field.kind != clang.cindex.CursorKind.FIELD_DECL:
+            return
+        record = field.semantic_parent
+        if record is None:
+            return
+        self._accesses.setdefault(self.record_key(record), {}).setdefault(field.spelling, []).append(
+            (function, member_expr.location.line))
+
+    def analyze(self, functions):
+        """计算全部结构体的布局报告
+        Args:
+            functions: 分析器的函数信息字典，用其中的block_cfg确定访问所在的循环深度
+        Returns:
+            {限定名（文件::结构体名）: 布局报告}，按结构体登记顺序；结构体名在布局报告的name中
+        """
+        report = {}
+        for key, record in self.records.items():
+            layout = dict(record)
+            if record['kind'] == 'struct':
+                layout.update(self._padding(record))
+            layout.update(self._cache_lines(record))
+            layout.update(self._hotness(record, self._accesses.get(key, {}), functions))
+            if record['kind'] == 'struct':
+                layout['suggestions'] = self._suggestions(record, layout)
+            else:
+                layout['suggestions'] = []
+            # 重排后可达到的最小大小（无重排建议时即当前大小）
+            layout['min_size'] = min((suggestion['size'] for suggestion in layout['suggestions']
+                                      if suggestion['kind'] == 'reorder'), default=record['size'])
+            report[key] = layout
+        return report
+
+    # 布局
+    @staticmethod
+    def _padding(record):
+        """字段间的空洞和尾部填充（位域按所占字节计算）"""
+        holes = []
+        end = 0
+        previous = None
+        for field in sorted(record['fields'], key=lambda f: f.get('bit_offset', f['offset'] * 8)):
+            if 'bit_width' in field:
+                start = field['bit_offset'] // 8
+                field_end = (field['bit_offset'] + field['bit_width'] + 7) // 8
+            else:
+                start = field['offset']
+                field_end = field['offset'] + field['size']
+            if start > end:
+                holes.append({'after': previous, 'before': field['name'], 'offset': end, 'size': start - end})
+            end = max(end, field_end)
+            previous = field['name']
+        tail = record['size'] - end if record['fields'] else 0
+        return {
+            'holes': holes,
+            'tail_padding': max(tail, 0),
+            'padding': sum(hole['size'] for hole in holes) + max(tail, 0),
+        }
+
+    def _cache_lines(self, record):
+        line = self.cache_line_size
+        straddling = [
+            field['name'] for field in record['fields']
+            if field['size'] and field['offset'] // line != (field['offset'] + field['size'] - 1) // line
+        ]
+        return {
+            'cache_lines': (record['size'] + line - 1) // line if record['size'] else 0,
+            'straddling_fields': straddling,
+        }
+
+    # 冷热字段
+    @staticmethod
+    def _hotness(record, accesses, functions):
+        weights = {}
+        loop_accesses = {}
+        functions_by_field = {}
+        for name, sites in accesses.items():
+            weight = 0
+            in_loop = 0
+            for function, line in sites:
+                block_cfg = functions.get(function, {}).get('block_cfg')
+                depth = block_cfg.loop_depth_at(line) if block_cfg is not None else 0
+                weight += LOOP_WEIGHT ** depth
+                if depth:
+                    in_loop += 1
+            weights[name] = weight
+            loop_accesses[name] = in_loop
+            functions_by_field[name] = sorted({function for function, _ in sites})
+
+        field_names = [field['name'] for field in record['fields']]
+        return {
+            'field_access': {
+                name: {
+                    'accesses': len(accesses.get(name, ())),
+                    'loop_accesses': loop_accesses.get(name, 0),
+                    'weight': weights.get(name, 0),
+                    'functions': functions_by_field.get(name, []),
+                }
+                for name in field_names
+            },
+            'hot_fields': [name for name in field_names if loop_accesses.get(name)],
+            'cold_fields': [name for name in field_names if accesses.get(name) and not loop_accesses.get(name)],
+            'unused_fields': [name for name in field_names if not accesses.get(name)],
+        }
+
+    # 建议
+    def _suggestions(self, record, layout):
+        fields = record['fields']
+        if not fields or any('bit_width' in field for field in fields):
+            # 位域的存储单元由编译器分配，不给出重排建议
+            return []
+        suggestions = []
+
+        # 重排：对齐从大到小，稳定排序保持同对齐字段的原有顺序（柔性数组成员保持在末尾）
+        movable = [field for field in fields if field['size'] or field is not fields[-1]]
+        tail = fields[len(movable):]
+        reordered = sorted(movable, key=lambda field: -field['align']) + tail
+        reordered_size = _packed_size(reordered, record['align'])
+        if reordered_size < record['size']:
+            suggestions.append({
+                'kind': 'reorder',
+                'order': [field['name'] for field in reordered],
+                'size': reordered_size,
+                'saves': record['size'] - reordered_size,
+            })
+
+        # 冷热分离：热字段按访问权重从高到低集中在前部
+        hot = set(layout['hot_fields'])
+        if hot and len(hot) < len(fields):
+            weights = {name: info['weight'] for name, info in layout['field_access'].items()}
+            hot_fields = sorted((field for field in movable if field['name'] in hot),
+                                key=lambda field: (-field['align'], -weights[field['name']]))
+            cold_fields = sorted((field for field in movable if field['name'] not in hot),
+                                 key=lambda field: -field['align'])
+            hot_size = _packed_size(hot_fields, max(field['align'] for field in hot_fields))
+            line = self.cache_line_size
+            hot_lines_now = {
+                line_index
+                for field in fields if field['name'] in hot and field['size']
+                for line_index in range(field['offset'] // line, (field['offset'] + field['size'] - 1) // line + 1)
+            }
+            hot_lines_min = (hot_size + line - 1) // line
+            if record['size'] > line or len(hot_lines_now) > hot_lines_min:
+                suggestion = {
+                    'kind': 'hot_cold_split' if record['size'] > line else 'hot_first',
+                    'hot_fields': [field['name'] for field in hot_fields],
+                    'cold_fields': [field['name'] for field in cold_fields] + [field['name'] for field in tail],
+                    'hot_size': hot_size,
+                    'hot_cache_lines': hot_lines_min,
+                    'current_hot_cache_lines': len(hot_lines_now),
+                }
+                if suggestion['kind'] == 'hot_first':
+                    suggestion['order'] = suggestion['hot_fields'] + suggestion['cold_fields']
+                suggestions.append(suggestion)
+        return suggestions
+
+    @staticmethod
+    def summary(report):
+        """布局报告的文字摘要：每个结构体一行，存在填充或建议时附加说明"""
+        lines = []
+        for layout in report.values():
+            line = f"{layout['kind']} {layout['name']}: {layout['size']} bytes, align {layout['align']}, " \
+                   f"{layout['cache_lines']} cache line(s)"
+            if layout.get('padding'):
+                parts = [f"{hole['size']}B after {hole['after']}" for hole in layout['holes']]
+                if layout['tail_padding']:
+                    parts.append(f"{layout['tail_padding']}B tail")
+                line += f", padding {layout['padding']}B ({', '.join(parts)})"
+            for suggestion in layout['suggestions']:
+                if suggestion['kind'] == 'reorder':
+                    line += f"; reorder to save {suggestion['saves']}B: {', '.join(suggestion['order'])}"
+                elif suggestion['kind'] == 'hot_cold_split':
+                    line += f"; split cold fields {', '.join(suggestion['cold_fields'])}"
+                else:
+                    line += f"; move hot fields first: {', '.join(suggestion['hot_fields'])}"
+            lines.append(line)
+        return lines
@@ -0,0 +1,282 @@
+"""符号表模块
+
+以clang USR为键记录变量符号（全局变量、静态变量、函数参数和局部变量），
+取代按变量名索引的扁平字典。不同函数中的同名局部变量（如current、prev）
+各自对应独立的符号，引用记录也分别挂在各自的符号上。
+
+没有USR的游标退化为 文件+作用域+名称 作为键。
+符号记录使用__slots__，名称、类型和文件路径等字符串经过驻留（intern）共享。
+"""
+
+import os
+import sys
+from collections import namedtuple
+from collections.abc import Mapping
+
+import clang.cindex
+
+
+# 变量引用记录
+#   kind: 'argument'（作为函数调用参数）或'assignment'（赋值给其他变量）
+#   function: 'argument'时为被调用函数，'assignment'时为赋值所在函数
+#   target: 'argument'时为参数序号，'assignment'时为被赋值变量的限定名
+Reference = namedtuple('Reference', ('kind', 'function', 'target', 'file', 'line', 'column'))
+
+
+def _format_location(file_name, line, column):
+    return f"{file_name}:{line}:{column}"
+
+
+class Symbol:
+    """变量符号
+
+    支持字典式访问（symbol['type']、symbol.get('is_pointer')），
+    兼容原先以字典保存变量信息的调用方。
+    """
+
+    __slots__ = ('id', 'usr', 'name', 'qualified_name', 'kind', 'scope', 'type', 'storage',
+                 'file', 'line', 'column', 'is_pointer', 'is_global', 'is_static', 'is_heap',
+                 'references')
+
+    # 字典式访问时的别名
+    ALIASES = {'parent_function': 'scope'}
+
+    def __init__(self, symbol_id, usr, name, qualified_name, kind, scope, type_spelling,
+                 storage, file_name, line, column, is_global, is_static):
+        self.id = symbol_id
+        self.usr = usr
+        self.name = name
+        self.qualified_name = qualified_name
+        self.kind = kind
+        self.scope = scope
+        self.type = type_spelling
+        self.storage = storage
+        self.file = file_name
+        self.line = line
+        self.column = column
+        self.is_pointer = '*' in type_spelling
+        self.is_global = is_global
+        self.is_static = is_static
+        self.is_heap = False
+        self.references = []
+
+    @property
+    def location(self):
+        return _format_location(self.file, self.line, self.column)
+
+    @property
+    def is_global_or_static(self):
+        """是否具有静态存储期（全局变量或静态变量），读写即构成函数副作用"""
+        return self.is_global or self.is_static
+
+    def add_reference(self, kind, function, target, cursor):
+        location = cursor.location
+        file_name = sys.intern(location.file.name) if location.file else None
+        self.references.append(Reference(kind, function, target, file_name, location.line, location.column))
+
+    def iter_reference_dicts(self):
+        """按原有的字典格式输出引用记录"""
+        for ref in self.references:
+            location = _format_location(ref.file, ref.line, ref.column)
+            if ref.kind == 'argument':
+                yield {'function': ref.function, 'as_argument': ref.target, 'location': location}
+            else:
+                yield {'assigned_to': ref.target, 'location': location, 'in_function': ref.function}
+
+    def to_dict(self):
+        """导出为可JSON序列化的字典"""
+        return {
+            'name': self.name,
+            'kind': self.kind,
+            'usr': self.usr,
+            'type': self.type,
+            'storage': self.storage,
+            'location': self.location,
+            'is_pointer': self.is_pointer,
+            'references': list(self.iter_reference_dicts()),
+            'is_global': self.is_global,
+            'is_static': self.is_static,
+            'is_heap': self.is_heap and self.is_pointer,
+            'parent_function': self.scope
+        }
+
+    def __getitem__(self, key):
+        try:
+            return getattr(self, self.ALIASES.get(key, key))
+        except AttributeError:
+            raise KeyError(key) from None
+
+    def __setitem__(self, key, value):
+        setattr(self, self.ALIASES.get(key, key), value)
+
+    def __contains__(self, key):
+        return hasattr(self, self.ALIASES.get(key, key))
+
+    def get(self, key, default=None):
+        return getattr(self, self.ALIASES.get(key, key), default)
+
+    def __repr__(self):
+        return f"Symbol({self.qualified_name!r}, kind={self.kind!r}, type={self.type!r})"
+
+
+class SymbolTable(Mapping):
+    """变量符号表
+
+    作为映射时以限定名为键（文件作用域变量为变量名本身，函数作用域变量为
+    "函数名::变量名"），可直接替代原先的self.variables字典。
+    分析过程中应通过lookup/resolve按游标定位符号，均为O(1)的字典查找。
+    """
+
+    # 包裹在变量引用外层、不改变其指向的表达式节点
+    TRANSPARENT_EXPRS = (
+        clang.cindex.CursorKind.UNEXPOSED_EXPR,
+        clang.cindex.CursorKind.PAREN_EXPR,
+        clang.cindex.CursorKind.CSTYLE_CAST_EXPR,
+    )
+
+    VARIABLE_DECLS = (clang.cindex.CursorKind.VAR_DECL, clang.cindex.CursorKind.PARM_DECL)
+
+    def __init__(self):
+        self._symbols = []  # 符号id -> Symbol
+        self._by_key = {}  # USR（或回退键） -> 符号id
+        self._by_qualified_name = {}  # 限定名 -> 符号id
+
+    def declare(self, cursor, scope=None):
+        """登记变量声明（VAR_DECL/PARM_DECL），返回对应的符号
+
+        同一变量的多次声明（如头文件中的extern声明和源文件中的定义、
+        多个翻译单元包含的同一头文件）对应同一个符号，定义的位置优先。
+        Args:
+            cursor: 变量声明游标
+            scope: 所在函数名，文件作用域变量为None
+        """
+        key = self.key_for(cursor)
+        symbol_id = self._by_key.get(key)
+        if symbol_id is not None:
+            symbol = self._symbols[symbol_id]
+            if cursor.is_definition() and cursor.location.file:
+                self._set_location(symbol, cursor)
+            return symbol
+
+        intern = sys.intern
+        name = intern(cursor.spelling)
+        storage = cursor.storage_class
+        is_global = cursor.semantic_parent is not None and \
+            cursor.semantic_parent.kind == clang.cindex.CursorKind.TRANSLATION_UNIT
+        is_static = storage == clang.cindex.StorageClass.STATIC
+
+        if cursor.kind == clang.cindex.CursorKind.PARM_DECL:
+            kind = 'parameter'
+            storage_name = 'StorageClass.NONE'
+        else:
+            kind = 'static' if is_static else ('global' if is_global else 'local')
+            storage_name = str(storage)
+        if is_global:
+            scope = None
+        elif cursor.semantic_parent is not None and cursor.semantic_parent.spelling:
+            scope = cursor.semantic_parent.spelling
+
+        symbol = Symbol(len(self._symbols), intern(cursor.get_usr() or key), name, None, kind,
+                        intern(scope) if scope else None, intern(cursor.type.spelling),
+                        intern(storage_name), None, 0, 0, is_global, is_static)
+        self._set_location(symbol, cursor)
+        symbol.qualified_name = intern(self._make_qualified_name(symbol))
+
+        self._symbols.append(symbol)
+        self._by_key[key] = symbol.id
+        self._by_qualified_name[symbol.qualified_name] = symbol.id
+        return symbol
+
+    def lookup(self, cursor):
+        """按声明游标查找符号，未登记时返回None"""
+        symbol_id = self._by_key.get(self.key_for(cursor))
+        return self._symbols[symbol_id] if symbol_id is not None else None
+
+    def resolve(self, expr):
+        """解析表达式引用的变量符号
+
+        跳过隐式转换、括号和强制类型转换，对DECL_REF_EXPR通过其指向的声明查找符号。
+        表达式不是变量引用或变量未登记时返回None。
+        """
+        expr = self.strip(expr)
+        if expr is None or expr.kind != clang.cindex.CursorKind.DECL_REF_EXPR:
+            return None
+        declaration = expr.referenced
+        if declaration is None or declaration.kind not in self.VARIABLE_DECLS:
+            return None
+        return self.lookup(declaration)
+
+    @classmethod
+    def strip(cls, expr):
+        """去掉包裹在表达式外层的隐式转换、括号和强制类型转换"""
+        while expr is not None and expr.kind in cls.TRANSPARENT_EXPRS:
+            inner = None
+            for child in expr.get_children():
+                # 强制类型转换的第一个子节点可能是类型引用
+                if child.kind == clang.cindex.CursorKind.TYPE_REF:
+                    continue
+                inner = child
+                break
+            expr = inner
+        return expr
+
+    def symbol(self, symbol_id):
+        """按符号id获取符号"""
+        return self._symbols[symbol_id]
+
+    def symbols(self):
+        """按登记顺序返回全部符号"""
+        return list(self._symbols)
+
+    @staticmethod
+    def key_for(cursor):
+        """符号键：优先使用USR，没有USR时使用 文件+作用域+名称"""
+        usr = cursor.get_usr()
+        if usr:
+            return usr
+        location = cursor.location
+        file_name = location.file.name if location.file else ''
+        scope = None
+        parent = cursor.semantic_parent
+        if parent is not None and parent.kind != clang.cindex.CursorKind.TRANSLATION_UNIT:
+            scope = parent.spelling
+        # 块作用域中的同名变量以行号区分
+        return f"{file_name}|{scope or ''}|{cursor.spelling}|{location.line if scope else ''}"
+
+    @staticmethod
+    def _set_location(symbol, cursor):
+        location = cursor.location
+        symbol.file = sys.intern(location.file.name) if location.file else None
+        symbol.line = location.line
+        symbol.column = location.column
+
+    def _make_qualified_name(self, symbol):
+        """生成唯一的限定名，重名时依次追加文件名、行号区分"""
+        if symbol.scope:
+            name = f"{symbol.scope}::{symbol.name}"
+        else:
+            name = symbol.name
+        if name not in self._by_qualified_name:
+            return name
+        if symbol.scope:
+            # 同一函数内不同块作用域中的同名变量
+            name = f"{name}@{symbol.line}"
+        else:
+            # 不同文件中的同名静态变量
+            name = f"{name}@{os.path.basename(symbol.file or '')}"
+        if name not in self._by_qualified_name:
+            return name
+        return f"{name}#{symbol.id}"
+
+    # Mapping接口：以限定名为键
+    def __getitem__(self, qualified_name):
+        return self._symbols[self._by_qualified_name[qualified_name]]
+
+    def __contains__(self, qualified_name):
+        return qualified_name in self._by_qualified_name
+
+    def __iter__(self):
+        return iter(self._by_qualified_name)
+
+    def __len__(self):
+        return len(self._symbols)
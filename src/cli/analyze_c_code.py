@@ -2,15 +2,73 @@
 import os
 import sys
 import json
+import time
 import argparse
 sys.path.append(os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
 from analyzer.c_code_analyzer import CCodeAnalyzer
+from analyzer.source_watcher import SourceWatcher
+from analyzer.struct_layout import StructLayoutAnalyzer
+from analyzer.allocation_analysis import AllocationAnalyzer
+from analyzer.list_traversal import LinkedListTraversalDetector
+from analyzer.cost_model import CostModel
+from analyzer.shared_state import SharedStateAnalyzer
+from analyzer.lock_analysis import LockAnalyzer
+from analyzer.blocking_calls import BlockingCallDetector
+from analyzer.memory_traffic import MemoryTrafficAnalyzer
+from analyzer.escape_analysis import EscapeAnalyzer
+from analyzer.memory_lifetime import MemoryLifetimeAnalyzer
 
 def main():
     parser = argparse.ArgumentParser(description='Analyze C code for data flow and business logic')
     parser.add_argument('path', help='Path to the C source file, directory containing C files, or JSON configuration file')
     parser.add_argument('--output-dir', '-o', default='output', help='Directory to save output files')
     parser.add_argument('--json', '-j', action='store_true', help='Export analysis results to JSON')
+    parser.add_argument('--stream', choices=['jsonl', 'json'],
+                        help='Stream analysis results to analysis_result.<format> in constant memory '
+                             '(jsonl: one record per line; json: same layout as --json, compact)')
+    parser.add_argument('--compress', choices=['gzip', 'zstd'],
+                        help='Compress the streamed export (zstd requires the zstandard package)')
+    parser.add_argument('--columnar', action='store_true',
+                        help='Export analysis results as memory-mappable numpy column files '
+                             'to analysis_result.columns/')
+    parser.add_argument('--store', metavar='DB',
+                        help='Write analysis results into an indexed SQLite store, rewriting only files '
+                             'whose results changed (query it with query_store.py)')
+    parser.add_argument('--store-full', action='store_true', help='Rewrite the whole SQLite store')
+    parser.add_argument('--dump-ast', nargs='?', const='text', choices=['text', 'jsonl'],
+                        help='Write an AST debug dump per translation unit (default format: text)')
+    parser.add_argument('--ast-all-files', action='store_true',
+                        help='Include nodes from included headers in the AST dump (default: main file only)')
+    parser.add_argument('--ast-max-depth', type=int, help='Maximum depth of the AST dump')
+    parser.add_argument('--ast-kinds', help='Comma-separated cursor kinds to write, e.g. FUNCTION_DECL,CALL_EXPR')
+    parser.add_argument('--ast-max-nodes', type=int, help='Stop the AST dump after this many nodes')
+    parser.add_argument('--ast-compress', action='store_true', help='Gzip-compress the AST dump')
+    parser.add_argument('--header-filter', choices=['all', 'project', 'called'],
+                        help='Which top-level declarations to analyze: all, project files only (default), '
+                             'or project files plus called external functions')
+    parser.add_argument('--pch', action='append', metavar='HEADER',
+                        help='Common header to precompile and reuse across translation units (repeatable, '
+                             'accepts <system.h> form)')
+    parser.add_argument('--compile-commands', metavar='PATH',
+                        help='compile_commands.json (or its directory) providing per-file compile arguments')
+    parser.add_argument('--project-root', action='append', metavar='DIR',
+                        help='Directory whose headers count as project code (repeatable, replaces the default '
+                             'roots: source directories, include paths and in-tree compile database -I dirs)')
+    parser.add_argument('--entry-point', action='append', metavar='FUNCTION',
+                        help='Hot entry function for performance reports (repeatable, adds to entry_points '
+                             'from the configuration)')
+    parser.add_argument('--thread-entry', action='append', metavar='FUNCTION',
+                        help='Function that may run concurrently in several threads (repeatable, adds to '
+                             'thread_entries from the configuration)')
+    parser.add_argument('--latency-critical', action='append', metavar='NAME',
+                        help='Latency-critical function or callback type whose reachable blocking calls are '
+                             'reported (repeatable, adds to latency_critical from the configuration)')
+    parser.add_argument('--allocator', action='append', metavar='FUNCTION',
+                        help='Custom allocation function treated like malloc, e.g. a pool allocator (repeatable, '
+                             'adds to allocators from the configuration)')
+    parser.add_argument('--watch', '-w', action='store_true',
+                        help='Keep running, re-analyze changed translation units and re-emit outputs (without the '
+                             'PNG graphs) on every save')
     args = parser.parse_args()
     
     # 检查路径是否存在
@@ -34,6 +92,7 @@ def main():
         # 检查是否是配置文件
         source_files = []
         include_paths = []
+        options = {}
         base_dir = os.path.dirname(args.path)
         
         if args.path.endswith('.json'):
@@ -46,12 +105,26 @@ def main():
                     source_files = [os.path.join(base_dir, src) for src in config['source_files']]
                 if 'include_paths' in config:
                     include_paths = [os.path.join(base_dir, inc) for inc in config['include_paths']]
+                if 'precompiled_headers' in config:
+                    options['precompiled_headers'] = [
+                        header if header.startswith('<') else os.path.join(base_dir, header)
+                        for header in config['precompiled_headers']
+                    ]
+                if 'compile_commands' in config:
+                    options['compile_commands'] = os.path.join(base_dir, config['compile_commands'])
+                if 'entry_points' in config:
+                    options['entry_points'] = list(config['entry_points'])
+                if 'thread_entries' in config:
+                    options['thread_entries'] = list(config['thread_entries'])
+                if 'latency_critical' in config:
+                    options['latency_critical'] = list(config['latency_critical'])
+                options.update(config.get('analysis_options', {}))
                 
                 print(f"Loaded configuration from {args.path}")
                 print(f"Source files: {source_files}")
                 print(f"Include paths: {include_paths}")
                 
-                if not source_files:
+                if not source_files and not (args.compile_commands or options.get('compile_commands')):
                     print("Error: No source files specified in configuration")
                     return 1
             except json.JSONDecodeError:
@@ -61,43 +134,49 @@ def main():
             # 直接使用指定的路径
             source_files = [args.path]
         
-        # 执行分析
-        print(f"Analyzing source files...{source_files}")
-        analyzer = CCodeAnalyzer(source_files[0], include_paths).analyze()
+        # 命令行参数覆盖配置文件中的分析选项
+        if args.dump_ast:
+            options['dump_ast'] = args.dump_ast
+        if args.ast_all_files:
+            options['ast_dump_main_file_only'] = False
+        if args.ast_max_depth is not None:
+            options['ast_dump_max_depth'] = args.ast_max_depth
+        if args.ast_kinds:
+            options['ast_dump_kinds'] = [kind.strip() for kind in args.ast_kinds.split(',') if kind.strip()]
+        if args.ast_max_nodes is not None:
+            options['ast_dump_max_nodes'] = args.ast_max_nodes
+        if args.ast_compress:
+            options['ast_dump_compress'] = True
+        if args.header_filter:
+            options['header_filter'] = args.header_filter
+        if args.compile_commands:
+            options['compile_commands'] = args.compile_commands
+        if args.pch:
+            options['precompiled_headers'] = options.get('precompiled_headers', []) + args.pch
+        if args.project_root:
+            options['project_roots'] = options.get('project_roots', []) + args.project_root
+        if args.entry_point:
+            options['entry_points'] = options.get('entry_points', []) + args.entry_point
+        if args.thread_entry:
+            options['thread_entries'] = options.get('thread_entries', []) + args.thread_entry
+        if args.latency_critical:
+            options['latency_critical'] = options.get('latency_critical', []) + args.latency_critical
+        if args.allocator:
+            options['allocators'] = options.get('allocators', []) + args.allocator
         
-        # 生成可视化结果
-        cfg_output = os.path.join(output_dir, 'control_flow_graph.png')
-        dfg_output = os.path.join(output_dir, 'data_flow_graph.png')
-        logic_output = os.path.join(output_dir, 'business_logic.png')
+        if args.watch:
+            # 监视模式下缓存翻译单元，变更后通过reparse复用预编译前导
+            options['reuse_preamble'] = True
         
-        analyzer.visualize_cfg(cfg_output)
-        analyzer.visualize_dfg(dfg_output)
-        analyzer.visualize_business_logic(logic_output)
+        # 执行分析
+        print(f"Analyzing source files...{source_files}")
+        # 未指定源文件时使用编译数据库中的全部源文件
+        analyzer = CCodeAnalyzer(source_files or None, include_paths, options).analyze()
         
-        # 如果需要导出JSON
-        if args.json:
-            json_output = os.path.join(output_dir, 'analysis_result.json')
-            analyzer.export_to_json(json_output)
-            print(f"- Analysis results (JSON): {json_output}")
+        emit_outputs(analyzer, output_dir, args)
         
-        print(f"Analysis complete. Results saved to {output_dir}/")
-        print(f"- Control Flow Graph: {cfg_output}")
-        print(f"- Data Flow Graph: {dfg_output}")
-        print(f"- Business Logic Diagram: {logic_output}")
-        
-        # 输出一些统计信息
-        print("\nStatistics:")
-        print(f"- Total variables: {len(analyzer.variables)}")
-        print(f"- Global variables: {len(analyzer.global_vars)}")
-        print(f"- Static variables: {len(analyzer.static_vars)}")
-        print(f"- Heap variables: {len(analyzer.heap_vars)}")
-        print(f"- Function calls: {len(analyzer.function_calls)}")
-        # 获取函数总数和函数定义数
-        total_functions = len(analyzer.functions)
-        defined_functions = len([f for f in analyzer.functions.values() if not f.get('is_declaration', False)])
-        print(f"- Total functions: {total_functions}")
-        print(f"- Function definitions: {defined_functions}")
-        print(f"- Analyzed files: {len(analyzer.files)}")
+        if args.watch:
+            watch(analyzer, output_dir, args)
         
         return 0
     except Exception as e:
@@ -106,5 +185,173 @@ def main():
         traceback.print_exc()
         return 1
 
+def emit_outputs(analyzer, output_dir, args, images=True):
+    """生成可视化结果、JSON导出和统计信息
+    Args:
+        images: 是否用matplotlib绘制图形（监视模式下每次保存都重新绘制的代价远高于增量分析本身，因此跳过）
+    """
+    # 生成可视化结果
+    cfg_output = os.path.join(output_dir, 'control_flow_graph.png')
+    dfg_output = os.path.join(output_dir, 'data_flow_graph.png')
+    logic_output = os.path.join(output_dir, 'business_logic.png')
+    
+    if images:
+        analyzer.visualize_cfg(cfg_output)
+        analyzer.visualize_dfg(dfg_output)
+        analyzer.visualize_business_logic(logic_output)
+    
+    # 如果需要导出JSON
+    if args.json:
+        json_output = os.path.join(output_dir, 'analysis_result.json')
+        analyzer.export_to_json(json_output)
+        print(f"- Analysis results (JSON): {json_output}")
+    
+    # 流式导出（文件名与--json的analysis_result.json区分，两者可同时使用）
+    if args.stream:
+        stream_output = analyzer.export_streaming(
+            os.path.join(output_dir, f'analysis_result.stream.{args.stream}'), args.stream, args.compress)
+        if stream_output:
+            print(f"- Analysis results ({args.stream.upper()}, streamed): {stream_output}")
+    
+    # 列式二进制导出
+    if args.columnar:
+        columnar_output = os.path.join(output_dir, 'analysis_result.columns')
+        if analyzer.export_columnar(columnar_output) is not None:
+            print(f"- Analysis results (columnar): {columnar_output}")
+    
+    # SQLite分析结果库（增量更新）
+    if args.store:
+        summary = analyzer.export_to_store(args.store, args.store_full)
+        if summary is not None:
+            print(f"- Analysis store: {args.store} ({len(summary['updated'])} file(s) updated, "
+                  f"{len(summary['removed'])} removed, {summary['rows']} rows written)")
+    
+    print(f"Analysis complete. Results saved to {output_dir}/")
+    if images:
+        print(f"- Control Flow Graph: {cfg_output}")
+        print(f"- Data Flow Graph: {dfg_output}")
+        print(f"- Business Logic Diagram: {logic_output}")
+    
+    # 输出一些统计信息
+    print("\nStatistics:")
+    print(f"- Total variables: {len(analyzer.variables)}")
+    print(f"- Global variables: {len(analyzer.global_vars)}")
+    print(f"- Static variables: {len(analyzer.static_vars)}")
+    print(f"- Heap variables: {len(analyzer.heap_vars)}")
+    print(f"- Function calls: {len(analyzer.function_calls)}")
+    if analyzer.indirect_calls:
+        resolved = sum(1 for call_info in analyzer.indirect_calls.values() if call_info['targets'])
+        print(f"- Indirect calls: {len(analyzer.indirect_calls)} ({resolved} resolved)")
+    # 获取函数总数和函数定义数
+    total_functions = len(analyzer.functions)
+    defined_functions = len([f for f in analyzer.functions.values() if not f.get('is_declaration', False)])
+    print(f"- Total functions: {total_functions}")
+    print(f"- Function definitions: {defined_functions}")
+    block_cfgs = [f['block_cfg'] for f in analyzer.functions.values() if f.get('block_cfg') is not None]
+    print(f"- Basic blocks: {sum(cfg.block_count for cfg in block_cfgs)}")
+    print(f"- Loops: {sum(len(cfg.loops) for cfg in block_cfgs)}")
+    if analyzer.call_graph is not None:
+        recursive = sum(len(group) for group in analyzer.call_graph.recursive_groups())
+        print(f"- Call graph SCCs: {analyzer.call_graph.component_count} ({recursive} recursive functions)")
+    print(f"- Analyzed files: {len(analyzer.files)}")
+    
+    # 结构体布局摘要
+    if analyzer.struct_layout_report:
+        print("\nStruct layouts:")
+        for line in StructLayoutAnalyzer.summary(analyzer.struct_layout_report):
+            print(f"- {line}")
+    
+    # 循环中和热点路径上的内存分配
+    if analyzer.allocation_report.get('sites'):
+        print("\nAllocation hot spots:")
+        for line in AllocationAnalyzer.summary(analyzer.allocation_report):
+            print(f"- {line}")
+    
+    # 链表遍历与线性查找
+    if analyzer.list_traversal_report:
+        print("\nLinked-list traversals:")
+        for line in LinkedListTraversalDetector.summary(analyzer.list_traversal_report):
+            print(f"- {line}")
+    
+    # 函数复杂度估计
+    cost_lines = CostModel.summary(analyzer.cost_report) if analyzer.cost_report else []
+    if cost_lines:
+        print("\nMost expensive functions:")
+        for line in cost_lines:
+            print(f"- {line}")
+        for entry, functions in analyzer.cost_report['entry_points'].items():
+            expensive = [f"{item['function']} {item['complexity']}" for item in functions if item['degree']]
+            if expensive:
+                print(f"- entry {entry}: {', '.join(expensive)}")
+    
+    # 多线程共享数据与伪共享
+    shared_lines = SharedStateAnalyzer.summary(analyzer.shared_state_report) if analyzer.shared_state_report else []
+    if shared_lines:
+        threads = [thread['entry'] for thread in analyzer.shared_state_report['threads']]
+        print(f"\nShared state across threads ({', '.join(threads)}):")
+        for line in shared_lines:
+            print(f"- {line}")
+    
+    # 锁争用与临界区
+    lock_lines = LockAnalyzer.summary(analyzer.lock_report) if analyzer.lock_report else []
+    if lock_lines:
+        print("\nLocks and critical sections:")
+        for line in lock_lines:
+            print(f"- {line}")
+    
+    # 延迟敏感路径上的阻塞调用
+    blocking_lines = BlockingCallDetector.summary(analyzer.blocking_report) if analyzer.blocking_report else []
+    if blocking_lines:
+        counts = ', '.join(f"{count} {kind}" for kind, count in analyzer.blocking_report['by_class'].items())
+        print(f"\nBlocking calls on latency-critical paths ({counts}):")
+        for line in blocking_lines:
+            print(f"- {line}")
+    
+    # 内存访问量与指针追逐
+    traffic_lines = MemoryTrafficAnalyzer.summary(analyzer.memory_traffic_report)
+    if traffic_lines:
+        print("\nMemory traffic (ranked by cache-miss pressure):")
+        for line in traffic_lines:
+            print(f"- {line}")
+    
+    # 堆分配逃逸分析
+    escape_lines = EscapeAnalyzer.summary(analyzer.escape_report) if analyzer.escape_report else []
+    if escape_lines:
+        counts = ', '.join(f"{count} {kind}" for kind, count in analyzer.escape_report['by_escape'].items())
+        print(f"\nHeap allocation escape ({counts}):")
+        for line in escape_lines:
+            print(f"- {line}")
+    
+    # 分配与释放配对、泄漏路径和重复释放
+    lifetime_lines = MemoryLifetimeAnalyzer.summary(analyzer.memory_lifetime_report) \
+        if analyzer.memory_lifetime_report else []
+    if lifetime_lines:
+        statistics = analyzer.memory_lifetime_report['statistics']
+        counts = ', '.join(f"{count} {status}" for status, count in statistics['by_status'].items() if count)
+        print(f"\nAllocation lifetimes ({statistics['sites']} site(s): {counts}):")
+        for line in lifetime_lines:
+            print(f"- {line}")
+
+def watch(analyzer, output_dir, args):
+    """监视源文件变更，增量重新分析并重新生成输出，直到用户中断"""
+    roots = {os.path.dirname(os.path.abspath(f)) for f in analyzer.files}
+    roots.update(os.path.abspath(inc) for inc in analyzer.include_paths)
+    
+    with SourceWatcher(roots) as watcher:
+        print(f"\nWatching {len(watcher.roots)} directories ({watcher.backend}). Press Ctrl+C to stop.")
+        try:
+            while True:
+                changed = watcher.wait()
+                if not changed:
+                    continue
+                start = time.perf_counter()
+                print(f"\nChanged: {sorted(changed)}")
+                reextracted = analyzer.reanalyze(changed)
+                emit_outputs(analyzer, output_dir, args, images=False)
+                elapsed = (time.perf_counter() - start) * 1000
+                print(f"Re-analyzed {len(reextracted)} translation unit(s) in {elapsed:.0f} ms")
+        except KeyboardInterrupt:
+            print("\nWatch mode stopped.")
+
 if __name__ == "__main__":
     sys.exit(main())
\ No newline at end of file
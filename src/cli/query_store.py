@@ -0,0 +1,56 @@
+#!/usr/bin/env python3
+import os
+import sys
+import json
+import sqlite3
+import argparse
+sys.path.append(os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+from analyzer.analysis_store import AnalysisStore
+
+def main():
+    parser = argparse.ArgumentParser(description='Query an analysis store written by analyze_c_code.py --store')
+    parser.add_argument('db', help='Path to the SQLite analysis store')
+    parser.add_argument('--json', '-j', action='store_true', help='Print results as JSON')
+    subparsers = parser.add_subparsers(dest='command', required=True)
+    
+    for command, help_text in (('callers', 'Call sites that call FUNCTION'),
+                               ('callees', 'Call sites inside FUNCTION'),
+                               ('function', 'Stored information about FUNCTION'),
+                               ('side-effects', 'Side effects recorded for FUNCTION')):
+        subparsers.add_parser(command, help=help_text).add_argument('name', metavar='FUNCTION')
+    for command, help_text in (('writers', 'Functions that write VARIABLE'),
+                               ('readers', 'Functions that read VARIABLE'),
+                               ('references', 'References to VARIABLE')):
+        subparsers.add_parser(command, help=help_text).add_argument('name', metavar='VARIABLE')
+    subparsers.add_parser('stats', help='Row counts per table')
+    sql_parser = subparsers.add_parser('sql', help='Run a read-only SQL query')
+    sql_parser.add_argument('statement')
+    args = parser.parse_args()
+    
+    if not os.path.exists(args.db):
+        print(f"Error: Store {args.db} does not exist")
+        return 1
+    
+    try:
+        with AnalysisStore(args.db, read_only=True) as store:
+            if args.command == 'stats':
+                result = store.stats()
+            elif args.command == 'sql':
+                result = store.query(args.statement)
+            else:
+                method = getattr(store, args.command.replace('-', '_'))
+                result = method(args.name)
+    except sqlite3.Error as e:
+        # 语法错误、表名错误或只读存储上的写入语句
+        print(f"Error: {e}")
+        return 1
+    
+    if args.json or not isinstance(result, list):
+        print(json.dumps(result, indent=2, ensure_ascii=False))
+    else:
+        for row in result:
+            print('\t'.join('' if value is None else str(value) for value in row.values()))
+    return 0
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -4,6 +4,12 @@ import matplotlib.pyplot as plt
 from matplotlib.colors import LinearSegmentedColormap
 import matplotlib.patches as mpatches
 
+try:
+    from ..analyzer.graph_store import networkx_view
+except ImportError:
+    # 以src为导入根目录时（与命令行工具相同）
+    from analyzer.graph_store import networkx_view
+
 class DataFlowVisualizer:
     """数据流可视化工具，用于展示函数内部和函数间的数据流图"""
     
@@ -61,6 +67,9 @@ class DataFlowVisualizer:
         if not output_file:
             output_file = os.path.join(self.output_dir, f"{function_name}_data_flow.png")
         
+        # 分析器的紧凑图存储需转换为networkx视图后交给布局和绘图函数
+        local_dfg = networkx_view(local_dfg)
+        
         plt.figure(figsize=(14, 10))
         
         # 使用分层布局，更清晰地展示数据流向
@@ -265,6 +274,9 @@ class DataFlowVisualizer:
         if not output_file:
             output_file = os.path.join(self.output_dir, "global_data_flow.png")
         
+        # 分析器的紧凑图存储需转换为networkx视图后交给布局和绘图函数
+        global_dfg = networkx_view(global_dfg)
+        
         plt.figure(figsize=(16, 12))
         
         # 使用分层布局
@@ -0,0 +1,5 @@
+import os
+import sys
+
+# 以仓库根目录为导入路径（与python -m src.cli.analyze_c_code一致）
+sys.path.insert(0, os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
@@ -0,0 +1,31 @@
+"""调用图强连通分量与传递闭包索引的回归测试"""
+
+from src.analyzer.call_graph import CallGraphIndex
+from src.analyzer.graph_store import CompactDiGraph
+
+
+def _index(edges):
+    graph = CompactDiGraph()
+    for caller, callee in edges:
+        graph.add_edge(caller, callee)
+    return CallGraphIndex(graph)
+
+
+def test_closure_size_counts_recursive_group_members():
+    """main -> a <-> b -> c：a、b互相递归，闭包大小按函数数统计"""
+    index = _index([('main', 'a'), ('a', 'b'), ('b', 'a'), ('b', 'c')])
+    assert index.is_recursive('a') and index.is_recursive('b')
+    assert not index.is_recursive('main')
+    assert index.closure_size('main') == len(index.transitive_callees('main')) == 3
+    # 递归函数的闭包包含自身
+    assert index.closure_size('a') == len(index.transitive_callees('a')) == 3
+    assert index.closure_size('c', callers=True) == len(index.transitive_callers('c')) == 3
+    assert index.closure_size('missing') == 0
+
+
+def test_reaches_and_call_chain():
+    index = _index([('main', 'a'), ('a', 'b'), ('main', 'c'), ('c', 'b')])
+    assert index.reaches('main', 'b')
+    assert not index.reaches('b', 'main')
+    chain = index.call_chain('main', ('b',))
+    assert chain[0] == 'main' and chain[-1] == 'b' and len(chain) == 3
@@ -0,0 +1,42 @@
+"""编译数据库include目录与项目根目录的回归测试"""
+
+import json
+
+from src.analyzer.c_code_analyzer import CCodeAnalyzer
+from src.analyzer.compilation_database import CompilationDatabase
+
+
+def _project(tmp_path):
+    """项目include目录inc/与第三方目录third_party/（位于项目之外）各定义一个结构体"""
+    project = tmp_path / 'project'
+    (project / 'src').mkdir(parents=True)
+    (project / 'inc').mkdir()
+    third_party = tmp_path / 'third_party'
+    third_party.mkdir()
+    (project / 'inc' / 'foo.h').write_text('struct Foo { char a; long b; };\n', encoding='utf-8')
+    (third_party / 'bar.h').write_text('struct Bar { char c; long v; };\n', encoding='utf-8')
+    (project / 'src' / 'm.c').write_text(
+        '#include "foo.h"\n#include "bar.h"\n'
+        'long get(struct Foo *f, struct Bar *b) { return f->b + b->v; }\n', encoding='utf-8')
+    (project / 'compile_commands.json').write_text(json.dumps([{
+        'directory': str(project),
+        'command': f'cc -I inc -I {third_party} -c src/m.c -o m.o',
+        'file': 'src/m.c',
+    }]), encoding='utf-8')
+    return project, third_party
+
+
+def test_include_directories_outside_project_are_not_roots(tmp_path):
+    project, third_party = _project(tmp_path)
+    database = CompilationDatabase(str(project))
+    assert database.include_directories(database.source_files()) == [str(project / 'inc')]
+
+
+def test_third_party_structs_are_pruned_unless_listed_as_project_root(tmp_path):
+    project, third_party = _project(tmp_path)
+    analyzer = CCodeAnalyzer(None, [], {'compile_commands': str(project)}).analyze()
+    assert [layout['name'] for layout in analyzer.struct_layout_report.values()] == ['Foo']
+
+    analyzer = CCodeAnalyzer(None, [], {'compile_commands': str(project),
+                                        'project_roots': [str(project), str(third_party)]}).analyze()
+    assert sorted(layout['name'] for layout in analyzer.struct_layout_report.values()) == ['Bar', 'Foo']
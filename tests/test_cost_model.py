@@ -0,0 +1,58 @@
+"""函数代价模型（循环嵌套、经调用累加的次数、递归加成、入口函数排序）的回归测试"""
+
+import textwrap
+
+from src.analyzer.c_code_analyzer import CCodeAnalyzer
+
+
+SOURCE = '''
+    #define MAX_SLOTS 16
+    struct node { int value; struct node *next; };
+    static int slots[MAX_SLOTS];
+    static int sum_slots(void) { int s = 0; for (int i = 0; i < MAX_SLOTS; i++) s += slots[i]; return s; }
+    static int length(struct node *head) { int n = 0; for (; head; head = head->next) n++; return n; }
+    static int total_length(struct node **lists, int count) {
+        int total = 0;
+        for (int i = 0; i < count; i++) total += length(lists[i]);
+        return total;
+    }
+    static int depth(struct node *node) { return node ? 1 + depth(node->next) : 0; }
+    int main(int argc, char **argv) {
+        struct node *lists[4] = {0};
+        return sum_slots() + total_length(lists, argc) + depth(lists[0]);
+    }
+'''
+
+
+def _cost_report(tmp_path, options=None):
+    path = tmp_path / 'sample.c'
+    path.write_text(textwrap.dedent(SOURCE).lstrip('\n'), encoding='utf-8')
+    return CCodeAnalyzer([str(path)], [], {'entry_points': ['main'], **(options or {})}).analyze().cost_report
+
+
+def test_function_complexity(tmp_path):
+    """常量上界循环为O(1)，链表遍历为O(n)，可变循环中调用O(n)函数为O(n^2)，线性递归为O(n)"""
+    costs = _cost_report(tmp_path)['functions']
+    assert {name: cost['complexity'] for name, cost in costs.items()} == {
+        'sum_slots': 'O(1)', 'length': 'O(n)', 'total_length': 'O(n^2)', 'depth': 'O(n)', 'main': 'O(n^2)',
+    }
+    assert (costs['sum_slots']['loops'], costs['sum_slots']['constant_loops']) == (1, 1)
+    assert costs['length']['traversal_loops'] == 1
+    assert costs['total_length']['local_complexity'] == 'O(n)'
+    assert costs['total_length']['calls_in_loops'] == [
+        {'callee': 'length', 'line': 8, 'loop_depth': 1, 'indirect': False},
+    ]
+    assert costs['total_length']['dominant_call'] == {'callee': 'length', 'line': 8, 'loop_depth': 1, 'indirect': False}
+    assert costs['depth']['recursive'] and costs['depth']['local_degree'] == 0
+    assert costs['main']['cost_chain'] == ['main', 'total_length', 'length']
+
+
+def test_entry_point_ranking(tmp_path):
+    """入口函数可达的函数按次数从高到低排序，cost_top_n限制报告数量"""
+    ranked = _cost_report(tmp_path)['entry_points']['main']
+    assert [entry['function'] for entry in ranked] == ['total_length', 'main', 'length', 'depth', 'sum_slots']
+    assert ranked[0]['call_chain'] == ['main', 'total_length']
+    assert ranked[2]['call_chain'] == ['main', 'total_length', 'length']
+
+    top = _cost_report(tmp_path, {'cost_top_n': 2})['entry_points']['main']
+    assert [entry['function'] for entry in top] == ['total_length', 'main']
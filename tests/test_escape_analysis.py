@@ -0,0 +1,78 @@
+"""堆分配逃逸分析（按持有者分类、栈或arena分配候选）的回归测试"""
+
+import textwrap
+
+from src.analyzer.c_code_analyzer import CCodeAnalyzer
+
+
+def _escape_report(tmp_path, source):
+    path = tmp_path / 'sample.c'
+    path.write_text(textwrap.dedent(source).lstrip('\n'), encoding='utf-8')
+    return CCodeAnalyzer([str(path)], [], {}).analyze().escape_report
+
+
+def test_escape_categories(tmp_path):
+    """每个分配点按离开分配函数的方式分类，逃逸程度最低的排在前面"""
+    report = _escape_report(tmp_path, '''
+        #include <pthread.h>
+        #include <stdlib.h>
+        #include <string.h>
+        struct node { int value; struct node *next; };
+        static struct node *registry;
+        void external_sink(void *p);
+        static void *worker(void *arg) { free(arg); return 0; }
+        static struct node *make_node(int value) {
+            struct node *node = malloc(sizeof *node);
+            node->value = value;
+            return node;
+        }
+        int scratch(int n) {
+            int *buffer = malloc(n * sizeof *buffer);
+            memset(buffer, 0, n * sizeof *buffer);
+            int first = buffer[0];
+            free(buffer);
+            return first;
+        }
+        void publish(void) { registry = malloc(sizeof *registry); }
+        void link_after(struct node *head) { head->next = malloc(sizeof *head->next); }
+        void hand_off(void) { pthread_t t; pthread_create(&t, 0, worker, malloc(16)); }
+        void leak_out(void) { external_sink(calloc(1, 8)); }
+        int use(void) { struct node *node = make_node(1); int v = node->value; free(node); return v; }
+    ''')
+    sites = report['sites']
+    assert [(site['function'], site['escape']) for site in sites] == [
+        ('scratch', 'local'), ('make_node', 'returned'), ('leak_out', 'external'),
+        ('hand_off', 'thread'), ('link_after', 'heap'), ('publish', 'global'),
+    ]
+    assert report['by_escape'] == {escape: 1 for escape in ('global', 'heap', 'thread', 'external', 'returned', 'local')}
+
+    by_function = {site['function']: site for site in sites}
+    # 传给memset/free不算逃逸
+    assert by_function['scratch']['candidate'] == 'stack' and by_function['scratch']['escapes'] == {}
+    assert by_function['make_node']['candidate'] == 'arena'
+    assert by_function['make_node']['held_in'] == ['make_node', 'use']
+    assert by_function['make_node']['holder_chains'] == {'use': ['use', 'make_node']}
+    assert by_function['publish']['escapes'] == {'global': ['registry']}
+    assert by_function['link_after']['escapes'] == {'heap': ['node.next']}
+    assert by_function['hand_off']['escapes'] == {'thread': ['pthread_create']}
+    assert by_function['leak_out']['escapes'] == {'external': ['external_sink#arg0']}
+    assert all(by_function[name]['candidate'] is None for name in ('publish', 'link_after', 'hand_off', 'leak_out'))
+
+
+def test_store_in_callee_escapes(tmp_path):
+    """经参数传给把它存入全局变量的被调函数时，分配点按被调函数中的存储分类"""
+    report = _escape_report(tmp_path, '''
+        #include <stdlib.h>
+        static void *cache;
+        static void remember(void *p) { cache = p; }
+        void fill(int n) {
+            for (int i = 0; i < n; i++) {
+                char *entry = malloc(32);
+                remember(entry);
+            }
+        }
+    ''')
+    [site] = report['sites']
+    assert (site['function'], site['escape'], site['loop_depth']) == ('fill', 'global', 1)
+    assert site['escapes'] == {'global': ['cache']}
+    assert site['candidate'] is None
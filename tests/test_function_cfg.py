@@ -0,0 +1,93 @@
+"""函数内部基本块控制流图（分支边、循环嵌套、常量上界）的回归测试"""
+
+import textwrap
+
+from src.analyzer.c_code_analyzer import CCodeAnalyzer
+
+
+def _block_cfgs(tmp_path, source):
+    path = tmp_path / 'sample.c'
+    path.write_text(textwrap.dedent(source).lstrip('\n'), encoding='utf-8')
+    analyzer = CCodeAnalyzer([str(path)], [], {}).analyze()
+    return {name: info['block_cfg'] for name, info in analyzer.functions.items() if info.get('block_cfg') is not None}
+
+
+def _edge_kinds(cfg):
+    return sorted(cfg.EDGE_KINDS[code] for code in cfg.edge_kind)
+
+
+def test_if_else_branches(tmp_path):
+    """if/else分为条件块和两个分支，两个return都连到出口"""
+    cfg = _block_cfgs(tmp_path, '''
+        int sign(int x) {
+            if (x < 0) {
+                return -1;
+            } else {
+                x = 1;
+            }
+            return x;
+        }
+    ''')['sign']
+    assert cfg.cyclomatic_complexity == 2
+    assert cfg.loops == []
+    kinds = _edge_kinds(cfg)
+    assert kinds.count('true') == 1 and kinds.count('false') == 1
+    assert kinds.count('return') == 2
+    assert 'condition' in [cfg.block_kind_name(block) for block in range(cfg.block_count)]
+    assert cfg.exit in cfg.reachable_blocks()
+
+
+def test_nested_loops_depth_and_bounds(tmp_path):
+    """for循环与常量比较为常量上界，内层遍历链表的while循环不是；调用记录在内层循环中"""
+    cfgs = _block_cfgs(tmp_path, '''
+        struct node { int value; struct node *next; };
+        void visit(struct node *node);
+        void scan(struct node *heads[8]) {
+            for (int i = 0; i < 8; i++) {
+                struct node *p = heads[i];
+                while (p != 0) {
+                    visit(p);
+                    p = p->next;
+                }
+            }
+        }
+    ''')
+    cfg = cfgs['scan']
+    loops = {loop['kind']: loop for loop in cfg.loops}
+    assert set(loops) == {'for', 'while'}
+    assert (loops['for']['depth'], loops['for']['start_line'], loops['for']['end_line']) == (1, 4, 10)
+    assert (loops['while']['depth'], loops['while']['start_line'], loops['while']['end_line']) == (2, 6, 9)
+    assert loops['for']['constant_bound'] and not loops['while']['constant_bound']
+    assert loops['while']['calls'] == ['visit']
+    assert set(loops['while']['blocks']) < set(loops['for']['blocks'])
+    assert _edge_kinds(cfg).count('back') == 2
+    assert cfg.max_loop_depth == 2
+    assert [cfg.loop_depth_at(line) for line in (3, 5, 7)] == [0, 1, 2]
+    assert cfg.variable_loop_depth_at(7) == 1
+    calls = [call for block_calls in cfg.block_calls.values() for call in block_calls]
+    assert calls == [('visit', 7, 13, False)]
+
+
+def test_break_continue_and_switch(tmp_path):
+    """break/continue连到循环出口和增量块，没有default的switch有一条跳过全部case的边"""
+    cfg = _block_cfgs(tmp_path, '''
+        int count(const int *values, int n) {
+            int total = 0;
+            for (int i = 0; i < n; i++) {
+                if (values[i] < 0) continue;
+                if (values[i] == 0) break;
+                switch (values[i]) {
+                case 1: total += 1; break;
+                case 2: total += 2;
+                }
+            }
+            return total;
+        }
+    ''')['count']
+    kinds = _edge_kinds(cfg)
+    assert kinds.count('continue') == 1
+    assert kinds.count('break') == 2
+    assert kinds.count('case') == 2
+    assert cfg.loops[0]['constant_bound'] is False
+    # 两个if、两个case标签、switch跳过全部case以及循环条件各增加一条独立路径
+    assert cfg.cyclomatic_complexity == 6
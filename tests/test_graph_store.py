@@ -0,0 +1,66 @@
+"""紧凑图存储（CSR索引、按列存储的属性）与networkx.DiGraph行为一致性的回归测试"""
+
+import networkx as nx
+import numpy as np
+
+from src.analyzer.graph_store import CompactDiGraph
+
+
+def _build(graph):
+    """对两种图执行相同的添加操作：重复的边更新属性，查询穿插在添加之间"""
+    graph.add_node('main', type='function')
+    graph.add_edge('main', 'init', type='call')
+    graph.add_edge('main', 'update', type='call', line=12)
+    graph.add_edge('update', 'find', type='call')
+    assert graph.has_edge('main', 'update')
+    graph.add_edge('update', 'callback', type='indirect')
+    graph.add_edge('main', 'update', line=14)
+    graph.add_edge('find', 'update', type='call')
+    graph.add_edge('main', 'init', type='call')
+    graph.add_node('init', inline=True)
+    return graph
+
+
+def test_matches_networkx():
+    compact = _build(CompactDiGraph())
+    expected = _build(nx.DiGraph())
+
+    assert list(compact.nodes(data=True)) == list(expected.nodes(data=True))
+    assert list(compact.edges(data=True)) == list(expected.edges(data=True))
+    assert compact.number_of_edges() == len(compact.edges) == expected.number_of_edges() == 5
+    for node in expected:
+        assert list(compact.successors(node)) == list(expected.successors(node))
+        assert list(compact.predecessors(node)) == list(expected.predecessors(node))
+        assert compact.out_degree(node) == expected.out_degree(node)
+        assert compact.in_degree(node) == expected.in_degree(node)
+        assert compact.in_edges(node, data=True) == list(expected.in_edges(node, data=True))
+    assert compact.edges['main', 'update'] == {'type': 'call', 'line': 14}
+    assert compact.nodes['init'] == {'inline': True}
+    assert not compact.has_edge('update', 'main')
+    assert not compact.has_edge('main', 'missing')
+    assert ('find', 'update') in compact.edges
+
+
+def test_csr_arrays():
+    graph = _build(CompactDiGraph())
+    indptr, targets = graph.csr()
+    assert isinstance(indptr, np.ndarray) and isinstance(targets, np.ndarray)
+    for node_id in range(graph.number_of_nodes()):
+        node = graph.node_key(node_id)
+        successors = [graph.node_key(target) for target in targets[indptr[node_id]:indptr[node_id + 1]]]
+        assert successors == list(graph.successors(node))
+
+
+def test_copy_and_networkx_view_round_trip():
+    graph = _build(CompactDiGraph())
+    copied = graph.copy()
+    copied.add_edge('find', 'cleanup', type='call')
+    copied.add_edge('main', 'update', line=20)
+    assert not graph.has_edge('find', 'cleanup')
+    assert graph.edges['main', 'update']['line'] == 14
+    assert copied.edges['main', 'update'] == {'type': 'call', 'line': 20}
+
+    view = graph.as_networkx()
+    assert isinstance(view, nx.DiGraph)
+    assert list(view.edges(data=True)) == list(graph.edges(data=True))
+    assert dict(view.nodes(data=True)) == dict(graph.nodes(data=True))
@@ -0,0 +1,108 @@
+"""监视模式增量重新分析的回归测试：只重新提取受影响的翻译单元，结果与完整分析一致"""
+
+import json
+import textwrap
+
+from src.analyzer.c_code_analyzer import CCodeAnalyzer
+
+
+def _write(path, source):
+    path.write_text(textwrap.dedent(source).lstrip('\n'), encoding='utf-8')
+
+
+def _normalize(value):
+    if isinstance(value, dict):
+        return {key: _normalize(item) for key, item in value.items()}
+    if isinstance(value, list):
+        return sorted((_normalize(item) for item in value), key=lambda item: json.dumps(item, sort_keys=True))
+    return value
+
+
+def _exported(analyzer, path):
+    analyzer.export_to_json(str(path))
+    return _normalize(json.loads(path.read_text(encoding='utf-8')))
+
+
+def _assert_matches_full_analysis(analyzer, tmp_path):
+    """增量结果与按相同文件顺序完整分析一次的结果相同"""
+    full = CCodeAnalyzer(list(analyzer.files), [], dict(analyzer.options)).analyze()
+    assert _exported(analyzer, tmp_path / 'incremental.json') == _exported(full, tmp_path / 'full.json')
+
+
+def test_only_affected_translation_units_are_reextracted(tmp_path):
+    header, a, b = tmp_path / 'common.h', tmp_path / 'a.c', tmp_path / 'b.c'
+    _write(header, '''
+        struct item { int key; struct item *next; };
+        struct item *make_item(int key);
+    ''')
+    _write(a, '''
+        #include <stdlib.h>
+        #include "common.h"
+        struct item *make_item(int key) {
+            struct item *item = malloc(sizeof *item);
+            item->key = key;
+            return item;
+        }
+    ''')
+    _write(b, '''
+        #include "common.h"
+        int main(void) { return make_item(1)->key; }
+    ''')
+    analyzer = CCodeAnalyzer([str(a), str(b)], [], {'reuse_preamble': True, 'entry_points': ['main']}).analyze()
+
+    _write(b, '''
+        #include <stdlib.h>
+        #include "common.h"
+        static int total(struct item *head) {
+            int sum = 0;
+            for (; head; head = head->next) sum += head->key;
+            return sum;
+        }
+        int main(void) { struct item *item = make_item(1); int sum = total(item); free(item); return sum; }
+    ''')
+    # 第一次变更：快照覆盖全部文件，未受影响的a.c从翻译单元缓存重新提取一次（不重新解析）
+    assert analyzer.reanalyze({str(b)}) == [str(a), str(b)]
+    assert 'total' in analyzer.functions
+    _assert_matches_full_analysis(analyzer, tmp_path)
+
+    # 再次编辑同一文件：其余翻译单元从快照恢复
+    _write(b, '''
+        #include "common.h"
+        int main(void) { return make_item(2)->key; }
+    ''')
+    assert analyzer.reanalyze({str(b)}) == [str(b)]
+    assert 'total' not in analyzer.functions
+    _assert_matches_full_analysis(analyzer, tmp_path)
+
+    # 与分析无关的文件变更：快照之后最近编辑过的b.c从缓存重新提取，之后编辑b.c仍只重新提取b.c
+    (tmp_path / 'notes.h').write_text('#define UNUSED 1\n', encoding='utf-8')
+    assert analyzer.reanalyze({str(tmp_path / 'notes.h')}) == [str(b)]
+    assert analyzer.reanalyze({str(b)}) == [str(b)]
+    _assert_matches_full_analysis(analyzer, tmp_path)
+
+    # 头文件变更：包含它的两个翻译单元都重新提取，受影响的翻译单元排在最后
+    _write(header, '''
+        struct item { int key; int value; struct item *next; };
+        struct item *make_item(int key);
+    ''')
+    assert analyzer.reanalyze({str(header)}) == [str(a), str(b)]
+    _assert_matches_full_analysis(analyzer, tmp_path)
+
+
+def test_new_files_outside_the_inputs_are_not_added(tmp_path):
+    a, extra = tmp_path / 'a.c', tmp_path / 'scratch.c'
+    _write(a, 'int main(void) { return 0; }\n')
+    analyzer = CCodeAnalyzer([str(a)], [], {'reuse_preamble': True}).analyze()
+
+    _write(extra, 'int scratch(void) { return 1; }\n')
+    assert analyzer.reanalyze({str(extra)}) == []
+    assert analyzer.files == [str(a)]
+    assert 'scratch' not in analyzer.functions
+
+    # 输入文件删除后重新出现时重新加入分析
+    a.unlink()
+    assert analyzer.reanalyze({str(a)}) == []
+    assert analyzer.files == []
+    _write(a, 'int main(void) { return 1; }\n')
+    assert analyzer.reanalyze({str(a)}) == [str(a)]
+    assert 'main' in analyzer.functions
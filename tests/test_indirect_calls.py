@@ -0,0 +1,59 @@
+"""函数指针调用解析（结构体字段、回调实参、函数指针变量）的回归测试"""
+
+import textwrap
+
+from src.analyzer.c_code_analyzer import CCodeAnalyzer
+
+
+def _analyze(tmp_path, source):
+    path = tmp_path / 'sample.c'
+    path.write_text(textwrap.dedent(source).lstrip('\n'), encoding='utf-8')
+    return CCodeAnalyzer([str(path)], [], {}).analyze()
+
+
+def _targets(analyzer, caller):
+    """调用者中各间接调用的 函数指针表达式 -> 解析出的目标函数"""
+    return {call['function']: sorted(call['targets'])
+            for call in analyzer.indirect_calls.values() if call['caller'] == caller}
+
+
+def test_call_through_struct_field(tmp_path):
+    """timer->callback(...)解析为注册时存入该字段的函数，不产生指向字段名callback的调用边"""
+    analyzer = _analyze(tmp_path, '''
+        typedef void (*Callback)(void *);
+        struct timer { Callback callback; void *arg; };
+        static void on_expire(void *arg) { }
+        static void on_retry(void *arg) { }
+        void timer_init(struct timer *timer, Callback callback) { timer->callback = callback; }
+        void timer_fire(struct timer *timer) { timer->callback(timer->arg); }
+        int main(void) {
+            struct timer a, b;
+            timer_init(&a, on_expire);
+            timer_init(&b, on_retry);
+            timer_fire(&a);
+            return 0;
+        }
+    ''')
+    assert _targets(analyzer, 'timer_fire') == {'callback': ['on_expire', 'on_retry']}
+    assert sorted(analyzer.cfg.successors('timer_fire')) == ['on_expire', 'on_retry']
+    assert analyzer.cfg.edges['timer_fire', 'on_expire']['type'] == 'indirect'
+    assert not analyzer.cfg.has_node('callback')
+
+
+def test_callback_argument_and_dereferenced_pointer(tmp_path):
+    """作为实参传入的回调经形参调用；(*fp)(...)与fp(...)解析出相同的目标"""
+    analyzer = _analyze(tmp_path, '''
+        static int twice(int x) { return 2 * x; }
+        static int square(int x) { return x * x; }
+        static int apply(int (*fn)(int), int x) { return fn(x) + (*fn)(x); }
+        int main(void) {
+            int (*pick)(int) = square;
+            return apply(twice, 1) + pick(3);
+        }
+    ''')
+    apply_calls = [call for call in analyzer.indirect_calls.values() if call['caller'] == 'apply']
+    assert len(apply_calls) == 2
+    assert all(call['targets'] == ['twice'] for call in apply_calls)
+    assert _targets(analyzer, 'main') == {'pick': ['square']}
+    assert set(analyzer.cfg.successors('main')) == {'apply', 'square'}
+    assert list(analyzer.cfg.successors('apply')) == ['twice']
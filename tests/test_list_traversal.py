@@ -0,0 +1,82 @@
+"""链表遍历循环分类（查找、过滤、遍历）的回归测试"""
+
+import textwrap
+
+from src.analyzer.c_code_analyzer import CCodeAnalyzer
+
+
+def _analyze(tmp_path, source):
+    path = tmp_path / 'sample.c'
+    path.write_text(textwrap.dedent(source).lstrip('\n'), encoding='utf-8')
+    return CCodeAnalyzer([str(path)], [], {'entry_points': ['main']}).analyze()
+
+
+def _loops(analyzer):
+    return {item['function']: item for item in analyzer.list_traversal_report}
+
+
+def test_search_filter_and_walk(tmp_path):
+    """比较键后提前退出为查找，比较键但不退出为过滤，不比较键为遍历；与NULL比较不算键比较"""
+    analyzer = _analyze(tmp_path, '''
+        #include <stddef.h>
+        struct node { int id; int value; struct node *next; };
+        struct node *find(struct node *head, int id) {
+            for (struct node *p = head; p != NULL; p = p->next)
+                if (p->id == id) return p;
+            return NULL;
+        }
+        int count_matching(struct node *head, int value) {
+            int n = 0;
+            struct node *p = head;
+            while (p) {
+                if (p->value == value) n++;
+                p = p->next;
+            }
+            return n;
+        }
+        int length(struct node *head) {
+            int n = 0;
+            for (struct node *p = head; p != NULL; p = p->next) n++;
+            return n;
+        }
+        int main(void) { return find(NULL, 1) != NULL; }
+    ''')
+    loops = _loops(analyzer)
+    assert set(loops) == {'find', 'count_matching', 'length'}
+
+    assert loops['find']['kind'] == 'search'
+    assert loops['find']['key_fields'] == ['id']
+    assert loops['find']['early_exit']
+    assert loops['find']['link'] == 'node.next'
+    assert loops['find']['cursor'] == 'p'
+
+    assert loops['count_matching']['kind'] == 'filter'
+    assert loops['count_matching']['key_fields'] == ['value']
+    assert not loops['count_matching']['early_exit']
+
+    assert loops['length']['kind'] == 'walk'
+    assert loops['length']['key_fields'] == []
+
+
+def test_search_reached_from_loop_is_flagged(tmp_path):
+    """入口在循环中调用查找函数时，每次操作都要重复遍历链表"""
+    analyzer = _analyze(tmp_path, '''
+        #include <stddef.h>
+        struct node { int id; struct node *next; };
+        struct node *find(struct node *head, int id) {
+            for (struct node *p = head; p; p = p->next)
+                if (p->id == id) return p;
+            return NULL;
+        }
+        int main(void) {
+            int hits = 0;
+            for (int i = 0; i < 10; i++)
+                hits += find(NULL, i) != NULL;
+            return hits;
+        }
+    ''')
+    item = _loops(analyzer)['find']
+    assert item['callers'] == ['main']
+    assert item['entry_points']['main']['in_loop']
+    assert item['repeated_per_operation'] == ['main']
+    assert item['flagged']
@@ -0,0 +1,87 @@
+"""锁与临界区分析（锁顺序反转、经调用的重复加锁、临界区内容、返回时仍持有的锁）的回归测试"""
+
+import textwrap
+
+from src.analyzer.c_code_analyzer import CCodeAnalyzer
+
+
+SOURCE = '''
+    #include <pthread.h>
+    #include <stdlib.h>
+    struct queue { pthread_mutex_t lock; int size; };
+    static pthread_mutex_t table_lock = PTHREAD_MUTEX_INITIALIZER;
+    static pthread_mutex_t log_lock = PTHREAD_MUTEX_INITIALIZER;
+    static int entries;
+    static void write_log(void) {
+        pthread_mutex_lock(&log_lock);
+        entries++;
+        pthread_mutex_unlock(&log_lock);
+    }
+    void update_table(int n) {
+        pthread_mutex_lock(&table_lock);
+        for (int i = 0; i < n; i++) entries += i;
+        write_log();
+        pthread_mutex_unlock(&table_lock);
+    }
+    void flush_log(void) {
+        pthread_mutex_lock(&log_lock);
+        pthread_mutex_lock(&table_lock);
+        void *buffer = malloc(entries);
+        free(buffer);
+        pthread_mutex_unlock(&table_lock);
+        pthread_mutex_unlock(&log_lock);
+    }
+    void queue_lock(struct queue *queue) { pthread_mutex_lock(&queue->lock); }
+    void reenter(void) {
+        pthread_mutex_lock(&log_lock);
+        write_log();
+        pthread_mutex_unlock(&log_lock);
+    }
+'''
+
+
+def _lock_report(tmp_path):
+    path = tmp_path / 'sample.c'
+    path.write_text(textwrap.dedent(SOURCE).lstrip('\n'), encoding='utf-8')
+    return CCodeAnalyzer([str(path)], [], {}).analyze().lock_report
+
+
+def test_lock_order_inversion_and_self_deadlock(tmp_path):
+    """update_table经write_log形成table_lock -> log_lock，flush_log直接形成反向顺序；reenter经调用重复加锁log_lock"""
+    report = _lock_report(tmp_path)
+    inversion, self_deadlock = report['inversions']
+    assert inversion['locks'] == ['log_lock', 'table_lock']
+    sites = {(edge['from'], edge['to']): edge['sites'] for edge in inversion['edges']}
+    assert sites[('table_lock', 'log_lock')] == [
+        {'function': 'update_table', 'line': 15, 'call_chain': ['update_table', 'write_log']},
+    ]
+    assert sites[('log_lock', 'table_lock')] == [{'function': 'flush_log', 'line': 20, 'call_chain': ['flush_log']}]
+
+    assert self_deadlock['self_deadlock'] and self_deadlock['locks'] == ['log_lock']
+    assert self_deadlock['edges'][0]['sites'][0]['call_chain'] == ['reenter', 'write_log']
+
+    locks = {summary['lock']: summary for summary in report['locks']}
+    assert locks['table_lock']['inverted_with'] == ['log_lock']
+    assert locks['log_lock']['inverted_with'] == ['table_lock']
+
+
+def test_critical_section_contents(tmp_path):
+    """临界区记录其中的循环、调用和内存分配；加锁封装函数返回时仍持有以字段命名的锁"""
+    report = _lock_report(tmp_path)
+    sections = {(section['function'], section['lock']): section for section in report['critical_sections']}
+
+    update = sections['update_table', 'table_lock']
+    assert (update['acquire_line'], update['release_lines']) == (13, [16])
+    assert update['complexity'] == 'O(n)'
+    assert [loop['line'] for loop in update['loops']] == [14]
+    assert update['nested_locks'] == ['log_lock']
+    assert update['long'] and update['reasons'] == ['loop', 'nested lock']
+
+    flush = sections['flush_log', 'table_lock']
+    assert flush['allocations'] == [{'callee': 'malloc', 'line': 21}]
+    assert 'allocation' in flush['reasons']
+
+    write = sections['write_log', 'log_lock']
+    assert not write['long'] and write['reasons'] == []
+
+    assert report['held_at_exit'] == [{'function': 'queue_lock', 'lock': 'queue.lock', 'acquire_line': 26}]
@@ -0,0 +1,66 @@
+"""分配与释放配对、重复释放检测的回归测试"""
+
+import textwrap
+
+from src.analyzer.c_code_analyzer import CCodeAnalyzer
+
+
+def _analyze(tmp_path, source):
+    path = tmp_path / 'sample.c'
+    path.write_text(textwrap.dedent(source).lstrip('\n'), encoding='utf-8')
+    return CCodeAnalyzer([str(path)], [], {}).analyze()
+
+
+def test_free_through_out_parameter_is_paired(tmp_path):
+    """*out = malloc(...)写入调用者的变量，调用者释放其副本时与分配点配对"""
+    analyzer = _analyze(tmp_path, '''
+        #include <stdlib.h>
+        void make(int **out) {
+            *out = malloc(sizeof(int));
+        }
+        void use(void) {
+            int *a;
+            make(&a);
+            int *b = a;
+            free(b);
+        }
+        int main(void) { use(); return 0; }
+    ''')
+    assert {'use::a', 'use::b'} <= analyzer.heap_vars
+    sites = analyzer.memory_lifetime_report['sites']
+    assert len(sites) == 1
+    site = sites[0]
+    assert site['function'] == 'make'
+    assert site['status'] == 'paired'
+    assert [(free['function'], free['line']) for free in site['freed_at']] == [('use', 9)]
+
+
+def test_double_free_on_one_line(tmp_path):
+    """同一行上的两次free(y)按列区分先后"""
+    analyzer = _analyze(tmp_path, '''
+        #include <stdlib.h>
+        int main(void) {
+            char *y = malloc(8);
+            free(y); free(y);
+            return 0;
+        }
+    ''')
+    double_frees = analyzer.memory_lifetime_report['double_frees']
+    assert len(double_frees) == 1
+    item = double_frees[0]
+    assert item['expression'] == 'y'
+    assert item['first_line'] == item['second_line'] == 4
+    assert item['first_column'] < item['second_column']
+
+
+def test_reassignment_between_frees_on_one_line(tmp_path):
+    """两次释放之间重新赋值不是重复释放"""
+    analyzer = _analyze(tmp_path, '''
+        #include <stdlib.h>
+        int main(void) {
+            char *y = malloc(8);
+            free(y); y = malloc(8); free(y);
+            return 0;
+        }
+    ''')
+    assert analyzer.memory_lifetime_report['double_frees'] == []
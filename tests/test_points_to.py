@@ -0,0 +1,74 @@
+"""指针指向分析（强连通分量收缩、读写约束工作表）与分配函数判断的回归测试"""
+
+import textwrap
+
+from src.analyzer.c_code_analyzer import CCodeAnalyzer
+
+
+def _analyze(tmp_path, source, options=None):
+    path = tmp_path / 'sample.c'
+    path.write_text(textwrap.dedent(source).lstrip('\n'), encoding='utf-8')
+    return CCodeAnalyzer([str(path)], [], options or {}).analyze()
+
+
+def _labels(analyzer, node):
+    """节点可能指向的对象标签"""
+    points_to = analyzer.points_to.to_dict()
+    return sorted(points_to['objects'][object_id]['label'] for object_id in points_to['nodes'].get(node, []))
+
+
+def test_copy_cycle_shares_points_to_set(tmp_path):
+    """复制环p -> q -> r -> p收缩为一个分量，环上任一变量得到的对象传给所有成员"""
+    analyzer = _analyze(tmp_path, '''
+        #include <stdlib.h>
+        int g;
+        void cycle(int n) {
+            int *p = malloc(4), *q, *r;
+            while (n--) { q = p; r = q; p = r; }
+            r = &g;
+        }
+    ''')
+    for name in ('cycle::p', 'cycle::q', 'cycle::r'):
+        assert _labels(analyzer, name) == ['&g', 'malloc@cycle:4']
+    assert {'cycle::p', 'cycle::q', 'cycle::r'} <= analyzer.heap_vars
+
+
+def test_store_and_load_through_pointer(tmp_path):
+    """*pp = malloc(...)写入pp所指的变量a，b = *pp再从a读出；pp的指向在读写之后才确定"""
+    analyzer = _analyze(tmp_path, '''
+        #include <stdlib.h>
+        void indirect(void) {
+            int *a, *b, **pp, **qq;
+            *qq = malloc(4);
+            b = *qq;
+            qq = pp;
+            pp = &a;
+        }
+    ''')
+    assert _labels(analyzer, 'indirect::qq') == ['&indirect::a']
+    assert _labels(analyzer, 'indirect::a') == ['malloc@indirect:4']
+    assert _labels(analyzer, 'indirect::b') == ['malloc@indirect:4']
+    assert {'indirect::a', 'indirect::b'} <= analyzer.heap_vars
+
+
+def test_allocator_names_are_not_guessed(tmp_path):
+    """名称中含new、copy的函数不是分配函数，配置的自定义分配函数才作为堆分配点"""
+    source = '''
+        struct config;
+        struct config *renew_config(struct config *old);
+        int *copy_count(void);
+        void *pool_alloc(unsigned size);
+        void use(struct config *old) {
+            struct config *c = renew_config(old);
+            int *n = copy_count();
+            char *buf = pool_alloc(16);
+        }
+    '''
+    analyzer = _analyze(tmp_path, source)
+    assert not {'use::c', 'use::n', 'use::buf'} & analyzer.heap_vars
+    assert not [obj for obj in analyzer.points_to.objects if obj['kind'] == 'heap']
+
+    analyzer = _analyze(tmp_path, source, {'allocators': ['pool_alloc']})
+    assert not {'use::c', 'use::n'} & analyzer.heap_vars
+    assert 'use::buf' in analyzer.heap_vars
+    assert _labels(analyzer, 'use::buf') == ['pool_alloc@use:8']
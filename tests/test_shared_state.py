@@ -0,0 +1,75 @@
+"""多线程共享数据与伪共享分析（线程创建、配置的并发入口、同一缓存行上的字段）的回归测试"""
+
+import textwrap
+
+from src.analyzer.c_code_analyzer import CCodeAnalyzer
+
+
+def _report(tmp_path, source, options=None):
+    path = tmp_path / 'sample.c'
+    path.write_text(textwrap.dedent(source).lstrip('\n'), encoding='utf-8')
+    return CCodeAnalyzer([str(path)], [], options or {}).analyze().shared_state_report
+
+
+def test_false_sharing_between_created_threads(tmp_path):
+    """生产者和消费者各自写入同一缓存行上的不同字段；main写、消费者读的全局变量为争用数据"""
+    report = _report(tmp_path, '''
+        #include <pthread.h>
+        struct stats { long produced; long consumed; int ready; };
+        static struct stats stats;
+        static int counter;
+        static int config;
+        static void *producer(void *arg) {
+            for (int i = 0; i < 100; i++) { stats.produced++; counter++; }
+            return 0;
+        }
+        static void *consumer(void *arg) {
+            while (stats.ready) { stats.consumed++; counter += config; }
+            return 0;
+        }
+        int main(void) {
+            pthread_t a, b;
+            config = 2;
+            pthread_create(&a, 0, producer, 0);
+            pthread_create(&b, 0, consumer, 0);
+            pthread_join(a, 0);
+            pthread_join(b, 0);
+            return counter;
+        }
+    ''')
+    threads = {thread['entry']: thread for thread in report['threads']}
+    assert (threads['producer']['origin'], threads['producer']['created_at']) == ('thread_create', ['main:17'])
+    assert threads['main']['origin'] == 'creator'
+
+    shared = {info['target']: info for info in report['shared']}
+    assert shared['counter']['contended'] and shared['counter']['writers'] == ['consumer', 'producer']
+    assert shared['config']['writers'] == ['main']
+    assert shared['config']['threads']['consumer'] == {'reads': ['consumer:11'], 'writes': []}
+    assert [info['target'] for info in report['shared'] if info['contended']] == ['counter', 'config']
+
+    [false_sharing] = report['false_sharing']
+    assert (false_sharing['record'], false_sharing['cache_line']) == ('stats', 0)
+    assert false_sharing['isolate'] == ['consumed', 'produced']
+    assert {'field': 'produced', 'writer': 'producer', 'other_field': 'consumed',
+            'other_thread': 'consumer'} in false_sharing['pairs']
+
+
+def test_configured_thread_entries(tmp_path):
+    """thread_entries中的函数可能多实例并发执行：只写全局变量的单个入口也构成争用，栈上对象的字段不是共享数据"""
+    source = '''
+        struct request { int id; int status; };
+        static long requests;
+        static void finish(struct request *request) { request->status = 1; }
+        void handle_request(int id) {
+            struct request request = { id, 0 };
+            finish(&request);
+            requests++;
+        }
+    '''
+    report = _report(tmp_path, source, {'thread_entries': ['handle_request']})
+    assert report['threads'] == [{'entry': 'handle_request', 'origin': 'configured', 'instances': 'multiple',
+                                  'created_at': [], 'functions': 2}]
+    assert [(info['target'], info['contended']) for info in report['shared']] == [('requests', True)]
+    assert report['false_sharing'] == []
+
+    assert _report(tmp_path, source) == {'threads': [], 'shared': [], 'false_sharing': []}
@@ -0,0 +1,20 @@
+"""位置字符串解析的回归测试"""
+
+from src.analyzer.source_location import location_line, location_position, split_location
+
+
+def test_split_posix_location():
+    assert split_location('src/timer.c:161:17') == ('src/timer.c', 161, 17)
+
+
+def test_split_windows_drive_letter():
+    assert split_location('C:\\work\\timer.c:161:17') == ('C:\\work\\timer.c', 161, 17)
+    # 只有行号时盘符的冒号不能当作行号分隔符
+    assert split_location('C:\\work\\timer.c:161') == ('C:\\work\\timer.c', 161, None)
+
+
+def test_unparsable_locations():
+    assert split_location(None) == (None, None, None)
+    assert split_location('timer.c') == ('timer.c', None, None)
+    assert location_line('C:\\work\\timer.c') == 0
+    assert location_position('timer.c:12:x') == (0, 0)
@@ -0,0 +1,66 @@
+"""结构体布局（字段空洞、尾部填充、重排与冷热分离建议）的回归测试"""
+
+import textwrap
+
+from src.analyzer.c_code_analyzer import CCodeAnalyzer
+
+
+def _layouts(tmp_path, source):
+    path = tmp_path / 'sample.c'
+    path.write_text(textwrap.dedent(source).lstrip('\n'), encoding='utf-8')
+    analyzer = CCodeAnalyzer([str(path)], [], {}).analyze()
+    return {layout['name']: layout for layout in analyzer.struct_layout_report.values()}
+
+
+def test_padding_holes_and_reorder(tmp_path):
+    """char/double/char/int有两处空洞，按对齐从大到小重排后从24字节减为16字节"""
+    layouts = _layouts(tmp_path, '''
+        struct packet { char tag; double value; char flag; int count; };
+        struct tail { double value; char tag; };
+        struct bits { unsigned a : 3; unsigned b : 5; int c; };
+    ''')
+    packet = layouts['packet']
+    assert packet['size'] == 24
+    assert packet['holes'] == [
+        {'after': 'tag', 'before': 'value', 'offset': 1, 'size': 7},
+        {'after': 'flag', 'before': 'count', 'offset': 17, 'size': 3},
+    ]
+    assert (packet['tail_padding'], packet['padding']) == (0, 10)
+    assert packet['suggestions'] == [
+        {'kind': 'reorder', 'order': ['value', 'count', 'tag', 'flag'], 'size': 16, 'saves': 8},
+    ]
+    assert packet['min_size'] == 16
+
+    # 只有尾部填充、重排无法缩小的结构体不给出建议
+    tail = layouts['tail']
+    assert (tail['size'], tail['holes'], tail['tail_padding']) == (16, [], 7)
+    assert tail['suggestions'] == [] and tail['min_size'] == 16
+
+    # 位域按所占字节计算空洞，不给出重排建议
+    bits = layouts['bits']
+    assert bits['holes'] == [{'after': 'b', 'before': 'c', 'offset': 1, 'size': 3}]
+    assert bits['suggestions'] == []
+
+
+def test_hot_fields_from_loop_accesses(tmp_path):
+    """循环内访问的字段为热字段；跨越多条缓存行的结构体建议冷热分离"""
+    layouts = _layouts(tmp_path, '''
+        struct session { int id; char name[120]; long hits; };
+        long total_hits(struct session *sessions, int n) {
+            long total = 0;
+            for (int i = 0; i < n; i++) total += sessions[i].hits;
+            return total + sessions->id;
+        }
+    ''')
+    session = layouts['session']
+    assert (session['size'], session['cache_lines']) == (136, 3)
+    assert session['straddling_fields'] == ['name']
+    assert session['hot_fields'] == ['hits']
+    assert session['cold_fields'] == ['id']
+    assert session['unused_fields'] == ['name']
+    assert session['field_access']['hits'] == {
+        'accesses': 1, 'loop_accesses': 1, 'weight': 10, 'functions': ['total_hits'],
+    }
+    [split] = session['suggestions']
+    assert split['kind'] == 'hot_cold_split'
+    assert (split['hot_fields'], split['cold_fields'], split['hot_size']) == (['hits'], ['id', 'name'], 8)